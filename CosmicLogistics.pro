@@ -25,10 +25,29 @@ SOURCES += \
     src/ui/addplanetdialog.cpp \
     src/ui/addedgedialog.cpp \
     src/ui/piratebattle.cpp \
+    src/ui/planetsearchmodel.cpp \
+    src/ui/planetpickerdialog.cpp \
+    src/ui/maprenderer.cpp \
+    src/ui/perfmonitor.cpp \
     src/graph/StarGraph.cpp \
+    src/graph/PlanetNameIndex.cpp \
     src/graph/Dijkstra.cpp \
+    src/graph/HazardForecast.cpp \
+    src/graph/TimeProfile.cpp \
+    src/graph/TimeDependentRouter.cpp \
+    src/graph/ParetoRouter.cpp \
+    src/graph/KShortestPaths.cpp \
+    src/graph/ConstrainedRouter.cpp \
+    src/graph/TourPlanner.cpp \
+    src/graph/ForceLayout.cpp \
     src/game/Trader.cpp \
-    src/game/BlackHole.cpp
+    src/game/BlackHole.cpp \
+    src/game/SimulationClock.cpp \
+    src/game/HazardField.cpp \
+    src/game/PirateModel.cpp \
+    src/game/RouteRiskSimulator.cpp \
+    src/game/GameSimulation.cpp \
+    src/game/RandomService.cpp
 
 # Заголовочные файлы
 HEADERS += \
@@ -37,13 +56,34 @@ HEADERS += \
     include/ui/addplanetdialog.h \
     include/ui/addedgedialog.h \
     include/ui/piratebattle.h \
+    include/ui/planetsearchmodel.h \
+    include/ui/planetpickerdialog.h \
+    include/ui/maprenderer.h \
+    include/ui/perfmonitor.h \
     include/core/Sequence.h \
     include/core/DynamicArray.h \
     include/core/PriorityQueue.h \
+    include/core/UniformGrid.h \
+    include/core/Xoshiro256.h \
     include/graph/StarGraph.h \
+    include/graph/PlanetNameIndex.h \
     include/graph/Dijkstra.h \
+    include/graph/HazardForecast.h \
+    include/graph/TimeProfile.h \
+    include/graph/TimeDependentRouter.h \
+    include/graph/ParetoRouter.h \
+    include/graph/KShortestPaths.h \
+    include/graph/ConstrainedRouter.h \
+    include/graph/TourPlanner.h \
+    include/graph/ForceLayout.h \
     include/game/Trader.h \
     include/game/BlackHole.h \
+    include/game/SimulationClock.h \
+    include/game/HazardField.h \
+    include/game/PirateModel.h \
+    include/game/RouteRiskSimulator.h \
+    include/game/GameSimulation.h \
+    include/game/RandomService.h \
     include/ui/visual_effects.h
 
 # UI формы
@@ -0,0 +1,195 @@
+#ifndef UNIFORM_GRID_H
+#define UNIFORM_GRID_H
+
+#include "DynamicArray.h"
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+#include <algorithm>
+
+/**
+ * Равномерная сетка для пространственных запросов
+ * Хранит прямоугольники (точка - вырожденный прямоугольник) с ключами Key
+ * Вставка, перемещение и удаление - O(число покрытых ячеек),
+ * запрос по области - O(число ячеек области + найденные элементы)
+ */
+template <typename Key>
+class UniformGrid {
+private:
+    struct Box {
+        double minX, minY, maxX, maxY;
+    };
+
+    double cellSize;
+    std::unordered_map<long long, std::vector<Key>> cells; //ячейка -> ключи
+    std::unordered_map<Key, Box> boxes;                    //ключ -> его прямоугольник
+
+    int cellCoord(double value) const {
+        return static_cast<int>(std::floor(value / cellSize));
+    }
+
+    //сдвиг знакового отрицательного числа - неопределённое поведение, поэтому через беззнаковые
+    static long long cellKey(int cx, int cy) {
+        return static_cast<long long>((static_cast<unsigned long long>(static_cast<unsigned int>(cx)) << 32) |
+                                      static_cast<unsigned int>(cy));
+    }
+
+    void addToCells(const Key& key, const Box& box) {
+        int x0 = cellCoord(box.minX), x1 = cellCoord(box.maxX);
+        int y0 = cellCoord(box.minY), y1 = cellCoord(box.maxY);
+        for (int cx = x0; cx <= x1; cx++) {
+            for (int cy = y0; cy <= y1; cy++) {
+                cells[cellKey(cx, cy)].push_back(key);
+            }
+        }
+    }
+
+    void removeFromCells(const Key& key, const Box& box) {
+        int x0 = cellCoord(box.minX), x1 = cellCoord(box.maxX);
+        int y0 = cellCoord(box.minY), y1 = cellCoord(box.maxY);
+        for (int cx = x0; cx <= x1; cx++) {
+            for (int cy = y0; cy <= y1; cy++) {
+                auto it = cells.find(cellKey(cx, cy));
+                if (it == cells.end()) {
+                    continue;
+                }
+                std::vector<Key>& bucket = it->second;
+                auto pos = std::find(bucket.begin(), bucket.end(), key);
+                if (pos != bucket.end()) {
+                    *pos = bucket.back();
+                    bucket.pop_back();
+                }
+                if (bucket.empty()) {
+                    cells.erase(it);
+                }
+            }
+        }
+    }
+
+    //покрывают ли два прямоугольника одинаковый набор ячеек
+    bool sameCells(const Box& a, const Box& b) const {
+        return cellCoord(a.minX) == cellCoord(b.minX) && cellCoord(a.maxX) == cellCoord(b.maxX) &&
+               cellCoord(a.minY) == cellCoord(b.minY) && cellCoord(a.maxY) == cellCoord(b.maxY);
+    }
+
+    //квадрат расстояния от точки до прямоугольника
+    static double distanceSquared(const Box& box, double x, double y) {
+        double dx = std::max(std::max(box.minX - x, 0.0), x - box.maxX);
+        double dy = std::max(std::max(box.minY - y, 0.0), y - box.maxY);
+        return dx * dx + dy * dy;
+    }
+
+public:
+    explicit UniformGrid(double cell = 128.0) : cellSize(cell) {}
+
+    //добавление точки
+    void Insert(const Key& key, double x, double y) {
+        InsertBox(key, x, y, x, y);
+    }
+
+    //добавление прямоугольника (если ключ уже есть - он перемещается)
+    void InsertBox(const Key& key, double minX, double minY, double maxX, double maxY) {
+        Box box{std::min(minX, maxX), std::min(minY, maxY),
+                std::max(minX, maxX), std::max(minY, maxY)};
+
+        auto it = boxes.find(key);
+        if (it != boxes.end()) {
+            //в пределах тех же ячеек достаточно обновить координаты
+            if (sameCells(it->second, box)) {
+                it->second = box;
+                return;
+            }
+            removeFromCells(key, it->second);
+            it->second = box;
+        } else {
+            boxes[key] = box;
+        }
+        addToCells(key, box);
+    }
+
+    //перемещение точки
+    void Move(const Key& key, double x, double y) {
+        InsertBox(key, x, y, x, y);
+    }
+
+    //удаление элемента (отсутствующий ключ игнорируется)
+    void Remove(const Key& key) {
+        auto it = boxes.find(key);
+        if (it == boxes.end()) {
+            return;
+        }
+        removeFromCells(key, it->second);
+        boxes.erase(it);
+    }
+
+    bool Contains(const Key& key) const {
+        return boxes.find(key) != boxes.end();
+    }
+
+    int GetSize() const {
+        return static_cast<int>(boxes.size());
+    }
+
+    void Clear() {
+        cells.clear();
+        boxes.clear();
+    }
+
+    //вызывает visit(key) для каждого элемента, пересекающего прямоугольник
+    //каждый элемент сообщается ровно один раз: только в ячейке,
+    //где лежит левый верхний угол пересечения (без дополнительной памяти)
+    template <typename Visitor>
+    void ForEachInBox(double minX, double minY, double maxX, double maxY, Visitor visit) const {
+        int x0 = cellCoord(minX), x1 = cellCoord(maxX);
+        int y0 = cellCoord(minY), y1 = cellCoord(maxY);
+
+        for (int cx = x0; cx <= x1; cx++) {
+            for (int cy = y0; cy <= y1; cy++) {
+                auto it = cells.find(cellKey(cx, cy));
+                if (it == cells.end()) {
+                    continue;
+                }
+                for (const Key& key : it->second) {
+                    const Box& box = boxes.at(key);
+                    if (box.maxX < minX || box.minX > maxX || box.maxY < minY || box.minY > maxY) {
+                        continue;
+                    }
+                    if (cellCoord(std::max(box.minX, minX)) != cx ||
+                        cellCoord(std::max(box.minY, minY)) != cy) {
+                        continue;
+                    }
+                    visit(key);
+                }
+            }
+        }
+    }
+
+    //элементы на расстоянии не больше radius от точки
+    DynamicArray<Key> QueryRadius(double x, double y, double radius) const {
+        DynamicArray<Key> result;
+        double radiusSquared = radius * radius;
+        ForEachInBox(x - radius, y - radius, x + radius, y + radius, [&](const Key& key) {
+            if (distanceSquared(boxes.at(key), x, y) <= radiusSquared) {
+                result.Append(key);
+            }
+        });
+        return result;
+    }
+
+    //ближайший к точке элемент в пределах maxRadius
+    bool FindNearest(double x, double y, double maxRadius, Key& nearest) const {
+        bool found = false;
+        double bestSquared = maxRadius * maxRadius;
+        ForEachInBox(x - maxRadius, y - maxRadius, x + maxRadius, y + maxRadius, [&](const Key& key) {
+            double d = distanceSquared(boxes.at(key), x, y);
+            if (d <= bestSquared) {
+                bestSquared = d;
+                nearest = key;
+                found = true;
+            }
+        });
+        return found;
+    }
+};
+
+#endif //uNIFORM_GRID_H
@@ -0,0 +1,131 @@
+#ifndef XOSHIRO256_H
+#define XOSHIRO256_H
+
+#include <cstdint>
+#include <limits>
+
+/**
+ * Генератор xoshiro256** (Блэкман, Винья): 256 бит состояния, период 2^256 - 1
+ * Быстрее mt19937 и не зависит от реализации стандартной библиотеки:
+ * одна и та же последовательность на любом компиляторе (в отличие от std::*_distribution)
+ * Jump() сдвигает поток на 2^128 шагов - так из одного seed получаются
+ * непересекающиеся потоки для параллельных симуляций без блокировок
+ * Подходит как UniformRandomBitGenerator для std::shuffle и т.п.
+ */
+class Xoshiro256 {
+public:
+    using result_type = uint64_t;
+    
+    explicit Xoshiro256(uint64_t seed = 0) { Seed(seed); }
+    
+    //состояние из seed через SplitMix64 (нулевое состояние исключено)
+    void Seed(uint64_t seed) {
+        for (int i = 0; i < 4; i++) {
+            state[i] = SplitMix64(seed);
+        }
+    }
+    
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+    
+    result_type operator()() {
+        uint64_t result = rotl(state[1] * 5, 7) * 9;
+        uint64_t t = state[1] << 17;
+        
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = rotl(state[3], 45);
+        
+        return result;
+    }
+    
+    //равномерное в [0, 1): 53 старших бита
+    double NextDouble() {
+        return ((*this)() >> 11) * 0x1.0p-53;
+    }
+    
+    //равномерное в [0, bound) без смещения: отбрасываются значения из неполного последнего блока
+    uint64_t NextBelow(uint64_t bound) {
+        if (bound == 0) {
+            return 0;
+        }
+        uint64_t threshold = (0 - bound) % bound;   //2^64 mod bound
+        while (true) {
+            uint64_t value = (*this)();
+            if (value >= threshold) {
+                return value % bound;
+            }
+        }
+    }
+    
+    //равномерное целое в [low, high]
+    int NextInt(int low, int high) {
+        return low + static_cast<int>(NextBelow(static_cast<uint64_t>(static_cast<int64_t>(high) - low) + 1));
+    }
+    
+    //равномерное в [low, high)
+    double NextRange(double low, double high) {
+        return low + NextDouble() * (high - low);
+    }
+    
+    //сдвиг на 2^128 шагов: 2^128 непересекающихся потоков
+    void Jump() {
+        static const uint64_t JUMP[4] = {
+            0x180EC6D33CFD0ABAULL, 0xD5A61266F0C9392CULL, 0xA9582618E03FC9AAULL, 0x39ABDC4529B1661CULL
+        };
+        applyJump(JUMP);
+    }
+    
+    //сдвиг на 2^192 шагов: группы по 2^64 потоков для Jump()
+    void LongJump() {
+        static const uint64_t LONG_JUMP[4] = {
+            0x76E15D3EFEFDCBBFULL, 0xC5004E441C522FB3ULL, 0x77710069854EE241ULL, 0x39109BB02ACBE635ULL
+        };
+        applyJump(LONG_JUMP);
+    }
+    
+    //SplitMix64: следующий 64-битный ключ из счётчика seed (для посева и смешивания ключей)
+    static uint64_t SplitMix64(uint64_t& seed) {
+        uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+    
+    bool operator==(const Xoshiro256& other) const {
+        return state[0] == other.state[0] && state[1] == other.state[1]
+            && state[2] == other.state[2] && state[3] == other.state[3];
+    }
+    bool operator!=(const Xoshiro256& other) const { return !(*this == other); }
+
+private:
+    uint64_t state[4];
+    
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+    
+    void applyJump(const uint64_t (&polynomial)[4]) {
+        uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        for (int i = 0; i < 4; i++) {
+            for (int bit = 0; bit < 64; bit++) {
+                if (polynomial[i] & (1ULL << bit)) {
+                    s0 ^= state[0];
+                    s1 ^= state[1];
+                    s2 ^= state[2];
+                    s3 ^= state[3];
+                }
+                (*this)();
+            }
+        }
+        state[0] = s0;
+        state[1] = s1;
+        state[2] = s2;
+        state[3] = s3;
+    }
+};
+
+#endif //xOSHIRO256_H
@@ -0,0 +1,200 @@
+#ifndef GAMESIMULATION_H
+#define GAMESIMULATION_H
+
+#include "StarGraph.h"
+#include "Dijkstra.h"
+#include "Trader.h"
+#include "HazardField.h"
+#include "DynamicArray.h"
+#include "UniformGrid.h"
+#include "RandomService.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//событие игры: окно превращает его в сообщения и диалоги, пакетный прогон - в статистику
+//имена и итоги торговца снимаются в момент события (карта к показу может быть уже очищена)
+struct GameEvent {
+    enum Type {
+        TraderLanded,          //торговец высадился на planet
+        GameStarted,
+        ArtifactSpawned,       //planet
+        ArtifactCollected,     //planet, value - собрано артефактов
+        Victory,               //value - время игры
+        PirateAttack,          //переход planet -> otherPlanet, value - риск
+        PiratesRepelled,       //переход planet -> otherPlanet
+        DestroyedByPirates,    //переход planet -> otherPlanet, карта очищена
+        Arrived,               //planet - конец маршрута
+        RouteInterrupted,      //торговец остановился на planet, переход к otherPlanet исчез
+        BlackHoleSpawned,
+        BlackHoleLeft,
+        PlanetSwallowed,       //planet
+        LaneSwallowed,         //переход planet -> otherPlanet
+        DestroyedByBlackHole   //planet вместе с торговцем, карта очищена
+    };
+    
+    Type type;
+    int planet;
+    int otherPlanet;
+    std::string planetName;
+    std::string otherPlanetName;
+    double value;
+    
+    //итоги торговца и игры на момент события
+    int completedRoutes;
+    int totalDistance;
+    double gameTime;
+};
+
+//игровые правила без интерфейса: карта, торговец, черные дыры, артефакты, пираты, победа и гибель
+//окно только показывает состояние и события; в пакетном режиме (step + travelRoute)
+//тысячи партий в секунду идут без Qt - для баланса и регрессионных прогонов
+//случайность - только из именованных потоков RandomService с заданным seed, поэтому партия воспроизводима;
+//у каждой механики свой поток: лишний бросок в одной (например, меткость в битве) не меняет остальные
+class GameSimulation {
+public:
+    enum class State {
+        Waiting,    //мало планет для старта
+        Running,
+        Won,
+        Lost        //торговец погиб, карта очищена - новая партия начнётся, когда планет хватит
+    };
+    
+    struct Settings {
+        int requiredArtifacts;         //цель игры
+        int minPlanetsToStart;         //минимум планет для старта
+        double blackHoleSpawnPeriod;   //секунды между черными дырами (step)
+        double blackHoleRadius;
+        double planetRadius;           //запас при проверке поглощения планет
+        int maxBlackHoles;
+        double clicksPerSecond;        //меткость игрока, если битвы разрешает симуляция
+        uint64_t seed;
+        std::string traderName;
+        
+        Settings();
+    };
+    
+    //исход битвы с пиратами на переходе from -> to: true - игрок победил
+    using BattleResolver = std::function<bool(int from, int to, double risk)>;
+    using EventHandler = std::function<void(const GameEvent&)>;
+    
+    explicit GameSimulation(const Settings& simulationSettings = Settings());
+    
+    //═══ состояние ═══
+    StarGraph& getGraph() { return graph; }
+    const StarGraph& getGraph() const { return graph; }
+    Trader& getTrader() { return trader; }
+    const Trader& getTrader() const { return trader; }
+    HazardField& getHazards() { return hazards; }
+    const HazardField& getHazards() const { return hazards; }
+    const Settings& getSettings() const { return settings; }
+    RandomService& getRandom() { return random; }   //потоки и для оформления окна
+    
+    State getState() const { return state; }
+    int getCollectedArtifacts() const { return collectedArtifacts; }
+    double getGameTime() const { return gameTime; }
+    
+    //═══ события ═══
+    //с обработчиком события отдаются сразу, без него копятся до takeEvents
+    void setEventHandler(EventHandler handler) { eventHandler = std::move(handler); }
+    std::vector<GameEvent> takeEvents();
+    
+    //═══ правила ═══
+    void reset();                    //новая карта: всё очищается, игра ждёт планет
+    bool placeTraderIfNeeded();      //торговец высаживается на первую планету, если ещё не на карте
+    bool checkGameStart();           //старт при достаточном числе планет
+    bool spawnArtifact();            //артефакт на случайной планете (один на карте, не под торговцем)
+    void advanceTime(double seconds);   //игровые часы идут только во время партии
+    
+    //полёт по маршруту: на каждом переходе пираты нападают с вероятностью риска ребра from -> to,
+    //из параллельных рёбер выбирается лучшее в метрике маршрута (Dijkstra::BestLane - как в описании пути);
+    //исход битвы решает resolver (по умолчанию - PirateModel с settings.clicksPerSecond);
+    //по прибытии собираются артефакты на всех планетах пути; false - корабль уничтожен;
+    //если планета или переход впереди исчезли (черная дыра), торговец останавливается на последней достигнутой
+    bool travelRoute(const DynamicArray<int>& path, double cost, RouteMetric metric = RouteMetric::Cost,
+                     const BattleResolver& resolver = BattleResolver());
+    //то же по заданным переходам: lanes[i] - индекс ребра в GetEdges(path[i]) (например, ParetoRoute::lanes)
+    bool travelRoute(const DynamicArray<int>& path, const DynamicArray<int>& lanes, double cost,
+                     const BattleResolver& resolver = BattleResolver());
+    
+    //черная дыра поглотила планету; true - вместе с торговцем (игра проиграна, карта очищена)
+    bool swallowPlanet(int planet);
+    //черная дыра разорвала переход (все параллельные рёбра from -> to); false - перехода уже нет
+    bool swallowLane(int from, int to);
+    //новая черная дыра (радиус из настроек); -1 - поле заполнено или карта пуста
+    int spawnBlackHole(double x, double y, double velocityX, double velocityY);
+    
+    //═══ безоконный режим ═══
+    //координаты планет для проверок черных дыр (планеты без координат дыры не задевают)
+    //перемещение планеты обновляет только её точку и инцидентные ей отрезки в индексе
+    void setPlanetPosition(int planet, double x, double y);
+    bool hasPlanetPosition(int planet) const { return positions.find(planet) != positions.end(); }
+    void scatterPlanets(double width, double height);   //случайные координаты планетам без них
+    //шаг мира: часы игры, появление черных дыр по таймеру у края карты, движение, поглощения, уход
+    void step(double deltaTime);
+
+private:
+    struct Position {
+        double x, y;
+    };
+    
+    Settings settings;
+    StarGraph graph;
+    Trader trader;
+    HazardField hazards;
+    
+    RandomService random;
+    Xoshiro256& artifactRandom;      //где появится артефакт
+    Xoshiro256& pirateRandom;        //нападения и исход битв
+    Xoshiro256& hazardRandom;        //появление черных дыр (step)
+    Xoshiro256& placementRandom;     //координаты scatterPlanets
+    
+    State state;
+    int collectedArtifacts;
+    double gameTime;
+    double spawnTimer;
+    
+    EventHandler eventHandler;
+    std::vector<GameEvent> pendingEvents;
+    
+    std::unordered_map<int, Position> positions;
+    
+    //пространственный индекс для проверок черных дыр: в векторные проверки HazardField
+    //попадают только кандидаты из ячеек, которые дыра задела за шаг;
+    //внешние изменения вершин и рёбер перестраивают его целиком, перемещения и поглощения - по элементу
+    UniformGrid<int> planetGrid;
+    UniformGrid<long long> laneGrid;                          //отрезки переходов (параллельные рёбра - один)
+    std::unordered_map<int, std::vector<long long>> planetLanes;   //планета -> инцидентные отрезки
+    unsigned long long indexedTopology;      //StarGraph::GetTopologyVersion, с которой согласован индекс
+    bool indexValid;                         //false - у планеты появились первые координаты
+    
+    //рабочие массивы кандидатов (переиспользуются между шагами)
+    std::vector<int> candidatePlanets;
+    std::vector<long long> candidateLanes;
+    std::vector<double> candidateX, candidateY, candidateEndX, candidateEndY;
+    std::vector<int> hits, expired;
+    
+    bool boundsValid;                        //false - планета с края карты сдвинулась внутрь или исчезла
+    double minX, minY, maxX, maxY;           //габариты планет с координатами - край карты для черных дыр
+    
+    void post(GameEvent::Type type, int planet = -1, int otherPlanet = -1, double value = 0.0);
+    void collectArtifact(int planet);
+    void defeat();                   //гибель торговца: карта, дыры и торговец сбрасываются
+    
+    void spawnAtEdge();
+    static long long laneKey(int from, int to);
+    bool isIndexSynced() const { return indexValid && indexedTopology == graph.GetTopologyVersion(); }
+    void syncIndex();                //полная перестройка после внешних изменений карты
+    void indexLane(int from, int to);
+    void unindexLane(int from, int to);
+    void unindexPlanet(int planet);
+    bool onBounds(const Position& position) const;
+    bool syncBounds();               //false - ни у одной планеты нет координат
+    bool collidePlanets();           //true - торговец погиб
+    void collideLanes();
+    void releaseExited();
+};
+
+#endif //gAMESIMULATION_H
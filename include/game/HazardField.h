@@ -0,0 +1,69 @@
+#ifndef HAZARDFIELD_H
+#define HAZARDFIELD_H
+
+#include <vector>
+
+//поле опасностей: сотни черных дыр в виде структуры массивов (SoA)
+//координаты, скорости, радиусы и возраст лежат в плотных массивах по слотам,
+//обновление и проверки столкновений - циклы без ветвлений, которые векторизует компилятор;
+//слоты переиспользуются через список свободных - без new/delete на каждую дыру
+class HazardField {
+public:
+    static constexpr double DEFAULT_LIFETIME = 300.0;   //время жизни (как у BlackHole)
+    
+    explicit HazardField(int initialCapacity = 64);
+    
+    //═══ пул ═══
+    //занять свободный слот (пул растёт, только если свободных нет)
+    int spawn(double x, double y, double velocityX, double velocityY,
+              double radius, double lifetime = DEFAULT_LIFETIME);
+    void release(int slot);
+    void clear();
+    
+    //═══ симуляция ═══
+    //сдвигает все дыры и копит возраст; истёкшие освобождаются и попадают в expired
+    void update(double deltaTime, std::vector<int>* expired = nullptr);
+    
+    //═══ столкновения (квадраты расстояний, без sqrt) ═══
+    //индексы точек в радиусе дыры slot (+ margin) на её пути за последний update дописываются в hits
+    void collidePoints(int slot, const double* xs, const double* ys, int count,
+                       double margin, std::vector<int>& hits) const;
+    //индексы отрезков (ax, ay)-(bx, by), задетых диском, заметённым дырой за последний update
+    void collideSegments(int slot, const double* ax, const double* ay,
+                         const double* bx, const double* by, int count,
+                         std::vector<int>& hits) const;
+    
+    //═══ геттеры ═══
+    int getActiveCount() const { return static_cast<int>(active.size()); }
+    int getCapacity() const { return static_cast<int>(x.size()); }
+    const std::vector<int>& getActiveSlots() const { return active; }   //порядок произвольный
+    bool isActive(int slot) const;
+    
+    double getX(int slot) const { return x[slot]; }
+    double getY(int slot) const { return y[slot]; }
+    double getPreviousX(int slot) const { return previousX[slot]; }     //позиция до последнего update
+    double getPreviousY(int slot) const { return previousY[slot]; }
+    double getVelocityX(int slot) const { return velocityX[slot]; }
+    double getVelocityY(int slot) const { return velocityY[slot]; }
+    double getRadius(int slot) const { return radius[slot]; }
+    double getAge(int slot) const { return age[slot]; }
+    double getLifetime(int slot) const { return lifetime[slot]; }
+
+private:
+    std::vector<double> x, y;
+    std::vector<double> previousX, previousY;
+    std::vector<double> velocityX, velocityY;
+    std::vector<double> radius;
+    std::vector<double> age;
+    std::vector<double> lifetime;
+    std::vector<double> alive;          //1 - слот занят, 0 - свободен (маска для update)
+    
+    std::vector<int> freeSlots;
+    std::vector<int> active;            //плотный список занятых слотов
+    std::vector<int> activeIndex;       //слот -> позиция в active, -1 если свободен
+    
+    void grow(int capacity);
+    void checkSlot(int slot) const;
+};
+
+#endif //hAZARDFIELD_H
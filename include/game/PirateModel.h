@@ -0,0 +1,29 @@
+#ifndef PIRATEMODEL_H
+#define PIRATEMODEL_H
+
+//типы пиратов
+enum class PirateType {
+    ROOKIE,    //новички (risk < 0.25)
+    VETERAN,   //ветераны (0.25 <= risk <= 0.4)
+    BOSS       //босс-пираты (risk > 0.4)
+};
+
+//правила сражения с пиратами без интерфейса: общие для диалога PirateBattle
+//и для безоконной симуляции рейсов
+class PirateModel {
+public:
+    //параметры битвы для типа пиратов
+    struct Profile {
+        int requiredClicks;    //попаданий для победы
+        int battleTime;        //время битвы в десятых долях секунды
+    };
+    
+    static PirateType determinePirateType(double risk);
+    static Profile profile(PirateType type);
+    
+    //вероятность победы игрока, стреляющего в среднем clicksPerSecond раз в секунду:
+    //число попаданий за битву - пуассоновское, победа - если их не меньше requiredClicks
+    static double victoryProbability(PirateType type, double clicksPerSecond);
+};
+
+#endif //pIRATEMODEL_H
@@ -0,0 +1,41 @@
+#ifndef RANDOMSERVICE_H
+#define RANDOMSERVICE_H
+
+#include "Xoshiro256.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//единый источник случайности: именованные потоки xoshiro256** от одного главного seed
+//поток посеян ключом (seed, имя) и не зависит от порядка и числа других потоков:
+//новый поток не сдвигает последовательности существующих, а прогон с тем же seed
+//повторяется бит в бит на любой платформе
+//для параллельных симуляций - непересекающиеся подпотоки (Jump), у каждого рабочего свой, без блокировок
+class RandomService {
+public:
+    explicit RandomService(uint64_t seed = 42);
+    
+    //ссылки на потоки раздаются наружу - копировать сервис нельзя
+    RandomService(const RandomService&) = delete;
+    RandomService& operator=(const RandomService&) = delete;
+    
+    uint64_t getSeed() const { return seed; }
+    //все потоки начинаются заново от нового seed (выданные ссылки остаются действительными)
+    void reseed(uint64_t newSeed);
+    
+    //поток по имени (создаётся при первом обращении); ссылку можно хранить
+    Xoshiro256& stream(const std::string& name);
+    
+    //count непересекающихся подпотоков имени: i-й сдвинут на i * 2^128 шагов
+    std::vector<Xoshiro256> parallelStreams(const std::string& name, int count) const;
+    
+    //seed потока по ключу (главный seed, имя); хеш имени FNV-1a - одинаков на всех платформах
+    static uint64_t streamSeed(uint64_t seed, const std::string& name);
+
+private:
+    uint64_t seed;
+    std::unordered_map<std::string, Xoshiro256> streams;
+};
+
+#endif //rANDOMSERVICE_H
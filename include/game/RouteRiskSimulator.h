@@ -0,0 +1,74 @@
+#ifndef ROUTERISKSIMULATOR_H
+#define ROUTERISKSIMULATOR_H
+
+#include "PirateModel.h"
+#include "StarGraph.h"
+#include "Dijkstra.h"
+#include "DynamicArray.h"
+#include <cstdint>
+#include <vector>
+
+//итоги моделирования рейсов по маршруту
+struct RouteRiskReport {
+    long long voyages;                        //смоделировано рейсов
+    long long survived;                       //долетели до конца маршрута
+    double survivalProbability;
+    double survivalStdError;                  //стандартная ошибка оценки выживания
+    double meanEncounters;                    //встреч с пиратами за рейс
+    
+    //потери за рейс: cargoValue при гибели + battleCost за каждую битву
+    double expectedLoss;
+    double lossStdDev;
+    double lossMedian;
+    double lossP90;
+    double lossP99;
+    
+    std::vector<long long> encounterHistogram;   //[k] - рейсов с k встречами
+    std::vector<double> destroyedAtLane;         //вероятность гибели на i-м переходе маршрута
+    
+    RouteRiskReport();
+};
+
+//безоконная симуляция Монте-Карло рейсов: на каждом переходе встреча с пиратами
+//с вероятностью риска, исход битвы - по PirateModel для заданной меткости игрока
+//случайные числа - счётчиковые: значение зависит только от (seed, номер рейса, номер броска),
+//поэтому рейсы делятся между потоками без блокировок, а результат не зависит от числа потоков;
+//потоки копят итоги локально (гистограмма по числу встреч и месту гибели) и сливаются в конце
+class RouteRiskSimulator {
+public:
+    struct Settings {
+        long long voyages;         //рейсов на маршрут
+        int threadCount;           //0 - по числу ядер
+        uint64_t seed;
+        double clicksPerSecond;    //меткость игрока в битве
+        double cargoValue;         //потеря при гибели корабля
+        double battleCost;         //потеря за каждую битву (ремонт)
+        
+        Settings();
+    };
+    
+    explicit RouteRiskSimulator(const Settings& settings = Settings());
+    
+    //риски переходов маршрута по порядку
+    RouteRiskReport simulate(const std::vector<double>& laneRisks) const;
+    //маршрут по графу: риск перехода - с ребра, которым летит торговец (Dijkstra::BestLane в метрике маршрута)
+    RouteRiskReport simulate(const StarGraph& graph, const DynamicArray<int>& path,
+                             RouteMetric metric = RouteMetric::Cost) const;
+    
+    //точная вероятность долететь (для сверки и быстрых оценок)
+    double exactSurvival(const std::vector<double>& laneRisks) const;
+    
+    //риски переходов маршрута по тому же правилу выбора параллельных рёбер
+    static std::vector<double> laneRisks(const StarGraph& graph, const DynamicArray<int>& path,
+                                         RouteMetric metric = RouteMetric::Cost);
+    
+    //счётчиковый генератор: равномерное число в [0, 1) по ключу потока и номеру броска
+    static double uniformAt(uint64_t stream, uint64_t counter);
+    
+    const Settings& getSettings() const { return settings; }
+
+private:
+    Settings settings;
+};
+
+#endif //rOUTERISKSIMULATOR_H
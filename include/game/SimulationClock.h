@@ -0,0 +1,69 @@
+#ifndef SIMULATIONCLOCK_H
+#define SIMULATIONCLOCK_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+//единые часы симуляции с фиксированным шагом
+//системы (метеориты, черная дыра, анимация пути, игровой таймер) регистрируются
+//со своим периодом и продвигаются за один проход; часы не зависят от Qt,
+//поэтому симуляцию можно прогнать без окна быстрее реального времени (runFor)
+class SimulationClock {
+public:
+    using System = std::function<void(double deltaTime)>;
+    
+    explicit SimulationClock(double timestep = 1.0 / 60.0, int maxStepsPerAdvance = 10);
+    
+    //═══ системы ═══
+    //period <= 0 - система выполняется на каждом шаге; возвращает id системы
+    int addSystem(const std::string& name, double period, System system, bool enabled = true);
+    void removeSystem(int id);                 //можно вызывать и из самой системы
+    void setEnabled(int id, bool enabled);     //выключенная система не копит время
+    bool isEnabled(int id) const;
+    void restartSystem(int id);                //включить и начать период заново (как QTimer::start)
+    const std::string& getSystemName(int id) const;
+    
+    //═══ ход времени ═══
+    //реальное время -> целое число шагов, остаток копится до следующего вызова;
+    //после долгой паузы выполняется не больше maxStepsPerAdvance шагов
+    int advance(double realSeconds);
+    void runFor(double simulatedSeconds);      //без окна: все шаги сразу
+    void step();                               //ровно один шаг
+    
+    //═══ геттеры ═══
+    double getTimestep() const { return timestep; }
+    double getTime() const { return time; }
+    long long getStepCount() const { return stepCount; }
+    double getTimeScale() const { return timeScale; }
+    double getInterpolation() const { return accumulator / timestep; }  //доля следующего шага
+    
+    void setTimeScale(double scale);           //больше 1 - быстрее реального времени
+
+private:
+    struct Entry {
+        int id;
+        std::string name;
+        double period;
+        double elapsed;                        //время с последнего срабатывания
+        bool enabled;
+        bool removed;                          //удаляется после текущего шага
+        System system;
+    };
+    
+    //указатели не меняются при добавлении систем во время шага
+    std::vector<std::unique_ptr<Entry>> systems;
+    int nextId;
+    double timestep;
+    int maxStepsPerAdvance;
+    double accumulator;                        //накопленное, но не просчитанное время
+    double timeScale;
+    double time;
+    long long stepCount;
+    
+    Entry& find(int id);
+    const Entry& find(int id) const;
+};
+
+#endif //sIMULATIONCLOCK_H
@@ -15,6 +15,9 @@ private:
     int totalDistance;             //пройденное расстояние
 
 public:
+    //крейсерская скорость (единиц расстояния в секунду) - для прогноза черных дыр на маршруте
+    static constexpr double CRUISE_SPEED = 20.0;
+    
     Trader();
     Trader(const std::string& traderName);
     
@@ -0,0 +1,79 @@
+#ifndef CONSTRAINEDROUTER_H
+#define CONSTRAINEDROUTER_H
+
+#include "StarGraph.h"
+#include "Dijkstra.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * результат поиска с ограничением ресурса
+ */
+struct ConstrainedResult {
+    DijkstraResult route;
+    double budget;                        //заданный лимит
+    double consumed;                      //израсходовано маршрутом (вероятность встречи или число переходов)
+    
+    ConstrainedResult();
+};
+
+/**
+ * кратчайший путь с ограничением накопленного ресурса:
+ * - Risk: вероятность хотя бы одной встречи с пиратами не больше budget
+ *   (внутри - сумма -log(1 - risk), она складывается вдоль пути)
+ * - Jumps: не больше budget переходов
+ * метки (стоимость, ресурс) корректируются по схеме A*: оценкой служат точные
+ * расстояния до цели из обратных поисков, поэтому первая метка, извлечённая в цели, оптимальна
+ * метки отсекаются, если даже лучший остаток пути выходит за лимит ресурса,
+ * и если они доминируются мешком своей вершины (как в ParetoRouter)
+ */
+class ConstrainedRouter {
+public:
+    enum Resource {
+        Risk,
+        Jumps
+    };
+    
+    explicit ConstrainedRouter(const StarGraph& g);
+    
+    //минимум метрики при ограничении ресурса; budget для Risk - в [0, 1), для Jumps - >= 0
+    ConstrainedResult FindPath(int start, int end, Resource resource, double budget,
+                               RouteMetric metric = RouteMetric::Cost) const;
+    ConstrainedResult FindPath(const std::string& startName, const std::string& endName,
+                               Resource resource, double budget,
+                               RouteMetric metric = RouteMetric::Cost) const;
+    
+    //самый дешёвый маршрут с вероятностью встречи с пиратами не больше maxEncounterProbability
+    ConstrainedResult FindCheapestWithinRisk(int start, int end, double maxEncounterProbability) const;
+    //самый дешёвый маршрут не более чем из maxJumps переходов
+    ConstrainedResult FindShortestWithinJumps(int start, int end, int maxJumps) const;
+    
+    //число меток, созданных последним запросом (для профилирования)
+    int GetLastLabelCount() const { return lastLabelCount; }
+
+private:
+    struct Label {
+        double cost;
+        double resource;
+        int vertex;
+        int parent;                       //индекс метки-родителя в пуле, -1 у стартовой
+        int edge;                         //индекс ребра в списке родителя (важно при параллельных рёбрах)
+        bool alive;                       //false - вытеснена доминирующей меткой
+    };
+    
+    const StarGraph& graph;
+    mutable int lastLabelCount;
+    
+    //расход ресурса на ребре
+    static double edgeResource(const EdgeData& data, Resource resource);
+    //нижние оценки ресурса до цели: обратный поиск по входящим рёбрам
+    std::unordered_map<int, double> resourceToTarget(int end, Resource resource) const;
+    //добавить метку в мешок вершины; false - метка доминируется
+    static bool insertLabel(std::vector<Label>& pool, std::vector<int>& bag, int label);
+    //готовый результат по цепочке меток
+    void describeLabels(ConstrainedResult& result, const std::vector<Label>& pool, int label,
+                        Resource resource) const;
+};
+
+#endif //cONSTRAINEDROUTER_H
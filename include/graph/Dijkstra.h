@@ -4,18 +4,33 @@
 #include "StarGraph.h"
 #include "PriorityQueue.h"
 #include "DynamicArray.h"
+#include "HazardForecast.h"
 #include <unordered_map>
 #include <limits>
 #include <string>
 
+/**
+ * метрика, которую минимизирует поиск
+ * Cost - distance * (1 + risk), Survival - сумма -log(1 - risk),
+ * то есть максимум вероятности пройти путь без встречи с пиратами
+ */
+enum class RouteMetric {
+    Cost,
+    Survival
+};
+
 /**
  * Результат работы алгоритма Дейкстры
  */
 struct DijkstraResult {
     bool pathExists;                    //существует ли путь
     double totalCost;                   //общая стоимость пути
+    double totalDistance;               //суммарное расстояние
+    double survivalProbability;         //вероятность пройти путь без встречи с пиратами
     DynamicArray<int> path;            //последовательность вершин в пути
+    DynamicArray<int> lanes;           //индекс ребра в GetEdges(path[i]) для каждого перехода
     DynamicArray<std::string> pathNames; //названия планет в пути
+    double arrivalTime;                 //время в пути (сек, только для поиска с прогнозом опасностей)
     
     DijkstraResult();
 };
@@ -30,6 +45,14 @@ private:
     //восстановление пути из карты предшественников
     DynamicArray<int> reconstructPath(const std::unordered_map<int, int>& previous, 
                                      int start, int end) const;
+    
+    //имена, стоимость, расстояние и вероятность выживания по найденному пути
+    //(переходы - лучшие в метрике из параллельных рёбер)
+    void describePath(DijkstraResult& result, RouteMetric metric) const;
+    //то же по уже выбранным переходам result.lanes
+    void describeLanes(DijkstraResult& result) const;
+    
+    DijkstraResult search(int start, int end, RouteMetric metric) const;
 
 public:
     explicit Dijkstra(const StarGraph& g);
@@ -40,8 +63,35 @@ public:
     //поиск кратчайшего пути по именам планет
     DijkstraResult FindShortestPath(const std::string& startName, const std::string& endName) const;
     
+    //поиск пути с учётом прогноза черных дыр: время прибытия в каждую вершину
+    //считается по скорости торговца, рёбра и планеты, поглощаемые до прохода,
+    //исключаются или штрафуются (policy.mode)
+    DijkstraResult FindShortestPath(int start, int end, const HazardForecast& forecast,
+                                    const HazardPolicy& policy, RouteMetric metric = RouteMetric::Cost) const;
+    
+    //путь с максимальной вероятностью не встретить пиратов (каждое ребро - бой с вероятностью risk)
+    DijkstraResult FindSafestPath(int start, int end) const;
+    
+    //то же, но суммарное расстояние не больше distanceBudget
+    DijkstraResult FindSafestPath(int start, int end, double distanceBudget) const;
+    
     //поиск всех кратчайших путей от заданной вершины
     std::unordered_map<int, double> FindAllShortestPaths(int start) const;
+    
+    //расстояния от всех вершин до target (обратный поиск по входящим рёбрам)
+    //служат точной оценкой остатка пути для A* и отсечения по границам
+    std::unordered_map<int, double> FindAllShortestPathsTo(int target,
+                                                          RouteMetric metric = RouteMetric::Cost) const;
+    
+    //результат по готовому пути (имена, стоимость, расстояние, выживание)
+    DijkstraResult DescribePath(const DynamicArray<int>& path, RouteMetric metric = RouteMetric::Cost) const;
+    
+    //вес ребра в метрике (оба веса хранятся в EdgeData готовыми)
+    static double EdgeWeight(const EdgeData& data, RouteMetric metric);
+    
+    //переход, которым летит маршрут: лучшее в метрике из параллельных рёбер к to, -1 - перехода нет
+    //одно правило для описания пути, полёта торговца и оценки риска
+    static int BestLane(const DynamicArray<Edge>& edges, int to, RouteMetric metric);
 };
 
 #endif //dIJKSTRA_H
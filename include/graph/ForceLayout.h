@@ -0,0 +1,109 @@
+#ifndef FORCE_LAYOUT_H
+#define FORCE_LAYOUT_H
+
+#include "StarGraph.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * точка на карте (мировые координаты)
+ */
+struct LayoutPoint {
+    double x;
+    double y;
+    
+    LayoutPoint() : x(0.0), y(0.0) {}
+    LayoutPoint(double px, double py) : x(px), y(py) {}
+};
+
+/**
+ * силовая раскладка графа (Фрюхтерман-Рейнгольд)
+ * отталкивание считается приближенно через квадродерево Barnes-Hut - O(n log n),
+ * силы для разных вершин считаются параллельно: потоки создаются один раз
+ * (при первой параллельной итерации) и ждут каждую следующую итерацию
+ *
+ * при создании копирует вершины и рёбра графа, поэтому Run можно
+ * выполнять в фоновом потоке, пока граф меняется в основном
+ */
+class ForceLayout {
+public:
+    struct Settings {
+        int iterations;        //число итераций
+        double idealLength;    //желаемая длина ребра
+        double theta;          //точность Barnes-Hut (0 - точно, больше - быстрее)
+        double gravity;        //притяжение к центру (не даёт компонентам разлетаться)
+        int threadCount;       //0 - по числу ядер
+        
+        Settings();
+    };
+    
+    //initial - известные позиции, остальные вершины раскладываются по спирали вокруг них
+    ForceLayout(const StarGraph& graph, const std::unordered_map<int, LayoutPoint>& initial,
+                const Settings& settings = Settings());
+    ~ForceLayout();
+    
+    ForceLayout(const ForceLayout&) = delete;
+    ForceLayout& operator=(const ForceLayout&) = delete;
+    
+    //одна итерация, false - раскладка уже завершена
+    bool Step();
+    
+    //все итерации; onProgress вызывается каждые progressEvery итераций (в потоке Run)
+    //возвращает false, если раскладку прервали через cancelled
+    bool Run(const std::atomic<bool>& cancelled,
+             const std::function<void(const ForceLayout&)>& onProgress = nullptr,
+             int progressEvery = 5);
+    
+    int GetIteration() const { return iteration; }
+    bool IsFinished() const { return iteration >= settings.iterations; }
+    
+    int GetSize() const { return static_cast<int>(ids.size()); }
+    int GetVertexId(int index) const { return ids[index]; }
+    const LayoutPoint& GetPosition(int index) const { return positions[index]; }
+    std::unordered_map<int, LayoutPoint> GetPositions() const;
+
+private:
+    //узел квадродерева: лист хранит одну вершину,
+    //внутренний узел - суммарную массу и центр масс поддерева
+    struct QuadNode {
+        double centerX, centerY, halfSize;
+        double massX, massY;   //сумма координат вершин (центр масс = mass* / count)
+        int count;
+        int body;              //индекс вершины в листе, -1 если нет
+        int children[4];       //-1 если нет
+    };
+    
+    Settings settings;
+    std::vector<int> ids;                        //индекс -> id вершины
+    std::vector<LayoutPoint> positions;
+    std::vector<std::pair<int, int>> edges;      //рёбра по индексам вершин
+    std::vector<LayoutPoint> displacement;
+    std::vector<QuadNode> tree;
+    double temperature;                          //максимальный сдвиг за итерацию
+    int iteration;
+    
+    //постоянные потоки отталкивания: поток part считает вершины [part * poolChunk, (part + 1) * poolChunk)
+    std::vector<std::thread> workers;
+    std::mutex poolMutex;
+    std::condition_variable poolWake;            //новая итерация или остановка
+    std::condition_variable poolDone;            //все части итерации посчитаны
+    unsigned long long poolGeneration;           //номер итерации для потоков
+    int poolPending;                             //потоки, ещё не закончившие итерацию
+    int poolChunk;
+    bool poolStopping;
+    
+    void buildTree();
+    int newNode(double centerX, double centerY, double halfSize);
+    void insertBody(int body);
+    LayoutPoint repulsion(int body) const;
+    void computeRepulsion(int begin, int end);
+    void workerLoop(int part);
+    void computeRepulsionParallel(int threads);
+};
+
+#endif //fORCE_LAYOUT_H
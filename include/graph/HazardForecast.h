@@ -0,0 +1,112 @@
+#ifndef HAZARDFORECAST_H
+#define HAZARDFORECAST_H
+
+#include "StarGraph.h"
+#include <unordered_map>
+#include <vector>
+
+/**
+ * траектория опасности (черной дыры) для прогноза:
+ * прямая с постоянной скоростью до конца оставшегося времени жизни
+ */
+struct HazardTrack {
+    double x, y;                  //текущая позиция центра (мировые координаты)
+    double velocityX, velocityY;  //скорость (единиц в секунду)
+    double radius;                //радиус поглощения
+    double remaining;             //оставшееся время жизни (сек)
+    
+    HazardTrack();
+    HazardTrack(double px, double py, double vx, double vy, double r, double remainingTime);
+};
+
+/**
+ * интервал времени [begin, end] (секунды от момента прогноза),
+ * в течение которого опасность hazard касается элемента карты
+ */
+struct HazardWindow {
+    double begin;
+    double end;
+    int hazard;                   //индекс траектории в прогнозе
+    
+    HazardWindow();
+    HazardWindow(double from, double to, int hazardIndex);
+    
+    bool Contains(double time) const { return time >= begin && time <= end; }
+};
+
+/**
+ * политика учёта прогноза при поиске пути
+ * элемент, поглощаемый до момента прохода торговца, либо исключается (Avoid),
+ * либо стоит дороже на penalty (Penalize)
+ */
+struct HazardPolicy {
+    enum Mode {
+        Avoid,
+        Penalize
+    };
+    
+    Mode mode;
+    double traderSpeed;           //единиц расстояния графа в секунду
+    double penalty;               //надбавка к стоимости угрожаемого перехода
+    double safetyMargin;          //запас по времени (сек)
+    
+    HazardPolicy(Mode m = Avoid, double speed = 1.0, double penaltyCost = 1000.0, double margin = 0.0);
+    
+    //время прохода ребра
+    double TravelTime(const EdgeData& data) const;
+};
+
+/**
+ * прогноз поглощения планет и рёбер черными дырами
+ * каждая дыра летит по прямой, поэтому окна считаются в замкнутой форме:
+ * для планеты - корни квадратного уравнения |p + v*t - c| = R,
+ * для ребра - пересечение луча с капсулой (отрезок, раздутый на R)
+ */
+class HazardForecast {
+public:
+    static constexpr double DEFAULT_PLANET_RADIUS = 30.0;
+    
+    explicit HazardForecast(double planetRadius = DEFAULT_PLANET_RADIUS);
+    
+    //═══ входные данные ═══
+    int AddHazard(const HazardTrack& track);      //возвращает индекс траектории
+    void SetPlanetPosition(int id, double x, double y);
+    void Clear();
+    
+    //окна для всех планет с известной позицией и рёбер между ними
+    void Compute(const StarGraph& graph);
+    
+    //═══ результаты (окна отсортированы по началу) ═══
+    const std::vector<HazardWindow>& GetPlanetWindows(int id) const;
+    const std::vector<HazardWindow>& GetLaneWindows(int from, int to) const;
+    
+    //момент гибели элемента (первое касание), бесконечность если не угрожает
+    double GetPlanetDoomTime(int id) const;
+    double GetLaneDoomTime(int from, int to) const;
+    
+    int GetHazardCount() const { return static_cast<int>(hazards.size()); }
+    int GetThreatenedPlanetCount() const { return static_cast<int>(planetWindows.size()); }
+    int GetThreatenedLaneCount() const { return static_cast<int>(laneWindows.size()); }
+    const HazardTrack& GetHazard(int index) const { return hazards[index]; }
+    
+    //═══ замкнутые формулы (окно обрезается по [0, remaining]) ═══
+    static bool PointWindow(const HazardTrack& track, double px, double py, double reach,
+                            double& begin, double& end);
+    static bool SegmentWindow(const HazardTrack& track, double ax, double ay,
+                              double bx, double by, double reach, double& begin, double& end);
+
+private:
+    struct Point {
+        double x, y;
+    };
+    
+    double planetRadius;
+    std::vector<HazardTrack> hazards;
+    std::unordered_map<int, Point> positions;
+    std::unordered_map<int, std::vector<HazardWindow>> planetWindows;
+    std::unordered_map<long long, std::vector<HazardWindow>> laneWindows;
+    
+    static long long laneKey(int from, int to);
+};
+
+#endif //hAZARDFORECAST_H
@@ -0,0 +1,75 @@
+#ifndef KSHORTESTPATHS_H
+#define KSHORTESTPATHS_H
+
+#include "StarGraph.h"
+#include "Dijkstra.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * K кратчайших простых (без повторов планет) маршрутов - вариант алгоритма Йена
+ * - обратное дерево кратчайших путей до цели строится один раз (FindAllShortestPathsTo)
+ * - если путь по дереву от точки ответвления не задевает запреты, он и есть
+ *   лучшее ответвление - поиск не нужен; иначе A* с оценкой по тому же дереву
+ * - ответвления считаются только от индекса отклонения пути (остальные уже перебраны)
+ * фильтр разнообразия пропускает маршрут, только если доля общих рёбер
+ * с каждым уже выбранным не больше maxSharedFraction
+ */
+class KShortestPaths {
+public:
+    struct Settings {
+        int k;                            //сколько маршрутов вернуть
+        double maxSharedFraction;         //1.0 - без фильтра разнообразия
+        int maxCandidates;                //сколько простых путей перебрать ради разнообразия (0 - 20 * k)
+        RouteMetric metric;
+        
+        Settings();
+    };
+    
+    explicit KShortestPaths(const StarGraph& g, const Settings& searchSettings = Settings());
+    
+    //маршруты по возрастанию стоимости в выбранной метрике
+    std::vector<DijkstraResult> FindPaths(int start, int end) const;
+    std::vector<DijkstraResult> FindPaths(const std::string& startName, const std::string& endName) const;
+    
+    //доля рёбер маршрута a, которые есть и в маршруте b
+    static double SharedLaneFraction(const DynamicArray<int>& a, const DynamicArray<int>& b);
+    
+    //число запусков A* за последний запрос (остальные ответвления взяты из дерева)
+    int GetLastSearchCount() const { return lastSearchCount; }
+
+private:
+    struct Candidate {
+        std::vector<int> path;
+        double cost;
+        int deviation;                    //индекс вершины, с которой путь отходит от родителя
+    };
+    
+    const StarGraph& graph;
+    Settings settings;
+    mutable int lastSearchCount;
+    
+    //состояние одного запроса: плотные индексы вершин, дерево до цели, рабочие массивы A*
+    struct Query {
+        std::unordered_map<int, int> index;   //id планеты -> плотный индекс
+        std::vector<int> ids;
+        std::vector<double> toTarget;         //расстояние до цели в полном графе
+        std::vector<char> blocked;            //вершины корня текущего ответвления
+        std::vector<double> cost;             //g для A* (сбрасывается по touched)
+        std::vector<int> parent;
+        std::vector<int> touched;
+    };
+    
+    //лучшее ребро from -> to в метрике (из параллельных), бесконечность если нет
+    double laneWeight(int from, int to) const;
+    
+    //путь от spur до цели в обход заблокированных вершин и первых шагов blockedNext;
+    //сначала проверяется путь по дереву, затем A*; false - пути нет
+    bool findSpur(Query& query, int spur, int end, const std::vector<int>& blockedNext,
+                  std::vector<int>& spurPath, double& spurCost) const;
+    bool followTree(Query& query, int spur, int end, const std::vector<int>& blockedNext,
+                    std::vector<int>& spurPath, double& spurCost) const;
+};
+
+#endif //kSHORTESTPATHS_H
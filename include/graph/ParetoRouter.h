@@ -0,0 +1,74 @@
+#ifndef PARETOROUTER_H
+#define PARETOROUTER_H
+
+#include "StarGraph.h"
+#include "DynamicArray.h"
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * маршрут с фронта Парето: ни один другой маршрут не короче и не безопаснее одновременно
+ */
+struct ParetoRoute {
+    double distance;                      //суммарное расстояние
+    double riskWeight;                    //сумма -log(1 - risk) по рёбрам
+    double encounterProbability;          //вероятность хотя бы одной встречи с пиратами
+    DynamicArray<int> path;
+    DynamicArray<int> lanes;              //индекс ребра в GetEdges(path[i]) для перехода path[i] -> path[i + 1]
+    DynamicArray<std::string> pathNames;
+    
+    ParetoRoute();
+};
+
+/**
+ * многокритериальный поиск маршрутов (расстояние против риска)
+ * метки (расстояние, риск) извлекаются в лексикографическом порядке, у каждой вершины
+ * хранится «мешок» взаимно недоминируемых меток, отсортированный по расстоянию
+ * (риск в нём строго убывает - проверка доминирования двоичным поиском)
+ * метки лежат в общем плоском пуле и ссылаются на родителя по индексу
+ */
+class ParetoRouter {
+public:
+    struct Settings {
+        int maxLabelsPerVertex;           //0 - без ограничения; иначе фронт приближённый
+        int maxRoutes;                    //0 - весь фронт
+        double maxDistance;               //бюджет расстояния: более длинные метки отбрасываются
+        
+        Settings();
+    };
+    
+    explicit ParetoRouter(const StarGraph& g, const Settings& routerSettings = Settings());
+    
+    //фронт Парето маршрутов из start в end по возрастанию расстояния
+    std::vector<ParetoRoute> FindParetoFront(int start, int end) const;
+    std::vector<ParetoRoute> FindParetoFront(const std::string& startName, const std::string& endName) const;
+    
+    //вес риска ребра: при независимых встречах -log(1 - risk) складывается вдоль пути
+    static double RiskWeight(double riskFactor);
+    
+    //число меток, созданных последним запросом (для профилирования)
+    int GetLastLabelCount() const { return lastLabelCount; }
+
+private:
+    struct Label {
+        double distance;
+        double risk;
+        int vertex;
+        int parent;                       //индекс метки-родителя в пуле, -1 у стартовой
+        int edge;                         //индекс ребра в списке родителя (важно при параллельных рёбрах)
+        bool alive;                       //false - вытеснена доминирующей меткой
+    };
+    
+    const StarGraph& graph;
+    Settings settings;
+    mutable int lastLabelCount;
+    
+    //добавить метку в мешок вершины; false - метка доминируется или мешок полон
+    static bool insertLabel(std::vector<Label>& pool, std::vector<int>& bag, int label, int maxLabels);
+    //доминируется ли (distance, risk) какой-либо меткой мешка
+    static bool isDominated(const std::vector<Label>& pool, const std::vector<int>& bag,
+                            double distance, double risk);
+};
+
+#endif //pARETOROUTER_H
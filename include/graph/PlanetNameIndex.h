@@ -0,0 +1,52 @@
+#ifndef PLANET_NAME_INDEX_H
+#define PLANET_NAME_INDEX_H
+
+#include "DynamicArray.h"
+#include <string>
+#include <set>
+#include <utility>
+#include <unordered_map>
+#include <unordered_set>
+
+/**
+ * поисковый индекс по названиям планет
+ * префиксный поиск - по отсортированному множеству имен, O(log n + k)
+ * нечеткий поиск - по триграммам символов (сходство Жаккара)
+ * регистр не учитывается (латиница и кириллица)
+ */
+class PlanetNameIndex {
+private:
+    //отсортированные пары (имя в нижнем регистре, id)
+    std::set<std::pair<std::string, int>> sortedNames;
+    
+    //триграмма -> множество планет, в имени которых она встречается
+    std::unordered_map<std::string, std::unordered_set<int>> trigramPostings;
+    
+    //количество различных триграмм в имени планеты
+    std::unordered_map<int, int> trigramCount;
+    
+    //разбиение имени на различные триграммы (по символам UTF-8)
+    static std::unordered_set<std::string> extractTrigrams(const std::string& foldedName);
+
+public:
+    //приведение к нижнему регистру (ASCII и русский алфавит в UTF-8)
+    static std::string FoldCase(const std::string& text);
+    
+    //добавление и удаление имени
+    void Insert(const std::string& name, int id);
+    void Remove(const std::string& name, int id);
+    void Clear();
+    
+    //планеты, имя которых начинается с prefix (в алфавитном порядке)
+    DynamicArray<int> FindByPrefix(const std::string& prefix, int limit) const;
+    
+    //планеты с похожим именем (по убыванию сходства)
+    DynamicArray<int> FindFuzzy(const std::string& query, int limit) const;
+    
+    //сначала совпадения по префиксу, затем нечеткие совпадения
+    DynamicArray<int> Search(const std::string& query, int limit) const;
+    
+    int GetSize() const { return static_cast<int>(sortedNames.size()); }
+};
+
+#endif //pLANET_NAME_INDEX_H
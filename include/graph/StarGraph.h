@@ -2,9 +2,13 @@
 #define STAR_GRAPH_H
 
 #include "DynamicArray.h"
+#include "PlanetNameIndex.h"
+#include <memory>
 #include <string>
 #include <unordered_map>
 
+class TimeProfile;
+
 /**
  * данные планеты (звездной системы)
  */
@@ -24,13 +28,24 @@ struct PlanetData {
 struct EdgeData {
     double distance;      //физическое расстояние
     double riskFactor;    //фактор риска (0.0 - безопасно, 1.0 - очень опасно)
+    double survivalCost;  //-log(1 - riskFactor), считается в конструкторе (режим выживания)
+    
+    //расписание ребра (время перелёта и закрытия по времени отправления)
+    //nullptr - ребро статично; профиль неизменяем и разделяется между копиями
+    std::shared_ptr<const TimeProfile> profile;
     
     EdgeData();
     EdgeData(double dist, double risk);
+    EdgeData(double dist, double risk, std::shared_ptr<const TimeProfile> timeProfile);
     
     //общая стоимость перехода (расстояние + штраф за риск)
     double getTotalCost() const;
     
+    //вероятность пройти ребро без встречи с пиратами = exp(-survivalCost),
+    //поэтому вдоль пути survivalCost складывается, а вероятности перемножаются
+    double getSurvivalProbability() const;
+    static double computeSurvivalCost(double risk);
+    
     //операторы сравнения
     bool operator<(const EdgeData& other) const;
     bool operator>(const EdgeData& other) const;
@@ -49,6 +64,38 @@ struct Edge {
     Edge(int source, int destination, EdgeData edgeData);
 };
 
+/**
+ * диапазон вершин графа без копирования (для range-based for)
+ * итерирует живые вершины прямо по списку смежности
+ * действителен до следующего добавления/удаления вершины
+ */
+class VertexRange {
+public:
+    using MapIterator = std::unordered_map<int, DynamicArray<Edge>>::const_iterator;
+    
+    class Iterator {
+    private:
+        MapIterator it;
+        
+    public:
+        explicit Iterator(MapIterator position) : it(position) {}
+        
+        int operator*() const { return it->first; }
+        Iterator& operator++() { ++it; return *this; }
+        bool operator==(const Iterator& other) const { return it == other.it; }
+        bool operator!=(const Iterator& other) const { return it != other.it; }
+    };
+    
+    VertexRange(MapIterator rangeBegin, MapIterator rangeEnd) : first(rangeBegin), last(rangeEnd) {}
+    
+    Iterator begin() const { return Iterator(first); }
+    Iterator end() const { return Iterator(last); }
+    
+private:
+    MapIterator first;
+    MapIterator last;
+};
+
 /**
  * ориентированный взвешенный граф для представления звездных систем
  * вершины - планеты, ребра - гиперпространственные переходы
@@ -64,8 +111,27 @@ private:
     //обратная карта: имя -> индекс
     std::unordered_map<std::string, int> nameToIndex;
     
+    //поисковый индекс по именам (префикс + триграммы)
+    PlanetNameIndex nameIndex;
+    
+    //число входящих рёбер каждой вершины (исходящие = размер списка смежности)
+    std::unordered_map<int, int> inDegree;
+    
     int vertexCount;
+    int edgeCount;
     int nextVertexId;
+    
+    //счетчик изменений графа (для инвалидации кэшей)
+    unsigned long long version;
+    //счетчик изменений набора вершин и рёбер (артефакты, расстояния и расписания его не меняют)
+    unsigned long long topologyVersion;
+    
+    //вершины по возрастанию id; поддерживается изменяющими методами,
+    //поэтому константные методы ничего не пишут и безопасны для параллельного чтения
+    DynamicArray<int> vertexArray;
+    
+    void markChanged();
+    void markTopologyChanged();   //добавление или удаление вершин и рёбер
 
 public:
     StarGraph();
@@ -88,6 +154,9 @@ public:
     //обновление расстояния ребра (при перемещении планет)
     void UpdateEdgeDistance(int from, int to, double newDistance);
     
+    //назначение расписания ребру (nullptr - снова статичное)
+    void SetEdgeProfile(int from, int to, std::shared_ptr<const TimeProfile> profile);
+    
     //получение списка смежных вершин
     const DynamicArray<Edge>& GetEdges(int vertex) const;
     
@@ -112,12 +181,39 @@ public:
     //получение количества вершин
     int GetVertexCount() const;
     
-    //получение всех вершин графа
+    //═══ степени вершин (поддерживаются при каждом изменении, O(1)) ═══
+    int GetEdgeCount() const { return edgeCount; }
+    int GetInDegree(int vertex) const;
+    int GetOutDegree(int vertex) const;
+    int GetDegree(int vertex) const;   //входящие + исходящие
+    
+    //получение всех вершин графа (копия)
     DynamicArray<int> GetAllVertices() const;
     
+    //обход вершин без выделения памяти: for (int v : graph.Vertices())
+    VertexRange Vertices() const;
+    
+    //вершины по возрастанию id, без копирования
+    const DynamicArray<int>& GetVertexArray() const;
+    
+    //номер версии графа, увеличивается при каждом изменении
+    unsigned long long GetVersion() const { return version; }
+    //номер версии набора вершин и рёбер (пространственные индексы перестраиваются только по нему)
+    unsigned long long GetTopologyVersion() const { return topologyVersion; }
+    
     //получение карты всех планет (индекс -> имя)
     const std::unordered_map<int, std::string>& GetAllPlanets() const;
     
+    //═══ поиск планет по имени ═══
+    //планеты, имя которых начинается с prefix (без учета регистра)
+    DynamicArray<int> FindVerticesByPrefix(const std::string& prefix, int limit) const;
+    
+    //планеты с похожим именем (нечеткий поиск по триграммам)
+    DynamicArray<int> FindVerticesFuzzy(const std::string& query, int limit) const;
+    
+    //совпадения по префиксу, дополненные нечеткими (для автодополнения)
+    DynamicArray<int> SearchVertices(const std::string& query, int limit) const;
+    
     //очистка графа
     void Clear();
     
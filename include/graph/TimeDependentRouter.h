@@ -0,0 +1,50 @@
+#ifndef TIMEDEPENDENTROUTER_H
+#define TIMEDEPENDENTROUTER_H
+
+#include "StarGraph.h"
+#include "TimeProfile.h"
+#include "DynamicArray.h"
+#include <string>
+#include <unordered_map>
+
+/**
+ * результат поиска самого раннего прибытия
+ */
+struct TimeDependentResult {
+    bool pathExists;
+    double departureTime;                //момент запроса
+    double arrivalTime;                  //прибытие в конечную вершину
+    DynamicArray<int> path;
+    DynamicArray<double> departures;     //фактическое отправление из каждой вершины пути (с ожиданием)
+    DynamicArray<std::string> pathNames;
+    
+    TimeDependentResult();
+};
+
+/**
+ * поиск пути с самым ранним прибытием по рёбрам, зависящим от времени
+ * метка вершины - время прибытия; благодаря ожиданию на планетах
+ * функции прибытия монотонны (FIFO), и обычная схема Дейкстры остаётся точной
+ * рёбра без профиля проходятся за distance / speed без обращения к профилю
+ */
+class TimeDependentRouter {
+private:
+    const StarGraph& graph;
+    double speed;                        //единиц расстояния в секунду для статичных рёбер
+    
+    //самое раннее прибытие по ребру при готовности к отправлению в ready
+    double arrivalAlong(const EdgeData& data, double ready, double& departure) const;
+
+public:
+    explicit TimeDependentRouter(const StarGraph& g, double travelSpeed = 1.0);
+    
+    //самое раннее прибытие из start в end при отправлении не раньше departureTime
+    TimeDependentResult FindEarliestArrival(int start, int end, double departureTime) const;
+    TimeDependentResult FindEarliestArrival(const std::string& startName, const std::string& endName,
+                                            double departureTime) const;
+    
+    //самое раннее прибытие во все достижимые вершины
+    std::unordered_map<int, double> FindAllEarliestArrivals(int start, double departureTime) const;
+};
+
+#endif //tIMEDEPENDENTROUTER_H
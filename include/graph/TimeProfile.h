@@ -0,0 +1,55 @@
+#ifndef TIMEPROFILE_H
+#define TIMEPROFILE_H
+
+#include <limits>
+#include <vector>
+
+/**
+ * зависимость ребра от времени отправления
+ * - время перелёта: кусочно-линейная функция по точкам (время, длительность),
+ *   до первой и после последней точки - постоянная; без точек - статичная длительность ребра
+ * - доступность: интервалы (from, to), в которые отправиться по ребру нельзя
+ * торговец может ждать на планете, поэтому прибытие считается с учётом ожидания
+ * и никогда не бывает раньше, чем при более раннем отправлении (FIFO)
+ */
+class TimeProfile {
+public:
+    static constexpr double NEVER = std::numeric_limits<double>::infinity();
+    
+    TimeProfile();
+    
+    //точка функции времени перелёта (точки могут добавляться в любом порядке)
+    void AddPoint(double time, double travelTime);
+    
+    //ребро закрыто на (from, to); to = NEVER - закрыто навсегда
+    void AddClosure(double from, double to);
+    
+    //длительность перелёта при отправлении в departure (без учёта закрытий)
+    double TravelTime(double departure, double staticTravelTime) const;
+    
+    //можно ли отправиться в момент time
+    bool IsOpen(double time) const;
+    
+    //самое раннее прибытие, если торговец готов отправиться в ready;
+    //departure - фактическое время отправления (после ожидания), NEVER если ребро больше не откроется
+    double EarliestArrival(double ready, double staticTravelTime, double* departure = nullptr) const;
+    
+    bool HasTravelTimes() const { return !points.empty(); }
+    bool HasClosures() const { return !closures.empty(); }
+
+private:
+    struct Point {
+        double time;
+        double travelTime;
+    };
+    
+    struct Closure {
+        double from;
+        double to;
+    };
+    
+    std::vector<Point> points;       //по возрастанию времени
+    std::vector<Closure> closures;   //по возрастанию начала, без пересечений
+};
+
+#endif //tIMEPROFILE_H
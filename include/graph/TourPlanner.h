@@ -0,0 +1,82 @@
+#ifndef TOURPLANNER_H
+#define TOURPLANNER_H
+
+#include "StarGraph.h"
+#include "Dijkstra.h"
+#include "DynamicArray.h"
+#include <chrono>
+#include <vector>
+
+/**
+ * план обхода набора планет (сбор артефактов)
+ */
+struct TourPlan {
+    bool feasible;                        //все достижимые цели обходятся без разрывов
+    bool timedOut;                        //локальный поиск остановлен лимитом времени
+    double totalCost;                     //сумма кратчайших путей между соседями по обходу
+    std::vector<int> order;               //цели в порядке посещения (без стартовой планеты)
+    std::vector<int> unreachable;         //цели, до которых от старта не добраться
+    DynamicArray<int> path;               //полный маршрут по планетам
+    
+    TourPlan();
+};
+
+/**
+ * порядок обхода целей из стартовой планеты (путь или цикл, граф может быть несимметричным)
+ * 1. матрица кратчайших путей: по поиску Дейкстры из старта и каждой цели,
+ *    поиск останавливается, как только извлечены все цели; источники делятся между потоками
+ * 2. несколько стартовых обходов параллельно (ближайший сосед, дешёвая вставка,
+ *    рандомизированный ближайший сосед), каждый улучшается 2-opt и Or-opt
+ * 3. лучший обход разворачивается в маршрут по планетам
+ * лимит времени ограничивает локальный поиск; при его исчерпании возвращается лучшее найденное
+ */
+class TourPlanner {
+public:
+    struct Settings {
+        RouteMetric metric;
+        bool returnToStart;               //замкнутый обход с возвратом на стартовую планету
+        int threadCount;                  //0 - по числу ядер
+        int constructions;                //число стартовых обходов (0 - по числу потоков, не меньше 3)
+        double timeBudgetMs;              //лимит на весь запрос, миллисекунды
+        
+        Settings();
+    };
+    
+    explicit TourPlanner(const StarGraph& g, const Settings& plannerSettings = Settings());
+    
+    TourPlan PlanTour(int start, const std::vector<int>& targets) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    
+    //матрица n x n: 0 - старт, 1..m - цели, m + 1 - фиктивный финиш
+    //(вход в него бесплатен для пути и равен возврату на старт для цикла)
+    struct Matrix {
+        int size;
+        std::vector<double> cost;
+        
+        double operator()(int from, int to) const { return cost[from * size + to]; }
+    };
+    
+    //граф в сжатом виде (CSR) для многократных поисков из разных потоков
+    struct Adjacency {
+        std::vector<int> offsets;
+        std::vector<int> targets;
+        std::vector<double> weights;
+    };
+    
+    const StarGraph& graph;
+    Settings settings;
+    
+    //Дейкстра из source до извлечения всех goals; parent - дерево для восстановления путей
+    static void searchFrom(const Adjacency& adjacency, int source, const std::vector<int>& goals,
+                           std::vector<double>& distance, std::vector<int>& parent);
+    
+    static std::vector<int> nearestNeighbor(const Matrix& matrix, unsigned seed, int choices);
+    static std::vector<int> cheapestInsertion(const Matrix& matrix);
+    static double tourCost(const Matrix& matrix, const std::vector<int>& tour);
+    //2-opt и Or-opt до локального минимума; false - остановлено по времени
+    static bool improve(const Matrix& matrix, std::vector<int>& tour, Clock::time_point deadline);
+};
+
+#endif //tOURPLANNER_H
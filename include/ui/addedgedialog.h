@@ -2,7 +2,9 @@
 #define ADDEDGEDIALOG_H
 
 #include <QDialog>
+#include <QComboBox>
 #include "StarGraph.h"
+#include "planetsearchmodel.h"
 
 namespace Ui {
 class AddEdgeDialog;
@@ -23,6 +25,9 @@ public:
 
 private:
     Ui::AddEdgeDialog *ui;
+    
+    //настройка комбобокса: ленивый список + автодополнение по индексу
+    void setupPlanetComboBox(QComboBox* comboBox, StarGraph* graph);
 };
 
 #endif //aDDEDGEDIALOG_H
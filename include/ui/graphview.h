@@ -4,13 +4,31 @@
 #include <QWidget>
 #include <QPoint>
 #include <QMap>
+#include <QHash>
+#include <QSet>
 #include <QStringList>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QRegion>
+#include <QPixmap>
+#include <QRect>
+#include <QTransform>
 #include "StarGraph.h"
 #include "DynamicArray.h"
+#include "UniformGrid.h"
+#include "ForceLayout.h"
 #include "Trader.h"
-#include "BlackHole.h"
+#include "HazardField.h"
+#include "GameSimulation.h"
+#include "HazardForecast.h"
+#include "SimulationClock.h"
 #include "visual_effects.h"
+#include "maprenderer.h"
+#include "perfmonitor.h"
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 struct NodePosition {
     QPointF position;
@@ -47,11 +65,33 @@ class GraphView : public QWidget
     Q_OBJECT
 
 public:
-    explicit GraphView(StarGraph* g, QWidget *parent = nullptr);
+    //карта, торговец и черные дыры принадлежат симуляции; виджет их показывает
+    explicit GraphView(GameSimulation* simulation, QWidget *parent = nullptr);
+    ~GraphView() override;
     
     void highlightPath(const DynamicArray<int>& path);
     void addLogMessage(const QString& message);
-    void setTrader(Trader* t) { trader = t; }  //установить торговца
+    
+    //═══ автоматическая раскладка ═══
+    //считается в фоновом потоке, промежуточные позиции появляются на карте по ходу
+    //fromScratch - игнорировать текущие позиции (например, после загрузки из файла)
+    void startAutoLayout(bool fromScratch = false);
+    void stopAutoLayout();   //прервать без пересчёта расстояний
+    bool isLayoutRunning() const { return layoutThread.joinable() && !layoutCancelled; }
+    
+    //═══ оверлей производительности (ENABLE_PERF_OVERLAY) ═══
+    void setPerfOverlayVisible(bool visible);
+    bool isPerfOverlayVisible() const { return perfOverlayVisible; }
+    void reportTimerTick(PerfMonitor::Timer timer);   //тики внешних таймеров (MainWindow::gameTimer)
+    bool dumpPerfStats(const QString& path) const;    //CSV по кадрам
+    
+    //═══ симуляция ═══
+    //все анимации и игровые системы продвигаются одними часами с фиксированным шагом
+    SimulationClock& simulationClock() { return clock; }
+    void runSimulationFor(double seconds);   //без ожидания реального времени (ускоренный прогон)
+    
+    //прогноз поглощения планет и рёбер активными черными дырами (время - секунды симуляции)
+    HazardForecast forecastHazards();
 
 protected:
     void paintEvent(QPaintEvent *event) override;
@@ -59,48 +99,128 @@ protected:
     void mouseMoveEvent(QMouseEvent *event) override;
     void mouseReleaseEvent(QMouseEvent *event) override;
     void resizeEvent(QResizeEvent *event) override;
-
-private slots:
-    void onAnimationStep();      //шаг анимации пути
-    void onMeteorUpdate();       //обновление метеоритов
-    void onBlackHoleSpawn();     //спавн черной дыры
-    void onBlackHoleUpdate();    //обновление черной дыры
+    void wheelEvent(QWheelEvent *event) override;
 
 private:
+    GameSimulation* game;                //правила игры и шаг мира (координаты планет передаются ей)
     StarGraph* graph;
     Trader* trader;                      //торговец (персонаж)
     QMap<int, NodePosition> nodePositions;
+    UniformGrid<int> nodeGrid;           //пространственный индекс позиций планет
+    UniformGrid<qint64> laneGrid;        //индекс отрезков рёбер (по габаритам)
+    QHash<int, QSet<qint64>> nodeLanes;  //планета -> инцидентные ей рёбра в laneGrid
     DynamicArray<int> highlightedPath;
     int selectedNode;
     bool isDragging;
-    QPoint dragOffset;
+    QPointF dragOffset;                  //смещение курсора от центра планеты (мир)
     QStringList logMessages;
     
+    //═══ камера ═══
+    //планеты, рёбра, торговец и черная дыра живут в мировых координатах,
+    //экран = мир * zoom + panOffset; фон, метеориты и лог - в экранных
+    static constexpr double MIN_ZOOM = 0.05;
+    static constexpr double MAX_ZOOM = 4.0;
+    static constexpr double LOD_LABEL_ZOOM = 0.6;    //ниже - без имён и стоимостей
+    static constexpr double LOD_CLUSTER_ZOOM = 0.25; //ниже - планеты объединяются в скопления
+    static constexpr int CLUSTER_CELL_PX = 48;       //размер ячейки скопления на экране
+    
+    double zoom;
+    QPointF panOffset;
+    bool isPanning;
+    QPoint lastPanPos;
+    
+    QTransform worldTransform() const;
+    QPointF screenToWorld(const QPointF& pos) const;
+    QRectF visibleWorldRect() const;        //только отсечение при рисовании
+    QRectF planetsWorldRect() const;        //габариты планет (мир)
+    void zoomAround(const QPointF& anchor, double factor);  //anchor остаётся на месте
+    
     //вспомогательные методы
     void updateEdgeDistances(int vertexId);  //пересчёт расстояний при перемещении планеты
+    void updateAllEdgeDistances();           //пересчёт всех рёбер (после раскладки)
+    static double logicalDistance(const QPointF& a, const QPointF& b);  //пиксели -> единицы графа
+    
+    //═══ фоновая раскладка ═══
+    std::thread layoutThread;
+    std::atomic<bool> layoutCancelled;
+    unsigned long long layoutGeneration;     //результаты прерванных раскладок отбрасываются
+    bool layoutFitsView;                     //подгонять камеру под раскладку с нуля
+    
+    void applyLayoutPositions(const std::unordered_map<int, LayoutPoint>& positions,
+                              unsigned long long generation, bool finished);
+    void fitViewToNodes();                   //камера охватывает все планеты
+    
+    //═══ кэшированные слои отрисовки ═══
+    //статичные слои пересобираются только при изменениях,
+    //анимированные (метеориты, черная дыра, торговец) рисуются поверх
+    QPixmap backgroundLayer;                 //фон + звезды
+    MapRenderer* mapRenderer;                //рёбра с подписями, узлы, артефакты (тайлы в фоне)
+    bool backgroundDirty;
+    bool graphLayerDirty;
+    unsigned long long syncedGraphVersion;   //версия графа, с которой согласован слой
+    unsigned long long syncedTopologyVersion;   //версия набора вершин и рёбер, с которой согласованы позиции и индексы
+    
+    QPixmap createLayerPixmap() const;
+    void rebuildBackgroundLayer();
+    void rebuildGraphLayer();                //снимок видимой карты -> фоновая растеризация
+    void collectClusters(MapSnapshot& snapshot, const QRectF& visible);
+    void invalidateGraphLayer();             //пересобрать слой графа при следующей отрисовке
+    
+    //═══ согласование с графом ═══
+    //полная синхронизация нужна только при изменениях графа (внешних или поглощениях в шаге симуляции)
+    void syncWithGraph();
+    void pushPlanetPosition(int nodeId);     //координаты планеты -> симуляция (проверки черных дыр)
+    bool isSyncedWithGraph() const { return syncedGraphVersion == graph->GetVersion(); }
+    
+    //═══ индекс рёбер ═══
+    static qint64 laneKey(int from, int to);
+    void rebuildLaneGrid();                  //полная перестройка (после внешних изменений)
+    void updateLane(int from, int to);       //добавить или обновить отрезок ребра
+    void updateNodeLanes(int nodeId);        //после перемещения планеты
+    
+    //области экрана, занятые анимированными объектами (для частичной перерисовки)
+    QRect meteorBounds(const Meteor& meteor) const;
+    QRect blackHoleBounds(int slot) const;
+    
+    //═══ часы симуляции ═══
+    //один таймер кадра продвигает часы, системы копят грязные области,
+    //и за кадр выполняется не больше одной перерисовки
+    static constexpr double SIMULATION_STEP = 1.0 / 60.0;  //фиксированный шаг (сек)
+    SimulationClock clock;
+    QTimer* frameTimer;
+    QElapsedTimer frameClock;                //реальное время между кадрами
+    QRegion pendingRepaint;                  //накопленная за кадр грязная область
+    bool pendingFullRepaint;
+    int animationSystem;
+    
+    void onFrame();                          //тик таймера кадра
+    void scheduleRepaint();                  //весь виджет
+    void scheduleRepaint(const QRegion& region);
+    void flushRepaint();
+    
+    //═══ системы симуляции ═══
+    void onAnimationStep();                  //шаг анимации пути
+    void onMeteorUpdate();                   //обновление метеоритов
+    void onBlackHoleUpdate(double deltaTime);  //шаг симуляции (GameSimulation::step) и перерисовка черных дыр
     
     //═══ визуальные эффекты ═══
     //анимация пути
-    QTimer* animationTimer;
     int animationStep;
     bool isAnimating;
     
     //метеориты
-    QTimer* meteorTimer;
     QVector<Meteor> meteors;
     
     //статичные звезды (чтобы не мелькали)
     QVector<Star> stars;
     
-    //═══ черная дыра ═══
-    QTimer* blackHoleSpawnTimer;     //таймер спавна черной дыры (60 сек)
-    QTimer* blackHoleUpdateTimer;    //таймер обновления позиции (50 мс)
-    BlackHole* blackHole;            //текущая черная дыра (nullptr если нет)
+    //═══ черные дыры ═══
+    //все черные дыры живут в поле опасностей симуляции (массивы по слотам, пул без new/delete);
+    //появляются, двигаются и поглощают планеты в GameSimulation::step, виджет только рисует их
+    const HazardField& hazards;
     
     void updateNodePositions();
-    void drawNode(QPainter& painter, const NodePosition& node, bool isHighlighted);
-    void drawEdge(QPainter& painter, const QPointF& from, const QPointF& to, 
-                  const EdgeData& data, bool isHighlighted);
+    void drawTrader(QPainter& painter);
     int getNodeAtPosition(const QPoint& pos);
     QPointF getRandomPosition();
     
@@ -110,12 +230,19 @@ private:
     void drawMeteors(QPainter& painter);  //отрисовка метеоритов
     void drawStars(QPainter& painter);    //отрисовка звезд
     QColor getNodeColorByConnections(int nodeId);  //цвет планеты по связям
+    QHash<int, QPair<int, QColor>> nodeColorCache;  //планета -> (степень, цвет)
     
     //═══ методы для черной дыры ═══
-    void spawnBlackHole();       //создать черную дыру
-    void drawBlackHole(QPainter& painter);  //отрисовка черной дыры
-    void checkBlackHoleCollisions();  //проверка столкновений с планетами
-    void checkBlackHoleEdgeCollisions();  //проверка столкновений с рёбрами (путями)
+    void drawBlackHoles(QPainter& painter);  //отрисовка черных дыр
+    
+    //═══ оверлей производительности ═══
+    PerfMonitor perf;
+    bool perfOverlayVisible;
+    unsigned long long perfSeenMapFrames;    //кадры MapRenderer, время которых уже учтено
+    int perfOverlaySystem;                   //периодическое обновление оверлея
+    
+    QRect perfOverlayRect() const;
+    void drawPerfOverlay(QPainter& painter);
 };
 
 #endif //gRAPHVIEW_H
@@ -4,11 +4,11 @@
 #include <QMainWindow>
 #include <QLabel>
 #include <QTextEdit>
-#include <QTimer>
 #include "StarGraph.h"
 #include "Dijkstra.h"
 #include "graphview.h"
 #include "Trader.h"
+#include "GameSimulation.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -28,47 +28,60 @@ private slots:
     void onRemovePlanet();
     void onRemoveEdge();
     void onFindPath();
+    void onChooseRoute();       //выбор из фронта Парето (расстояние против риска)
+    void onAlternativeRoutes(); //K лучших непохожих маршрутов в текущем режиме
+    void onPlanArtifactTour();  //обход всех планет с артефактами
     void onLoadFromFile();      //загрузить граф из файла
     void onSaveToFile();        //сохранить граф в файл
     void onClearGraph();
     void onAbout();
+    void onSavePerfStats();     //выгрузить статистику кадров в CSV
     
     //═══ торговец ═══
     void onShowTraderInfo();    //показать информацию о торговце
     
     //═══ игровой таймер ═══
-    void onGameTimerTick();     //обновление игрового таймера
+    void onGameTimerTick();     //обновление игрового таймера (раз в секунду симуляции)
 
 private:
     Ui::MainWindow *ui;
-    StarGraph graph;
+    GameSimulation game;        //правила игры без интерфейса (окно только показывает события)
+    StarGraph& graph;           //карта игры
     GraphView *graphView;
     QLabel *statusLabel;
     QTextEdit *logWidget;
-    Trader trader;              //торговец игрока
+    Trader& trader;             //торговец игрока
     
     //═══ игровая механика ═══
-    QTimer* gameTimer;          //таймер игры
+    int gameSystem;             //секундомер игры на часах симуляции
     QLabel* timerLabel;         //отображение времени
     QLabel* artifactLabel;      //отображение счетчика артефактов
-    int gameTimeSeconds;        //прошедшее время в секундах
-    int collectedArtifacts;     //собранные артефакты
-    bool gameStarted;           //началась ли игра
     
-    static constexpr int REQUIRED_ARTIFACTS = 10; //цель игры
-    static constexpr int MIN_PLANETS_TO_START = 5; //минимум планет для старта
+    //═══ режим маршрута ═══
+    RouteMetric routeMetric;        //что минимизирует "Найти путь"
+    double routeDistanceBudget;     //лимит расстояния для режима выживания (0 - без лимита)
+    
+    static constexpr int MAX_ROUTE_OPTIONS = 12;   //вариантов маршрута в списке выбора
+    static constexpr int ALTERNATIVE_ROUTES = 5;   //альтернативных маршрутов в списке
+    static constexpr double MAX_SHARED_LANES = 0.6; //доля общих переходов у альтернатив
     
     void updateStatusBar();
     void logMessage(const QString& message);
     void showPathResult(const DijkstraResult& result, const QString& from, const QString& to, double timeMicrosec);
     void updateTraderDisplay(); //обновить отображение торговца
     
+    //═══ маршруты ═══
+    bool pickRouteEndpoints(QString& fromPlanet, QString& toPlanet);  //позиция торговца + выбор цели
+    //пираты, артефакты, прибытие; metric - по ней выбирается переход среди параллельных
+    void travelRoute(const DynamicArray<int>& path, double cost, RouteMetric metric);
+    void travelRoute(const DynamicArray<int>& path, const DynamicArray<int>& lanes, double cost);  //заданные переходы
+    GameSimulation::BattleResolver battleResolver();  //битва с пиратами в диалоге PirateBattle
+    
     //═══ управление игрой ═══
-    void startGame();           //начать игру
-    void checkGameStart();      //проверить условия старта
-    void spawnArtifact();       //создать артефакт на случайной планете
-    void collectArtifact(int planetId); //собрать артефакт
-    void checkVictory();        //проверить победу
+    static GameSimulation::Settings gameSettings();   //правила игры окна
+    void onGameEvent(const GameEvent& event);         //события симуляции -> журнал, счётчики, диалоги
+    void resetGameLabels();     //таймер и счётчик артефактов до старта
+    void showVictory(double gameTime, int completedRoutes, int totalDistance);
 };
 
 #endif //mAINWINDOW_H
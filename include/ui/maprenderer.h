@@ -0,0 +1,128 @@
+#ifndef MAPRENDERER_H
+#define MAPRENDERER_H
+
+#include <QObject>
+#include <QImage>
+#include <QFont>
+#include <QColor>
+#include <QElapsedTimer>
+#include <QLineF>
+#include <QRect>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+#include <QTransform>
+#include <QVector>
+#include <atomic>
+#include <memory>
+#include "StarGraph.h"
+
+class QPainter;
+
+//неизменяемый снимок статичной части карты (рёбра, планеты, артефакты)
+//собирается в потоке GUI и только читается фоновыми потоками
+struct MapSnapshot {
+    struct Node {
+        QPointF position;
+        QString name;
+        QColor color;           //цвет по числу связей
+        bool highlighted;
+        bool hasArtifact;
+    };
+    
+    struct Lane {
+        QPointF from;
+        QPointF to;
+        EdgeData data;
+        bool highlighted;
+    };
+    
+    //скопление планет на крупном масштабе
+    struct Cluster {
+        QPointF center;
+        double radius;
+        int count;
+        bool highlighted;
+    };
+    
+    QVector<Lane> lanes;
+    QVector<Node> nodes;
+    QVector<Cluster> clusters;
+    QVector<QLineF> clusterLinks;
+    bool clustered = false;      //рисовать скопления вместо планет
+    bool detailed = true;        //имена планет и стоимости рёбер
+    
+    QTransform transform;        //мир -> экран
+    QSize viewportSize;
+    qreal devicePixelRatio = 1.0;
+    QFont font;
+};
+
+//фоновая растеризация карты: экран делится на тайлы QImage,
+//которые рисуются параллельно в пуле потоков по снимку карты
+//поток GUI только собирает готовые тайлы (composite)
+class MapRenderer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int TILE_SIZE = 256;   //сторона тайла в логических пикселях
+    
+    //время растеризации последнего собранного кадра (для оверлея производительности)
+    struct FrameStats {
+        qint64 lanesNs = 0;                  //рёбра, сумма по всем тайлам и потокам
+        qint64 nodesNs = 0;                  //планеты и артефакты, сумма по тайлам
+        qint64 wallNs = 0;                   //от запуска до последнего тайла
+        int tiles = 0;
+    };
+    
+    explicit MapRenderer(QObject *parent = nullptr);
+    ~MapRenderer() override;
+    
+    //запустить растеризацию снимка; незавершённая предыдущая отбрасывается
+    void render(std::shared_ptr<const MapSnapshot> snapshot);
+    void clear();                            //пустая карта
+    
+    //нарисовать последний готовый кадр с учётом текущей камеры
+    //(пока новый кадр не готов, старый сдвигается и масштабируется)
+    void composite(QPainter& painter, const QTransform& currentTransform) const;
+    
+    const FrameStats& lastFrameStats() const { return shownStats; }
+    unsigned long long completedFrames() const { return frameCounter; }  //растёт с каждым собранным кадром
+    
+    //═══ отрисовка элементов - только QPainter и данные снимка, безопасна в любом потоке ═══
+    //элементы одного стиля отправляются пакетом, подписи берутся из кэша разметки
+    static void drawLanes(QPainter& painter, const QVector<const MapSnapshot::Lane*>& lanes,
+                          const QFont& font, bool detailed);
+    static void drawNodes(QPainter& painter, const QVector<const MapSnapshot::Node*>& nodes,
+                          const QFont& font, bool detailed);
+    static void drawArtifact(QPainter& painter, const QPointF& planetCenter);
+    static void drawClusters(QPainter& painter, const MapSnapshot& snapshot);
+
+signals:
+    void frameReady();                       //новый кадр собран - нужна перерисовка
+
+private:
+    struct Frame {
+        QTransform transform;                //камера, с которой рисовался кадр
+        QVector<QRect> tileRects;            //экранные области тайлов
+        QVector<QImage> tiles;
+        int pending = 0;                     //сколько тайлов ещё не готово
+        FrameStats stats;
+        QElapsedTimer started;
+    };
+    
+    QThreadPool pool;
+    std::atomic<unsigned long long> generation;  //номер актуального кадра
+    Frame shownFrame;                        //последний полностью готовый кадр
+    Frame buildingFrame;                     //кадр, тайлы которого ещё рисуются
+    FrameStats shownStats;
+    unsigned long long frameCounter;
+    
+    friend class MapTileJob;
+    static QImage renderTile(const MapSnapshot& snapshot, const QRect& tileRect, FrameStats& stats);
+    void onTileReady(unsigned long long tileGeneration, int index, const QImage& image,
+                     const FrameStats& tileStats);
+};
+
+#endif //mAPRENDERER_H
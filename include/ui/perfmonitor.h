@@ -0,0 +1,85 @@
+#ifndef PERFMONITOR_H
+#define PERFMONITOR_H
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <array>
+
+//статистика производительности карты: время отрисовки по слоям,
+//частота срабатывания таймеров и перцентили времени кадра
+//живёт в потоке GUI (время тайлов приходит уже собранным от MapRenderer)
+class PerfMonitor
+{
+public:
+    //слои отрисовки GraphView
+    enum Layer {
+        LayerStars,          //фон со звездами (пересборка + вывод)
+        LayerMeteors,
+        LayerSnapshot,       //снимок видимой карты для фоновой растеризации
+        LayerMap,            //вывод готовых тайлов
+        LayerEdges,          //рёбра в тайлах (сумма по потокам пула)
+        LayerNodes,          //планеты и артефакты в тайлах (сумма по потокам пула)
+        LayerTrader,
+        LayerBlackHole,
+        LayerOverlay,        //лог, подсказки, сам оверлей
+        LayerCount
+    };
+    
+    //источники тиков
+    enum Timer {
+        TimerPaint,          //сами перерисовки (FPS)
+        TimerFrame,          //таймер кадра, продвигающий часы симуляции
+        TimerAnimation,      //система анимации пути
+        TimerMeteor,         //система метеоритов
+        TimerBlackHole,      //система черной дыры
+        TimerGame,           //игровая система MainWindow (секундомер)
+        TimerCount
+    };
+    
+    static constexpr int FRAME_HISTORY = 600;   //кадров в кольцевом буфере
+    
+    PerfMonitor();
+    
+    void beginFrame();
+    void addLayerTime(Layer layer, qint64 nsecs);   //в текущий кадр
+    void endFrame();
+    void tick(Timer timer);
+    void clear();
+    
+    int getFrameCount() const { return frameCount; }
+    double framePercentile(double percent) const;   //мс, percent в [0, 100]
+    double tickRate(Timer timer) const;             //тиков в секунду за последнее окно
+    
+    QStringList report() const;                     //строки для оверлея
+    bool writeCsv(const QString& path) const;       //по строке на кадр
+    
+    static QString layerName(Layer layer);
+    static QString timerName(Timer timer);
+
+private:
+    struct FrameSample {
+        qint64 totalNs = 0;
+        std::array<qint64, LayerCount> layerNs{};
+        std::array<float, TimerCount> rates{};      //частоты таймеров на момент кадра
+    };
+    
+    //счётчик тиков в секундном окне
+    struct TickCounter {
+        int count = 0;
+        double rate = 0.0;
+        QElapsedTimer window;
+    };
+    
+    QVector<FrameSample> frames;    //кольцевой буфер
+    int nextFrame;
+    int frameCount;                 //сколько кадров в буфере
+    FrameSample current;
+    QElapsedTimer frameTimer;
+    std::array<TickCounter, TimerCount> ticks;
+    
+    const FrameSample& frameAt(int age) const;      //0 - последний кадр
+};
+
+#endif //pERFMONITOR_H
@@ -6,13 +6,7 @@
 #include <QPushButton>
 #include <QTimer>
 #include <QVBoxLayout>
-
-//типы пиратов
-enum class PirateType {
-    ROOKIE,    //новички (risk < 0.25)
-    VETERAN,   //ветераны (0.25 <= risk <= 0.4)
-    BOSS       //босс-пираты (risk > 0.4)
-};
+#include "PirateModel.h"
 
 //диалог сражения с пиратами
 class PirateBattle : public QDialog {
@@ -31,7 +25,6 @@ private slots:
 
 private:
     void updateDisplay();                    //обновление отображения
-    PirateType determinePirateType(double risk); //определение типа пирата
 
 
     QLabel* infoLabel;         //информация о битве
@@ -0,0 +1,37 @@
+#ifndef PLANETPICKERDIALOG_H
+#define PLANETPICKERDIALOG_H
+
+#include <QDialog>
+#include <QLineEdit>
+#include <QListView>
+#include "StarGraph.h"
+#include "planetsearchmodel.h"
+
+//диалог выбора планеты с поиском по имени
+//замена QInputDialog::getItem, которому нужен полный список планет
+class PlanetPickerDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    PlanetPickerDialog(const StarGraph* graph, const QString& title,
+                       const QString& label, QWidget *parent = nullptr);
+
+    QString getPlanetName() const;
+
+    //аналог QInputDialog::getItem
+    static QString getPlanet(QWidget *parent, const StarGraph* graph,
+                             const QString& title, const QString& label, bool* ok);
+
+private slots:
+    void onAccept();
+
+private:
+    const StarGraph* graph;
+    QLineEdit* searchEdit;
+    QListView* listView;
+    PlanetSearchModel* model;
+    QString selectedName;
+};
+
+#endif //pLANETPICKERDIALOG_H
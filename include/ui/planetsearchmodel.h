@@ -0,0 +1,43 @@
+#ifndef PLANETSEARCHMODEL_H
+#define PLANETSEARCHMODEL_H
+
+#include <QAbstractListModel>
+#include <QString>
+#include <QVector>
+#include "StarGraph.h"
+
+//ленивая модель списка планет для комбобоксов и автодополнения
+//не копирует весь каталог: запрашивает индекс StarGraph постранично
+class PlanetSearchModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    static constexpr int PAGE_SIZE = 50;  //сколько строк запрашивать за раз
+
+    explicit PlanetSearchModel(const StarGraph* g, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    //подгрузка следующей страницы при прокрутке
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+    QString getQuery() const { return query; }
+    int getPlanetId(int row) const;
+
+public slots:
+    void setQuery(const QString& text);  //новый запрос (при вводе текста)
+
+private:
+    const StarGraph* graph;
+    QString query;
+    int limit;                 //сколько строк запрошено у индекса
+    QVector<int> planetIds;    //найденные планеты
+    QVector<QString> names;    //их имена (для отображения)
+
+    void runQuery(QVector<int>& ids, QVector<QString>& planetNames) const;
+};
+
+#endif //pLANETSEARCHMODEL_H
@@ -26,5 +26,10 @@ constexpr int METEOR_MIN_SPEED = 1;               //минимальная ск
 constexpr int METEOR_MAX_SPEED = 3;               //максимальная скорость
 constexpr int METEOR_UPDATE_INTERVAL_MS = 50;     //частота обновления (мс)
 
+//оверлей производительности (время слоев, частота таймеров, перцентили кадров)
+//false - замеры не компилируются; true - оверлей включается в меню (F3)
+constexpr bool ENABLE_PERF_OVERLAY = true;
+constexpr int PERF_OVERLAY_REFRESH_MS = 500;      //обновление оверлея (мс)
+
 #endif //VISUAL_EFFECTS_H
 
@@ -0,0 +1,600 @@
+#include "GameSimulation.h"
+#include "PirateModel.h"
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+//═══════════════════════════════════════════════════════════
+//GameSimulation implementation
+//═══════════════════════════════════════════════════════════
+
+GameSimulation::Settings::Settings()
+    : requiredArtifacts(10), minPlanetsToStart(5), blackHoleSpawnPeriod(60.0), blackHoleRadius(50.0),
+      planetRadius(30.0), maxBlackHoles(256), clicksPerSecond(3.0), seed(42), traderName("Торговец") {}
+
+GameSimulation::GameSimulation(const Settings& simulationSettings)
+    : settings(simulationSettings), trader(simulationSettings.traderName),
+      hazards(std::max(1, simulationSettings.maxBlackHoles)), random(simulationSettings.seed),
+      artifactRandom(random.stream("artifacts")), pirateRandom(random.stream("pirates")),
+      hazardRandom(random.stream("blackHoles")), placementRandom(random.stream("placement")),
+      state(State::Waiting), collectedArtifacts(0), gameTime(0.0), spawnTimer(0.0),
+      indexedTopology(0), indexValid(false),   //первая проверка построит индекс
+      boundsValid(false), minX(0.0), minY(0.0), maxX(0.0), maxY(0.0) {
+    if (settings.requiredArtifacts <= 0) {
+        throw std::invalid_argument("Required artifacts must be positive");
+    }
+    if (settings.maxBlackHoles <= 0) {
+        throw std::invalid_argument("Black hole limit must be positive");
+    }
+    if (settings.blackHoleSpawnPeriod <= 0.0) {
+        throw std::invalid_argument("Black hole spawn period must be positive");
+    }
+}
+
+std::vector<GameEvent> GameSimulation::takeEvents() {
+    std::vector<GameEvent> events;
+    events.swap(pendingEvents);
+    return events;
+}
+
+void GameSimulation::post(GameEvent::Type type, int planet, int otherPlanet, double value) {
+    GameEvent event;
+    event.type = type;
+    event.planet = planet;
+    event.otherPlanet = otherPlanet;
+    if (planet >= 0 && graph.HasVertex(planet)) {
+        event.planetName = graph.GetVertexName(planet);
+    }
+    if (otherPlanet >= 0 && graph.HasVertex(otherPlanet)) {
+        event.otherPlanetName = graph.GetVertexName(otherPlanet);
+    }
+    event.value = value;
+    event.completedRoutes = trader.getCompletedRoutes();
+    event.totalDistance = trader.getTotalDistance();
+    event.gameTime = gameTime;
+    
+    if (eventHandler) {
+        eventHandler(event);
+    } else {
+        pendingEvents.push_back(std::move(event));
+    }
+}
+
+void GameSimulation::reset() {
+    graph.Clear();
+    trader.reset();
+    hazards.clear();
+    positions.clear();
+    
+    state = State::Waiting;
+    collectedArtifacts = 0;
+    gameTime = 0.0;
+    spawnTimer = 0.0;
+    pendingEvents.clear();
+}
+
+void GameSimulation::defeat() {
+    graph.Clear();
+    trader.reset();
+    hazards.clear();
+    positions.clear();
+    
+    state = State::Lost;
+    spawnTimer = 0.0;
+}
+
+bool GameSimulation::placeTraderIfNeeded() {
+    if (trader.getIsPlaced() || graph.GetVertexCount() == 0) {
+        return false;
+    }
+    
+    int planet = graph.GetVertexArray()[0];
+    trader.placeOnPlanet(planet);
+    post(GameEvent::TraderLanded, planet);
+    return true;
+}
+
+bool GameSimulation::checkGameStart() {
+    //после победы новая партия - только на новой карте (reset)
+    if (state == State::Running || state == State::Won) {
+        return false;
+    }
+    if (graph.GetVertexCount() < settings.minPlanetsToStart) {
+        return false;
+    }
+    
+    state = State::Running;
+    collectedArtifacts = 0;
+    gameTime = 0.0;
+    post(GameEvent::GameStarted);
+    
+    spawnArtifact();
+    return true;
+}
+
+bool GameSimulation::spawnArtifact() {
+    if (state != State::Running) {
+        return false;
+    }
+    
+    //на карте одновременно не больше одного артефакта;
+    //планета торговца исключается
+    std::vector<int> available;
+    for (int planet : graph.Vertices()) {
+        if (graph.HasArtifact(planet)) {
+            return false;
+        }
+        if (trader.getIsPlaced() && planet == trader.getCurrentPlanetId()) {
+            continue;
+        }
+        available.push_back(planet);
+    }
+    
+    if (available.empty()) {
+        return false;
+    }
+    
+    int planet = available[artifactRandom.NextBelow(available.size())];
+    graph.SetArtifact(planet, true);
+    post(GameEvent::ArtifactSpawned, planet);
+    return true;
+}
+
+void GameSimulation::collectArtifact(int planet) {
+    graph.SetArtifact(planet, false);
+    collectedArtifacts++;
+    post(GameEvent::ArtifactCollected, planet, -1, collectedArtifacts);
+    
+    //следующий артефакт появляется сразу после сбора
+    if (collectedArtifacts < settings.requiredArtifacts) {
+        spawnArtifact();
+    }
+}
+
+void GameSimulation::advanceTime(double seconds) {
+    if (state == State::Running) {
+        gameTime += seconds;
+    }
+}
+
+bool GameSimulation::travelRoute(const DynamicArray<int>& path, double cost, RouteMetric metric,
+                                 const BattleResolver& resolver) {
+    if (path.GetSize() == 0) {
+        throw std::invalid_argument("Route is empty");
+    }
+    
+    //переходы - те же, что в описании пути (Dijkstra::BestLane)
+    DynamicArray<int> lanes;
+    for (int i = 0; i + 1 < path.GetSize(); i++) {
+        lanes.Append(graph.HasVertex(path[i]) ? Dijkstra::BestLane(graph.GetEdges(path[i]), path[i + 1], metric) : -1);
+    }
+    return travelRoute(path, lanes, cost, resolver);
+}
+
+bool GameSimulation::travelRoute(const DynamicArray<int>& path, const DynamicArray<int>& lanes, double cost,
+                                 const BattleResolver& resolver) {
+    if (path.GetSize() == 0) {
+        throw std::invalid_argument("Route is empty");
+    }
+    if (lanes.GetSize() != path.GetSize() - 1) {
+        throw std::invalid_argument("Route needs one lane per jump");
+    }
+    
+    //═══ нападения пиратов ═══
+    //reached - последняя достигнутая планета пути: пока окно показывало битву, часы карты шли,
+    //и черные дыры могли поглотить планеты или переходы дальше по маршруту
+    int reached = 0;
+    for (int i = 0; i + 1 < path.GetSize(); i++) {
+        int from = path[i];
+        int to = path[i + 1];
+        if (!graph.HasVertex(from) || !graph.HasVertex(to)) {
+            break;
+        }
+        
+        const DynamicArray<Edge>& edges = graph.GetEdges(from);
+        int lane = lanes[i];
+        if (lane < 0 || lane >= edges.GetSize() || edges[lane].to != to) {
+            break;
+        }
+        
+        double risk = edges[lane].data.riskFactor;
+        if (pirateRandom.NextDouble() < risk) {
+            post(GameEvent::PirateAttack, from, to, risk);
+            
+            bool victory = resolver
+                ? resolver(from, to, risk)
+                : pirateRandom.NextDouble() < PirateModel::victoryProbability(PirateModel::determinePirateType(risk),
+                                                              settings.clicksPerSecond);
+            //пока окно показывало битву, часы карты шли - торговец мог погибнуть в черной дыре
+            if (state == State::Lost && !trader.getIsPlaced()) {
+                return false;
+            }
+            if (!victory) {
+                post(GameEvent::DestroyedByPirates, from, to, risk);
+                defeat();
+                return false;
+            }
+            post(GameEvent::PiratesRepelled, from, to, risk);
+            if (!graph.HasVertex(to)) {
+                break;
+            }
+        }
+        reached = i + 1;
+    }
+    
+    //═══ прибытие ═══
+    int destination = path[reached];
+    trader.setCurrentPlanet(destination);
+    
+    //артефакты собираются на всех пройденных планетах пути
+    for (int i = 0; i <= reached; i++) {
+        if (state == State::Running && graph.HasVertex(path[i]) && graph.HasArtifact(path[i])) {
+            collectArtifact(path[i]);
+        }
+    }
+    if (reached + 1 < path.GetSize()) {
+        post(GameEvent::RouteInterrupted, destination, path[reached + 1]);
+    } else {
+        trader.completeRoute(static_cast<int>(cost));
+        post(GameEvent::Arrived, destination);
+    }
+    
+    if (state == State::Running && collectedArtifacts >= settings.requiredArtifacts) {
+        state = State::Won;
+        post(GameEvent::Victory, -1, -1, gameTime);
+    }
+    return true;
+}
+
+bool GameSimulation::swallowPlanet(int planet) {
+    if (!graph.HasVertex(planet)) {
+        return false;
+    }
+    
+    if (trader.getIsPlaced() && trader.getCurrentPlanetId() == planet) {
+        post(GameEvent::DestroyedByBlackHole, planet);
+        defeat();
+        return true;
+    }
+    
+    post(GameEvent::PlanetSwallowed, planet);
+    bool hadArtifact = graph.HasArtifact(planet);
+    
+    //собственное изменение карты: индекс правится по элементу, а не перестраивается
+    bool synced = isIndexSynced();
+    if (synced) {
+        unindexPlanet(planet);
+    }
+    graph.RemoveVertex(planet);
+    positions.erase(planet);
+    if (synced) {
+        indexedTopology = graph.GetTopologyVersion();
+    }
+    
+    //поглощённый артефакт заменяется новым, иначе партию не закончить
+    if (hadArtifact) {
+        spawnArtifact();
+    }
+    return false;
+}
+
+bool GameSimulation::swallowLane(int from, int to) {
+    if (!graph.HasVertex(from) || !graph.HasVertex(to)) {
+        return false;
+    }
+    
+    const DynamicArray<Edge>& edges = graph.GetEdges(from);
+    bool exists = false;
+    for (int i = 0; i < edges.GetSize() && !exists; i++) {
+        exists = edges[i].to == to;
+    }
+    if (!exists) {
+        return false;
+    }
+    
+    post(GameEvent::LaneSwallowed, from, to);
+    bool synced = isIndexSynced();
+    graph.RemoveEdge(from, to);
+    if (synced) {
+        unindexLane(from, to);
+        indexedTopology = graph.GetTopologyVersion();
+    }
+    return true;
+}
+
+int GameSimulation::spawnBlackHole(double x, double y, double velocityX, double velocityY) {
+    if (graph.GetVertexCount() == 0 || hazards.getActiveCount() >= settings.maxBlackHoles) {
+        return -1;
+    }
+    
+    int slot = hazards.spawn(x, y, velocityX, velocityY, settings.blackHoleRadius);
+    post(GameEvent::BlackHoleSpawned);
+    return slot;
+}
+
+//═══ безоконный режим ═══
+
+void GameSimulation::setPlanetPosition(int planet, double x, double y) {
+    if (!graph.HasVertex(planet)) {
+        throw std::invalid_argument("Planet does not exist");
+    }
+    
+    auto it = positions.find(planet);
+    if (it == positions.end()) {
+        //первые координаты: отрезки к соседям ещё не в индексе - он перестроится при следующей проверке
+        positions[planet] = Position{x, y};
+        indexValid = false;
+        boundsValid = false;
+        return;
+    }
+    
+    if (boundsValid && onBounds(it->second)) {
+        boundsValid = false;
+    }
+    it->second = Position{x, y};
+    if (boundsValid) {
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+    }
+    
+    if (isIndexSynced()) {
+        planetGrid.Move(planet, x, y);
+        for (long long key : planetLanes[planet]) {
+            indexLane(static_cast<int>(static_cast<unsigned long long>(key) >> 32),
+                      static_cast<int>(static_cast<unsigned int>(key)));
+        }
+    }
+}
+
+void GameSimulation::scatterPlanets(double width, double height) {
+    for (int planet : graph.Vertices()) {
+        if (positions.find(planet) == positions.end()) {
+            double x = placementRandom.NextDouble() * width;
+            double y = placementRandom.NextDouble() * height;
+            positions[planet] = Position{x, y};
+            indexValid = false;
+            boundsValid = false;
+        }
+    }
+}
+
+long long GameSimulation::laneKey(int from, int to) {
+    return static_cast<long long>((static_cast<unsigned long long>(static_cast<unsigned int>(from)) << 32) |
+                                  static_cast<unsigned int>(to));
+}
+
+void GameSimulation::syncIndex() {
+    if (isIndexSynced()) {
+        return;
+    }
+    
+    planetGrid.Clear();
+    laneGrid.Clear();
+    planetLanes.clear();
+    for (int planet : graph.Vertices()) {
+        auto it = positions.find(planet);
+        if (it != positions.end()) {
+            planetGrid.Insert(planet, it->second.x, it->second.y);
+        }
+    }
+    for (int from : graph.Vertices()) {
+        const DynamicArray<Edge>& edges = graph.GetEdges(from);
+        for (int i = 0; i < edges.GetSize(); i++) {
+            indexLane(from, edges[i].to);
+        }
+    }
+    
+    indexedTopology = graph.GetTopologyVersion();
+    indexValid = true;
+    boundsValid = false;
+}
+
+void GameSimulation::indexLane(int from, int to) {
+    auto a = positions.find(from);
+    auto b = positions.find(to);
+    if (a == positions.end() || b == positions.end()) {
+        return;
+    }
+    
+    //параллельные рёбра - один отрезок; повторная вставка только сдвигает его
+    long long key = laneKey(from, to);
+    bool known = laneGrid.Contains(key);
+    laneGrid.InsertBox(key, a->second.x, a->second.y, b->second.x, b->second.y);
+    if (!known) {
+        planetLanes[from].push_back(key);
+        planetLanes[to].push_back(key);
+    }
+}
+
+void GameSimulation::unindexLane(int from, int to) {
+    long long key = laneKey(from, to);
+    if (!laneGrid.Contains(key)) {
+        return;
+    }
+    laneGrid.Remove(key);
+    for (int planet : {from, to}) {
+        std::vector<long long>& lanes = planetLanes[planet];
+        lanes.erase(std::remove(lanes.begin(), lanes.end(), key), lanes.end());
+    }
+}
+
+void GameSimulation::unindexPlanet(int planet) {
+    //копия: unindexLane изменяет planetLanes
+    auto it = planetLanes.find(planet);
+    if (it != planetLanes.end()) {
+        const std::vector<long long> lanes = it->second;
+        for (long long key : lanes) {
+            unindexLane(static_cast<int>(static_cast<unsigned long long>(key) >> 32),
+                        static_cast<int>(static_cast<unsigned int>(key)));
+        }
+        planetLanes.erase(planet);
+    }
+    planetGrid.Remove(planet);
+    
+    auto position = positions.find(planet);
+    if (position != positions.end() && onBounds(position->second)) {
+        boundsValid = false;
+    }
+}
+
+bool GameSimulation::onBounds(const Position& position) const {
+    return position.x <= minX || position.x >= maxX || position.y <= minY || position.y >= maxY;
+}
+
+bool GameSimulation::syncBounds() {
+    syncIndex();
+    if (planetGrid.GetSize() == 0) {
+        return false;
+    }
+    if (boundsValid) {
+        return true;
+    }
+    
+    bool first = true;
+    for (int planet : graph.Vertices()) {
+        auto it = positions.find(planet);
+        if (it == positions.end()) {
+            continue;
+        }
+        const Position& position = it->second;
+        minX = first ? position.x : std::min(minX, position.x);
+        maxX = first ? position.x : std::max(maxX, position.x);
+        minY = first ? position.y : std::min(minY, position.y);
+        maxY = first ? position.y : std::max(maxY, position.y);
+        first = false;
+    }
+    boundsValid = true;
+    return true;
+}
+
+void GameSimulation::spawnAtEdge() {
+    if (!syncBounds()) {
+        return;
+    }
+    
+    //как в окне: за левым или правым краем карты, поперёк неё
+    double y = hazardRandom.NextRange(minY, maxY);
+    double speed = hazardRandom.NextRange(7.5, 12.5);
+    double drift = hazardRandom.NextRange(-1.0, 1.0);
+    if (hazardRandom.NextDouble() < 0.5) {
+        spawnBlackHole(minX - 100.0, y, speed, drift);
+    } else {
+        spawnBlackHole(maxX + 100.0, y, -speed, drift);
+    }
+}
+
+bool GameSimulation::collidePlanets() {
+    syncIndex();
+    
+    for (int slot : hazards.getActiveSlots()) {
+        //кандидаты - планеты из ячеек вокруг пути дыры за шаг
+        double reach = hazards.getRadius(slot) + settings.planetRadius;
+        double previousX = hazards.getPreviousX(slot), previousY = hazards.getPreviousY(slot);
+        double x = hazards.getX(slot), y = hazards.getY(slot);
+        candidatePlanets.clear();
+        candidateX.clear();
+        candidateY.clear();
+        planetGrid.ForEachInBox(std::min(previousX, x) - reach, std::min(previousY, y) - reach,
+                                std::max(previousX, x) + reach, std::max(previousY, y) + reach,
+                                [this](int planet) {
+            const Position& position = positions.at(planet);
+            candidatePlanets.push_back(planet);
+            candidateX.push_back(position.x);
+            candidateY.push_back(position.y);
+        });
+        
+        hits.clear();
+        hazards.collidePoints(slot, candidateX.data(), candidateY.data(),
+                              static_cast<int>(candidatePlanets.size()), settings.planetRadius, hits);
+        for (int hit : hits) {
+            //планета могла исчезнуть в другой дыре на этом же шаге
+            if (swallowPlanet(candidatePlanets[hit])) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void GameSimulation::collideLanes() {
+    syncIndex();
+    
+    for (int slot : hazards.getActiveSlots()) {
+        //кандидаты - отрезки, чьи габариты задевают диск, заметённый дырой за шаг
+        double radius = hazards.getRadius(slot);
+        double previousX = hazards.getPreviousX(slot), previousY = hazards.getPreviousY(slot);
+        double x = hazards.getX(slot), y = hazards.getY(slot);
+        candidateLanes.clear();
+        candidateX.clear();
+        candidateY.clear();
+        candidateEndX.clear();
+        candidateEndY.clear();
+        laneGrid.ForEachInBox(std::min(previousX, x) - radius, std::min(previousY, y) - radius,
+                              std::max(previousX, x) + radius, std::max(previousY, y) + radius,
+                              [this](long long key) {
+            const Position& a = positions.at(static_cast<int>(static_cast<unsigned long long>(key) >> 32));
+            const Position& b = positions.at(static_cast<int>(static_cast<unsigned int>(key)));
+            candidateLanes.push_back(key);
+            candidateX.push_back(a.x);
+            candidateY.push_back(a.y);
+            candidateEndX.push_back(b.x);
+            candidateEndY.push_back(b.y);
+        });
+        
+        hits.clear();
+        hazards.collideSegments(slot, candidateX.data(), candidateY.data(),
+                                candidateEndX.data(), candidateEndY.data(),
+                                static_cast<int>(candidateLanes.size()), hits);
+        for (int hit : hits) {
+            long long key = candidateLanes[hit];
+            swallowLane(static_cast<int>(static_cast<unsigned long long>(key) >> 32),
+                        static_cast<int>(static_cast<unsigned int>(key)));
+        }
+    }
+}
+
+void GameSimulation::releaseExited() {
+    syncBounds();   //без планет - последние известные границы
+    
+    //дыры, пересёкшие карту и ушедшие за противоположный край
+    std::vector<int> exited;
+    for (int slot : hazards.getActiveSlots()) {
+        double x = hazards.getX(slot);
+        double velocityX = hazards.getVelocityX(slot);
+        if ((velocityX > 0 && x > maxX + 200.0) || (velocityX < 0 && x < minX - 200.0)) {
+            exited.push_back(slot);
+        }
+    }
+    for (int slot : exited) {
+        hazards.release(slot);
+        post(GameEvent::BlackHoleLeft);
+    }
+}
+
+void GameSimulation::step(double deltaTime) {
+    advanceTime(deltaTime);
+    
+    spawnTimer += deltaTime;
+    while (spawnTimer >= settings.blackHoleSpawnPeriod) {
+        spawnTimer -= settings.blackHoleSpawnPeriod;
+        spawnAtEdge();
+    }
+    
+    if (hazards.getActiveCount() == 0) {
+        return;
+    }
+    
+    expired.clear();
+    hazards.update(deltaTime, &expired);
+    for (size_t i = 0; i < expired.size(); i++) {
+        post(GameEvent::BlackHoleLeft);
+    }
+    
+    if (collidePlanets()) {
+        return;
+    }
+    collideLanes();
+    releaseExited();
+}
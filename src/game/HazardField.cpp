@@ -0,0 +1,206 @@
+#include "HazardField.h"
+#include <algorithm>
+#include <stdexcept>
+
+//═══════════════════════════════════════════════════════════
+//HazardField implementation
+//═══════════════════════════════════════════════════════════
+
+//квадрат расстояния от точки до отрезка; без ветвлений (clamp через min/max)
+static inline double pointSegmentDistanceSquared(double px, double py,
+                                                 double ax, double ay, double bx, double by) {
+    double abX = bx - ax, abY = by - ay;
+    double lengthSquared = abX * abX + abY * abY;
+    //вырожденный отрезок: скалярное произведение 0, t = 0
+    double t = ((px - ax) * abX + (py - ay) * abY) / (lengthSquared > 1e-12 ? lengthSquared : 1e-12);
+    t = t < 0.0 ? 0.0 : (t > 1.0 ? 1.0 : t);
+    double dx = px - (ax + abX * t);
+    double dy = py - (ay + abY * t);
+    return dx * dx + dy * dy;
+}
+
+//маска 0/1 после begin -> индексы ненулевых элементов (на месте)
+static void compressMask(std::vector<int>& hits, size_t begin) {
+    size_t written = begin;
+    for (size_t i = begin; i < hits.size(); i++) {
+        if (hits[i]) {
+            hits[written++] = static_cast<int>(i - begin);
+        }
+    }
+    hits.resize(written);
+}
+
+static inline double cross(double ox, double oy, double ax, double ay, double bx, double by) {
+    return (ax - ox) * (by - oy) - (ay - oy) * (bx - ox);
+}
+
+//═══ векторные ядра: restrict-параметры - массивы не пересекаются ═══
+
+static void advanceColumns(double* __restrict x, double* __restrict y,
+                           double* __restrict previousX, double* __restrict previousY,
+                           double* __restrict age, const double* __restrict velocityX,
+                           const double* __restrict velocityY, const double* __restrict alive,
+                           int count, double deltaTime) {
+    for (int i = 0; i < count; i++) {
+        previousX[i] = x[i];
+        previousY[i] = y[i];
+        x[i] += velocityX[i] * deltaTime;
+        y[i] += velocityY[i] * deltaTime;
+        age[i] += deltaTime * alive[i];
+    }
+}
+
+//точки ближе reach к пути дыры за шаг (p -> q): при большом шаге дыра не перепрыгивает планету
+static void pointMask(const double* __restrict xs, const double* __restrict ys, int count,
+                      double px, double py, double qx, double qy, double reachSquared,
+                      int* __restrict mask) {
+    for (int i = 0; i < count; i++) {
+        mask[i] = pointSegmentDistanceSquared(xs[i], ys[i], px, py, qx, qy) <= reachSquared;
+    }
+}
+
+static void segmentMask(const double* __restrict ax, const double* __restrict ay,
+                        const double* __restrict bx, const double* __restrict by, int count,
+                        double px, double py, double qx, double qy, double radiusSquared,
+                        int* __restrict mask) {
+    for (int i = 0; i < count; i++) {
+        //пересекающиеся отрезки (концы каждого лежат по разные стороны другого)
+        double d1 = cross(ax[i], ay[i], bx[i], by[i], px, py);
+        double d2 = cross(ax[i], ay[i], bx[i], by[i], qx, qy);
+        double d3 = cross(px, py, qx, qy, ax[i], ay[i]);
+        double d4 = cross(px, py, qx, qy, bx[i], by[i]);
+        int crossing = (d1 * d2 < 0.0) & (d3 * d4 < 0.0);
+        
+        //иначе - хотя бы один конец ближе радиуса к другому отрезку
+        int near = (pointSegmentDistanceSquared(px, py, ax[i], ay[i], bx[i], by[i]) <= radiusSquared) |
+                   (pointSegmentDistanceSquared(qx, qy, ax[i], ay[i], bx[i], by[i]) <= radiusSquared) |
+                   (pointSegmentDistanceSquared(ax[i], ay[i], px, py, qx, qy) <= radiusSquared) |
+                   (pointSegmentDistanceSquared(bx[i], by[i], px, py, qx, qy) <= radiusSquared);
+        
+        mask[i] = crossing | near;
+    }
+}
+
+HazardField::HazardField(int initialCapacity) {
+    if (initialCapacity < 0) {
+        throw std::invalid_argument("Hazard capacity cannot be negative");
+    }
+    grow(initialCapacity);
+}
+
+void HazardField::grow(int capacity) {
+    int old = getCapacity();
+    if (capacity <= old) {
+        return;
+    }
+    
+    for (std::vector<double>* column : {&x, &y, &previousX, &previousY, &velocityX, &velocityY,
+                                        &radius, &age, &lifetime, &alive}) {
+        column->resize(capacity, 0.0);
+    }
+    activeIndex.resize(capacity, -1);
+    
+    //новые слоты - в список свободных, младшие выдаются первыми
+    for (int slot = capacity - 1; slot >= old; slot--) {
+        freeSlots.push_back(slot);
+    }
+}
+
+void HazardField::checkSlot(int slot) const {
+    if (!isActive(slot)) {
+        throw std::invalid_argument("Hazard slot is not active");
+    }
+}
+
+bool HazardField::isActive(int slot) const {
+    return slot >= 0 && slot < getCapacity() && activeIndex[slot] != -1;
+}
+
+int HazardField::spawn(double px, double py, double vx, double vy, double hazardRadius, double hazardLifetime) {
+    if (hazardRadius <= 0.0) {
+        throw std::invalid_argument("Hazard radius must be positive");
+    }
+    
+    if (freeSlots.empty()) {
+        grow(std::max(16, getCapacity() * 2));
+    }
+    int slot = freeSlots.back();
+    freeSlots.pop_back();
+    
+    x[slot] = previousX[slot] = px;
+    y[slot] = previousY[slot] = py;
+    velocityX[slot] = vx;
+    velocityY[slot] = vy;
+    radius[slot] = hazardRadius;
+    age[slot] = 0.0;
+    lifetime[slot] = hazardLifetime;
+    alive[slot] = 1.0;
+    
+    activeIndex[slot] = static_cast<int>(active.size());
+    active.push_back(slot);
+    return slot;
+}
+
+void HazardField::release(int slot) {
+    checkSlot(slot);
+    
+    //на место освобождённого в плотном списке встаёт последний
+    int position = activeIndex[slot];
+    int last = active.back();
+    active[position] = last;
+    activeIndex[last] = position;
+    active.pop_back();
+    activeIndex[slot] = -1;
+    
+    alive[slot] = 0.0;
+    velocityX[slot] = velocityY[slot] = 0.0;
+    freeSlots.push_back(slot);
+}
+
+void HazardField::clear() {
+    while (!active.empty()) {
+        release(active.back());
+    }
+}
+
+void HazardField::update(double deltaTime, std::vector<int>* expired) {
+    //═══ движение всех слотов одним циклом; свободные стоят на месте (маска alive) ═══
+    advanceColumns(x.data(), y.data(), previousX.data(), previousY.data(), age.data(),
+                   velocityX.data(), velocityY.data(), alive.data(), getCapacity(), deltaTime);
+    
+    //═══ истекшие - обратно в пул ═══
+    for (int k = static_cast<int>(active.size()) - 1; k >= 0; k--) {
+        int slot = active[k];
+        if (age[slot] >= lifetime[slot]) {
+            if (expired) {
+                expired->push_back(slot);
+            }
+            release(slot);
+        }
+    }
+}
+
+void HazardField::collidePoints(int slot, const double* xs, const double* ys, int count,
+                                double margin, std::vector<int>& hits) const {
+    checkSlot(slot);
+    const double reach = radius[slot] + margin;
+    
+    //первый проход (векторный) - маска попаданий, второй - сжатие в индексы
+    size_t begin = hits.size();
+    hits.resize(begin + count);
+    pointMask(xs, ys, count, previousX[slot], previousY[slot], x[slot], y[slot], reach * reach,
+              hits.data() + begin);
+    compressMask(hits, begin);
+}
+
+void HazardField::collideSegments(int slot, const double* ax, const double* ay,
+                                  const double* bx, const double* by, int count,
+                                  std::vector<int>& hits) const {
+    checkSlot(slot);
+    //путь дыры за последний шаг - тоже отрезок
+    size_t begin = hits.size();
+    hits.resize(begin + count);
+    segmentMask(ax, ay, bx, by, count, previousX[slot], previousY[slot], x[slot], y[slot],
+                radius[slot] * radius[slot], hits.data() + begin);
+    compressMask(hits, begin);
+}
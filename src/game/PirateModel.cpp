@@ -0,0 +1,46 @@
+#include "PirateModel.h"
+#include <cmath>
+
+//═══════════════════════════════════════════════════════════
+//PirateModel implementation
+//═══════════════════════════════════════════════════════════
+
+PirateType PirateModel::determinePirateType(double risk) {
+    if (risk < 0.25) {
+        return PirateType::ROOKIE;
+    } else if (risk <= 0.4) {
+        return PirateType::VETERAN;
+    } else {
+        return PirateType::BOSS;
+    }
+}
+
+PirateModel::Profile PirateModel::profile(PirateType type) {
+    switch (type) {
+        case PirateType::ROOKIE:
+            return Profile{5, 50};    //5 секунд
+        case PirateType::VETERAN:
+            return Profile{10, 50};   //5 секунд
+        case PirateType::BOSS:
+        default:
+            return Profile{15, 40};   //4 секунды
+    }
+}
+
+double PirateModel::victoryProbability(PirateType type, double clicksPerSecond) {
+    if (clicksPerSecond <= 0.0) {
+        return 0.0;
+    }
+    
+    Profile battle = profile(type);
+    double expected = clicksPerSecond * battle.battleTime / 10.0;
+    
+    //P(попаданий < required) = сумма пуассоновских вероятностей 0..required-1
+    double term = std::exp(-expected);
+    double defeat = 0.0;
+    for (int k = 0; k < battle.requiredClicks; k++) {
+        defeat += term;
+        term *= expected / (k + 1);
+    }
+    return defeat >= 1.0 ? 0.0 : 1.0 - defeat;
+}
@@ -0,0 +1,49 @@
+#include "RandomService.h"
+#include <stdexcept>
+
+//═══════════════════════════════════════════════════════════
+//RandomService implementation
+//═══════════════════════════════════════════════════════════
+
+RandomService::RandomService(uint64_t masterSeed) : seed(masterSeed) {}
+
+uint64_t RandomService::streamSeed(uint64_t seed, const std::string& name) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (unsigned char symbol : name) {
+        hash = (hash ^ symbol) * 0x100000001B3ULL;
+    }
+    
+    //перемешивание, чтобы близкие seed и похожие имена давали далёкие состояния
+    uint64_t key = seed ^ Xoshiro256::SplitMix64(hash);
+    return Xoshiro256::SplitMix64(key);
+}
+
+void RandomService::reseed(uint64_t newSeed) {
+    seed = newSeed;
+    for (auto& entry : streams) {
+        entry.second.Seed(streamSeed(seed, entry.first));
+    }
+}
+
+Xoshiro256& RandomService::stream(const std::string& name) {
+    auto it = streams.find(name);
+    if (it == streams.end()) {
+        it = streams.emplace(name, Xoshiro256(streamSeed(seed, name))).first;
+    }
+    return it->second;
+}
+
+std::vector<Xoshiro256> RandomService::parallelStreams(const std::string& name, int count) const {
+    if (count < 0) {
+        throw std::invalid_argument("Stream count must be non-negative");
+    }
+    
+    std::vector<Xoshiro256> result;
+    result.reserve(count);
+    Xoshiro256 current(streamSeed(seed, name));
+    for (int i = 0; i < count; i++) {
+        result.push_back(current);
+        current.Jump();
+    }
+    return result;
+}
@@ -0,0 +1,183 @@
+#include "RouteRiskSimulator.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+//═══════════════════════════════════════════════════════════
+//RouteRiskSimulator implementation
+//═══════════════════════════════════════════════════════════
+
+static const uint64_t GOLDEN_GAMMA = 0x9E3779B97F4A7C15ULL;
+
+//финализатор SplitMix64: биективное перемешивание 64 бит
+static inline uint64_t mix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+RouteRiskReport::RouteRiskReport()
+    : voyages(0), survived(0), survivalProbability(0.0), survivalStdError(0.0), meanEncounters(0.0),
+      expectedLoss(0.0), lossStdDev(0.0), lossMedian(0.0), lossP90(0.0), lossP99(0.0) {}
+
+RouteRiskSimulator::Settings::Settings()
+    : voyages(1000000), threadCount(0), seed(42), clicksPerSecond(3.0), cargoValue(100.0), battleCost(10.0) {}
+
+RouteRiskSimulator::RouteRiskSimulator(const Settings& simulatorSettings) : settings(simulatorSettings) {
+    if (settings.voyages <= 0) {
+        throw std::invalid_argument("Number of voyages must be positive");
+    }
+    if (settings.threadCount <= 0) {
+        settings.threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+double RouteRiskSimulator::uniformAt(uint64_t stream, uint64_t counter) {
+    //53 старших бита -> [0, 1)
+    return (mix64(stream + counter * GOLDEN_GAMMA) >> 11) * 0x1.0p-53;
+}
+
+double RouteRiskSimulator::exactSurvival(const std::vector<double>& laneRisks) const {
+    double survival = 1.0;
+    for (double risk : laneRisks) {
+        double defeat = 1.0 - PirateModel::victoryProbability(PirateModel::determinePirateType(risk),
+                                                              settings.clicksPerSecond);
+        survival *= 1.0 - risk * defeat;
+    }
+    return survival;
+}
+
+std::vector<double> RouteRiskSimulator::laneRisks(const StarGraph& graph, const DynamicArray<int>& path,
+                                                  RouteMetric metric) {
+    std::vector<double> risks;
+    for (int i = 0; i + 1 < path.GetSize(); i++) {
+        const DynamicArray<Edge>& edges = graph.GetEdges(path[i]);
+        int lane = Dijkstra::BestLane(edges, path[i + 1], metric);
+        if (lane >= 0) {
+            risks.push_back(edges[lane].data.riskFactor);
+        }
+    }
+    return risks;
+}
+
+RouteRiskReport RouteRiskSimulator::simulate(const StarGraph& graph, const DynamicArray<int>& path,
+                                             RouteMetric metric) const {
+    return simulate(laneRisks(graph, path, metric));
+}
+
+RouteRiskReport RouteRiskSimulator::simulate(const std::vector<double>& laneRisks) const {
+    int lanes = static_cast<int>(laneRisks.size());
+    
+    //вероятность проиграть битву на каждом переходе считается один раз
+    std::vector<double> defeat(lanes);
+    for (int i = 0; i < lanes; i++) {
+        defeat[i] = 1.0 - PirateModel::victoryProbability(PirateModel::determinePirateType(laneRisks[i]),
+                                                          settings.clicksPerSecond);
+    }
+    
+    //исход рейса - (где погиб: 0 - долетел, i + 1 - на переходе i; число встреч)
+    //таблица исходов (lanes + 1) x (lanes + 1) у каждого потока своя
+    int width = lanes + 1;
+    int threads = static_cast<int>(std::min<long long>(settings.threadCount, settings.voyages));
+    std::vector<std::vector<long long>> tables(threads, std::vector<long long>(width * width, 0));
+    
+    auto worker = [&](int thread) {
+        long long begin = settings.voyages * thread / threads;
+        long long end = settings.voyages * (thread + 1) / threads;
+        std::vector<long long>& table = tables[thread];
+        
+        for (long long voyage = begin; voyage < end; voyage++) {
+            //поток случайных чисел рейса: бросок 2i - встреча на переходе i, 2i + 1 - исход битвы
+            uint64_t stream = mix64(settings.seed ^ mix64(static_cast<uint64_t>(voyage) + GOLDEN_GAMMA));
+            int encounters = 0;
+            int outcome = 0;
+            for (int i = 0; i < lanes; i++) {
+                if (uniformAt(stream, 2 * i) < laneRisks[i]) {
+                    encounters++;
+                    if (uniformAt(stream, 2 * i + 1) < defeat[i]) {
+                        outcome = i + 1;
+                        break;
+                    }
+                }
+            }
+            table[outcome * width + encounters]++;
+        }
+    };
+    
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; t++) {
+        workers.emplace_back(worker, t);
+    }
+    worker(0);
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+    
+    std::vector<long long> table(width * width, 0);
+    for (const std::vector<long long>& local : tables) {
+        for (int i = 0; i < width * width; i++) {
+            table[i] += local[i];
+        }
+    }
+    
+    //═══ сводка по таблице исходов ═══
+    RouteRiskReport report;
+    report.voyages = settings.voyages;
+    report.encounterHistogram.assign(width, 0);
+    report.destroyedAtLane.assign(lanes, 0.0);
+    
+    double total = static_cast<double>(settings.voyages);
+    double encounterSum = 0.0;
+    std::vector<std::pair<double, long long>> losses;   //(потеря, число рейсов)
+    for (int outcome = 0; outcome < width; outcome++) {
+        for (int encounters = 0; encounters < width; encounters++) {
+            long long count = table[outcome * width + encounters];
+            if (count == 0) {
+                continue;
+            }
+            report.encounterHistogram[encounters] += count;
+            encounterSum += static_cast<double>(encounters) * count;
+            if (outcome == 0) {
+                report.survived += count;
+            } else {
+                report.destroyedAtLane[outcome - 1] += count / total;
+            }
+            double loss = (outcome > 0 ? settings.cargoValue : 0.0) + settings.battleCost * encounters;
+            losses.push_back(std::make_pair(loss, count));
+        }
+    }
+    
+    report.survivalProbability = report.survived / total;
+    report.survivalStdError = std::sqrt(report.survivalProbability * (1.0 - report.survivalProbability) / total);
+    report.meanEncounters = encounterSum / total;
+    
+    double lossSum = 0.0;
+    double lossSquares = 0.0;
+    for (const auto& loss : losses) {
+        lossSum += loss.first * loss.second;
+        lossSquares += loss.first * loss.first * loss.second;
+    }
+    report.expectedLoss = lossSum / total;
+    report.lossStdDev = std::sqrt(std::max(0.0, lossSquares / total - report.expectedLoss * report.expectedLoss));
+    
+    //процентили по дискретному распределению потерь
+    std::sort(losses.begin(), losses.end());
+    auto percentile = [&](double fraction) {
+        long long needed = static_cast<long long>(std::ceil(fraction * total));
+        long long seen = 0;
+        for (const auto& loss : losses) {
+            seen += loss.second;
+            if (seen >= needed) {
+                return loss.first;
+            }
+        }
+        return losses.empty() ? 0.0 : losses.back().first;
+    };
+    report.lossMedian = percentile(0.5);
+    report.lossP90 = percentile(0.9);
+    report.lossP99 = percentile(0.99);
+    
+    return report;
+}
@@ -0,0 +1,135 @@
+#include "SimulationClock.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+static const double PERIOD_EPSILON = 1e-9;     //погрешность накопления шагов
+
+//═══════════════════════════════════════════════════════════
+//SimulationClock implementation
+//═══════════════════════════════════════════════════════════
+
+SimulationClock::SimulationClock(double step, int maxSteps)
+    : nextId(0), timestep(step), maxStepsPerAdvance(maxSteps),
+      accumulator(0.0), timeScale(1.0), time(0.0), stepCount(0) {
+    if (timestep <= 0.0) {
+        throw std::invalid_argument("Simulation timestep must be positive");
+    }
+    if (maxStepsPerAdvance <= 0) {
+        throw std::invalid_argument("Max steps per advance must be positive");
+    }
+}
+
+SimulationClock::Entry& SimulationClock::find(int id) {
+    for (auto& entry : systems) {
+        if (entry->id == id && !entry->removed) {
+            return *entry;
+        }
+    }
+    throw std::invalid_argument("Unknown simulation system");
+}
+
+const SimulationClock::Entry& SimulationClock::find(int id) const {
+    for (const auto& entry : systems) {
+        if (entry->id == id && !entry->removed) {
+            return *entry;
+        }
+    }
+    throw std::invalid_argument("Unknown simulation system");
+}
+
+int SimulationClock::addSystem(const std::string& name, double period, System system, bool enabled) {
+    if (!system) {
+        throw std::invalid_argument("Simulation system must be callable");
+    }
+    
+    std::unique_ptr<Entry> entry(new Entry{nextId++, name, period, 0.0, enabled, false, std::move(system)});
+    systems.push_back(std::move(entry));
+    return systems.back()->id;
+}
+
+void SimulationClock::removeSystem(int id) {
+    //физически удаляется после шага - система может удалить сама себя
+    find(id).removed = true;
+}
+
+void SimulationClock::setEnabled(int id, bool enabled) {
+    find(id).enabled = enabled;
+}
+
+bool SimulationClock::isEnabled(int id) const {
+    return find(id).enabled;
+}
+
+void SimulationClock::restartSystem(int id) {
+    Entry& entry = find(id);
+    entry.enabled = true;
+    entry.elapsed = 0.0;
+}
+
+const std::string& SimulationClock::getSystemName(int id) const {
+    return find(id).name;
+}
+
+void SimulationClock::setTimeScale(double scale) {
+    if (scale <= 0.0) {
+        throw std::invalid_argument("Time scale must be positive");
+    }
+    timeScale = scale;
+}
+
+void SimulationClock::step() {
+    time += timestep;
+    stepCount++;
+    
+    //системы, добавленные во время шага, начнут работать со следующего
+    const size_t count = systems.size();
+    for (size_t i = 0; i < count; i++) {
+        Entry& entry = *systems[i];
+        if (!entry.enabled || entry.removed) {
+            continue;
+        }
+        
+        if (entry.period <= 0.0) {
+            entry.system(timestep);
+            continue;
+        }
+        
+        //период короче шага - система срабатывает несколько раз
+        entry.elapsed += timestep;
+        while (entry.enabled && !entry.removed && entry.elapsed + PERIOD_EPSILON >= entry.period) {
+            entry.elapsed -= entry.period;
+            entry.system(entry.period);
+        }
+    }
+    
+    systems.erase(std::remove_if(systems.begin(), systems.end(),
+                                 [](const std::unique_ptr<Entry>& entry) { return entry->removed; }),
+                  systems.end());
+}
+
+int SimulationClock::advance(double realSeconds) {
+    accumulator += std::max(0.0, realSeconds) * timeScale;
+    
+    int steps = 0;
+    while (accumulator + PERIOD_EPSILON >= timestep && steps < maxStepsPerAdvance) {
+        step();
+        accumulator -= timestep;
+        steps++;
+    }
+    
+    //не успеваем за реальным временем - отбрасываем отставание,
+    //иначе каждый следующий кадр будет считать всё больше шагов
+    if (accumulator >= timestep) {
+        accumulator = std::fmod(accumulator, timestep);
+    }
+    accumulator = std::max(0.0, accumulator);
+    return steps;
+}
+
+void SimulationClock::runFor(double simulatedSeconds) {
+    long long steps = static_cast<long long>(std::floor(simulatedSeconds / timestep + PERIOD_EPSILON));
+    for (long long i = 0; i < steps; i++) {
+        step();
+    }
+}
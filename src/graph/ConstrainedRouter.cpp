@@ -0,0 +1,205 @@
+#include "ConstrainedRouter.h"
+#include "PriorityQueue.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+static const double INF = std::numeric_limits<double>::infinity();
+static const double BUDGET_EPSILON = 1e-12;   //погрешность сложения при сравнении с лимитом
+
+//constrainedResult реализация
+ConstrainedResult::ConstrainedResult() : budget(0.0), consumed(0.0) {}
+
+//constrainedRouter реализация
+ConstrainedRouter::ConstrainedRouter(const StarGraph& g) : graph(g), lastLabelCount(0) {}
+
+double ConstrainedRouter::edgeResource(const EdgeData& data, Resource resource) {
+    return resource == Risk ? data.survivalCost : 1.0;
+}
+
+std::unordered_map<int, double> ConstrainedRouter::resourceToTarget(int end, Resource resource) const {
+    if (resource == Risk) {
+        return Dijkstra(graph).FindAllShortestPathsTo(end, RouteMetric::Survival);
+    }
+    
+    //переходы: обход в ширину по входящим рёбрам
+    std::unordered_map<int, double> hops;
+    std::unordered_map<int, std::vector<int>> incoming;
+    hops.reserve(graph.GetVertexCount());
+    incoming.reserve(graph.GetVertexCount());
+    for (int vertex : graph.Vertices()) {
+        hops[vertex] = INF;
+        const DynamicArray<Edge>& edges = graph.GetEdges(vertex);
+        for (int i = 0; i < edges.GetSize(); i++) {
+            incoming[edges[i].to].push_back(vertex);
+        }
+    }
+    
+    std::vector<int> frontier{end};
+    hops[end] = 0.0;
+    for (size_t head = 0; head < frontier.size(); head++) {
+        int current = frontier[head];
+        for (int from : incoming[current]) {
+            if (hops[from] == INF) {
+                hops[from] = hops[current] + 1.0;
+                frontier.push_back(from);
+            }
+        }
+    }
+    return hops;
+}
+
+bool ConstrainedRouter::insertLabel(std::vector<Label>& pool, std::vector<int>& bag, int label) {
+    double cost = pool[label].cost;
+    double resource = pool[label].resource;
+    
+    //мешок отсортирован по стоимости, ресурс в нём строго убывает
+    auto it = std::upper_bound(bag.begin(), bag.end(), cost,
+        [&pool](double value, int existing) { return value < pool[existing].cost; });
+    if (it != bag.begin() && pool[*(it - 1)].resource <= resource) {
+        return false;
+    }
+    
+    auto first = std::lower_bound(bag.begin(), bag.end(), cost,
+        [&pool](int existing, double value) { return pool[existing].cost < value; });
+    auto last = first;
+    while (last != bag.end() && pool[*last].resource >= resource) {
+        pool[*last].alive = false;
+        ++last;
+    }
+    first = bag.erase(first, last);
+    bag.insert(first, label);
+    return true;
+}
+
+void ConstrainedRouter::describeLabels(ConstrainedResult& result, const std::vector<Label>& pool, int label,
+                                       Resource resource) const {
+    DijkstraResult& route = result.route;
+    route.pathExists = true;
+    route.totalCost = 0.0;
+    route.totalDistance = 0.0;
+    
+    //итоги по рёбрам, которыми шли метки: из параллельных рёбер выбрано не обязательно самое дешёвое
+    double survivalCost = 0.0;
+    for (int current = label; current != -1; current = pool[current].parent) {
+        route.path.Prepend(pool[current].vertex);
+        if (pool[current].parent != -1) {
+            route.lanes.Prepend(pool[current].edge);
+            const EdgeData& data = graph.GetEdges(pool[pool[current].parent].vertex)[pool[current].edge].data;
+            route.totalCost += data.getTotalCost();
+            route.totalDistance += data.distance;
+            survivalCost += data.survivalCost;
+        }
+    }
+    for (int i = 0; i < route.path.GetSize(); i++) {
+        route.pathNames.Append(graph.GetVertexName(route.path.Get(i)));
+    }
+    route.survivalProbability = std::exp(-survivalCost);
+    
+    result.consumed = resource == Risk ? -std::expm1(-survivalCost) : pool[label].resource;
+}
+
+ConstrainedResult ConstrainedRouter::FindPath(int start, int end, Resource resource, double budget,
+                                              RouteMetric metric) const {
+    if (budget < 0.0 || (resource == Risk && budget > 1.0)) {
+        throw std::invalid_argument("Resource budget is out of range");
+    }
+    
+    ConstrainedResult result;
+    result.budget = budget;
+    lastLabelCount = 0;
+    
+    if (!graph.HasVertex(start) || !graph.HasVertex(end)) {
+        return result;
+    }
+    
+    //лимит в тех же единицах, что и ресурс на рёбрах
+    double limit = budget;
+    if (resource == Risk) {
+        limit = budget >= 1.0 ? INF : EdgeData::computeSurvivalCost(budget);
+    }
+    limit += BUDGET_EPSILON;
+    
+    //точные оценки остатка: стоимость - для порядка A*, ресурс - для отсечения
+    std::unordered_map<int, double> costBound = Dijkstra(graph).FindAllShortestPathsTo(end, metric);
+    std::unordered_map<int, double> resourceBound = resourceToTarget(end, resource);
+    if (costBound[start] == INF || resourceBound[start] > limit) {
+        return result;
+    }
+    
+    std::vector<Label> pool;
+    std::unordered_map<int, std::vector<int>> bags;
+    bags.reserve(graph.GetVertexCount());
+    
+    pool.push_back(Label{0.0, 0.0, start, -1, -1, true});
+    bags[start].push_back(0);
+    
+    //ключ - (стоимость + оценка, ресурс): при равной стоимости раньше идёт экономная метка
+    using Key = std::pair<double, double>;
+    PriorityQueue<int, Key> pq(std::less<Key>{});
+    pq.Enqueue(0, Key(costBound[start], 0.0));
+    
+    int reached = -1;
+    while (!pq.IsEmpty()) {
+        int index = pq.Dequeue();
+        Label current = pool[index];   //копия: пул растёт по ходу цикла
+        
+        if (!current.alive) {
+            continue;
+        }
+        if (current.vertex == end) {
+            reached = index;
+            break;
+        }
+        
+        const DynamicArray<Edge>& edges = graph.GetEdges(current.vertex);
+        for (int i = 0; i < edges.GetSize(); i++) {
+            const Edge& edge = edges[i];
+            double resourceUsed = current.resource + edgeResource(edge.data, resource);
+            if (resourceUsed + resourceBound[edge.to] > limit) {
+                continue;
+            }
+            
+            double cost = current.cost + Dijkstra::EdgeWeight(edge.data, metric);
+            pool.push_back(Label{cost, resourceUsed, edge.to, index, i, true});
+            int label = static_cast<int>(pool.size()) - 1;
+            if (insertLabel(pool, bags[edge.to], label)) {
+                pq.Enqueue(label, Key(cost + costBound[edge.to], resourceUsed));
+            } else {
+                pool.pop_back();
+            }
+        }
+    }
+    
+    lastLabelCount = static_cast<int>(pool.size());
+    
+    if (reached != -1) {
+        describeLabels(result, pool, reached, resource);
+    }
+    return result;
+}
+
+ConstrainedResult ConstrainedRouter::FindPath(const std::string& startName, const std::string& endName,
+                                              Resource resource, double budget, RouteMetric metric) const {
+    int start, end;
+    try {
+        start = graph.GetVertexIndex(startName);
+        end = graph.GetVertexIndex(endName);
+    } catch (const std::exception& e) {
+        ConstrainedResult result;
+        result.budget = budget;
+        return result;
+    }
+    return FindPath(start, end, resource, budget, metric);
+}
+
+ConstrainedResult ConstrainedRouter::FindCheapestWithinRisk(int start, int end, double maxEncounterProbability) const {
+    return FindPath(start, end, Risk, maxEncounterProbability, RouteMetric::Cost);
+}
+
+ConstrainedResult ConstrainedRouter::FindShortestWithinJumps(int start, int end, int maxJumps) const {
+    return FindPath(start, end, Jumps, static_cast<double>(maxJumps), RouteMetric::Cost);
+}
@@ -1,9 +1,14 @@
 #include "Dijkstra.h"
+#include "ParetoRouter.h"
 #include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
 
 //dijkstraResult реализация
 DijkstraResult::DijkstraResult() 
-    : pathExists(false), totalCost(std::numeric_limits<double>::infinity()) {}
+    : pathExists(false), totalCost(std::numeric_limits<double>::infinity()),
+      totalDistance(std::numeric_limits<double>::infinity()), survivalProbability(0.0), arrivalTime(0.0) {}
 
 //dijkstra реализация
 Dijkstra::Dijkstra(const StarGraph& g) : graph(g) {}
@@ -34,7 +39,82 @@ DynamicArray<int> Dijkstra::reconstructPath(const std::unordered_map<int, int>&
     return path;
 }
 
+double Dijkstra::EdgeWeight(const EdgeData& data, RouteMetric metric) {
+    return metric == RouteMetric::Survival ? data.survivalCost : data.getTotalCost();
+}
+
+int Dijkstra::BestLane(const DynamicArray<Edge>& edges, int to, RouteMetric metric) {
+    int best = -1;
+    for (int j = 0; j < edges.GetSize(); j++) {
+        if (edges[j].to == to && (best < 0 || EdgeWeight(edges[j].data, metric) < EdgeWeight(edges[best].data, metric))) {
+            best = j;
+        }
+    }
+    return best;
+}
+
+void Dijkstra::describePath(DijkstraResult& result, RouteMetric metric) const {
+    //из параллельных рёбер берётся лучшее в метрике поиска
+    result.lanes.Clear();
+    for (int i = 0; i + 1 < result.path.GetSize(); i++) {
+        result.lanes.Append(BestLane(graph.GetEdges(result.path.Get(i)), result.path.Get(i + 1), metric));
+    }
+    describeLanes(result);
+}
+
+void Dijkstra::describeLanes(DijkstraResult& result) const {
+    //заполняем имена планет
+    for (int i = 0; i < result.path.GetSize(); i++) {
+        result.pathNames.Append(graph.GetVertexName(result.path.Get(i)));
+    }
+    
+    //стоимость, расстояние и вероятность выживания по рёбрам пути
+    result.totalCost = 0.0;
+    result.totalDistance = 0.0;
+    double survivalCost = 0.0;
+    for (int i = 0; i + 1 < result.path.GetSize(); i++) {
+        const EdgeData& data = graph.GetEdges(result.path.Get(i))[result.lanes.Get(i)].data;
+        result.totalCost += data.getTotalCost();
+        result.totalDistance += data.distance;
+        survivalCost += data.survivalCost;
+    }
+    result.survivalProbability = std::exp(-survivalCost);
+}
+
 DijkstraResult Dijkstra::FindShortestPath(int start, int end) const {
+    return search(start, end, RouteMetric::Cost);
+}
+
+DijkstraResult Dijkstra::FindSafestPath(int start, int end) const {
+    return search(start, end, RouteMetric::Survival);
+}
+
+DijkstraResult Dijkstra::FindSafestPath(int start, int end, double distanceBudget) const {
+    //самый безопасный путь часто укладывается в бюджет сам - тогда хватает одного поиска
+    DijkstraResult safest = search(start, end, RouteMetric::Survival);
+    if (!safest.pathExists || safest.totalDistance <= distanceBudget) {
+        return safest;
+    }
+    
+    //иначе - фронт Парето (расстояние, риск) с отсечением меток сверх бюджета:
+    //последний маршрут фронта самый безопасный из укладывающихся;
+    //итоги - по его переходам (более безопасное параллельное ребро может не влезть в бюджет)
+    ParetoRouter::Settings settings;
+    settings.maxDistance = distanceBudget;
+    std::vector<ParetoRoute> front = ParetoRouter(graph, settings).FindParetoFront(start, end);
+    
+    DijkstraResult result;
+    if (front.empty()) {
+        return result;
+    }
+    result.pathExists = true;
+    result.path = front.back().path;
+    result.lanes = front.back().lanes;
+    describeLanes(result);
+    return result;
+}
+
+DijkstraResult Dijkstra::search(int start, int end, RouteMetric metric) const {
     DijkstraResult result;
     
     //проверка существования вершин
@@ -47,10 +127,10 @@ DijkstraResult Dijkstra::FindShortestPath(int start, int end) const {
     std::unordered_map<int, int> previous;
     std::unordered_map<int, bool> visited;
     
-    //получаем все вершины графа
-    DynamicArray<int> allVertices = graph.GetAllVertices();
-    for (int i = 0; i < allVertices.GetSize(); i++) {
-        int vertex = allVertices.Get(i);
+    //обходим все вершины графа без копирования списка
+    distances.reserve(graph.GetVertexCount());
+    visited.reserve(graph.GetVertexCount());
+    for (int vertex : graph.Vertices()) {
         distances[vertex] = std::numeric_limits<double>::infinity();
         visited[vertex] = false;
     }
@@ -79,9 +159,9 @@ DijkstraResult Dijkstra::FindShortestPath(int start, int end) const {
         //проверяем всех соседей
         const DynamicArray<Edge>& edges = graph.GetEdges(current);
         for (int i = 0; i < edges.GetSize(); i++) {
-            const Edge& edge = edges.Get(i);
+            const Edge& edge = edges[i];
             int neighbor = edge.to;
-            double edgeCost = edge.data.getTotalCost();
+            double edgeCost = EdgeWeight(edge.data, metric);
             
             //релаксация ребра
             double newDistance = distances[current] + edgeCost;
@@ -99,11 +179,7 @@ DijkstraResult Dijkstra::FindShortestPath(int start, int end) const {
     
     if (result.pathExists) {
         result.path = reconstructPath(previous, start, end);
-        
-        //заполняем имена планет
-        for (int i = 0; i < result.path.GetSize(); i++) {
-            result.pathNames.Append(graph.GetVertexName(result.path.Get(i)));
-        }
+        describePath(result, metric);
     }
     
     return result;
@@ -120,14 +196,95 @@ DijkstraResult Dijkstra::FindShortestPath(const std::string& startName,
     }
 }
 
+DijkstraResult Dijkstra::FindShortestPath(int start, int end, const HazardForecast& forecast,
+                                         const HazardPolicy& policy, RouteMetric metric) const {
+    DijkstraResult result;
+    
+    if (!graph.HasVertex(start) || !graph.HasVertex(end)) {
+        return result;
+    }
+    
+    std::unordered_map<int, double> distances;
+    std::unordered_map<int, double> arrival;    //время прибытия по выбранному предшественнику
+    std::unordered_map<int, int> previous;
+    std::unordered_map<int, bool> visited;
+    
+    distances.reserve(graph.GetVertexCount());
+    arrival.reserve(graph.GetVertexCount());
+    visited.reserve(graph.GetVertexCount());
+    for (int vertex : graph.Vertices()) {
+        distances[vertex] = std::numeric_limits<double>::infinity();
+        arrival[vertex] = std::numeric_limits<double>::infinity();
+        visited[vertex] = false;
+    }
+    
+    distances[start] = 0.0;
+    arrival[start] = 0.0;
+    
+    PriorityQueue<int, double> pq;
+    pq.Enqueue(start, 0.0);
+    
+    while (!pq.IsEmpty()) {
+        int current = pq.Dequeue();
+        
+        if (visited[current]) {
+            continue;
+        }
+        
+        visited[current] = true;
+        
+        if (current == end) {
+            break;
+        }
+        
+        const DynamicArray<Edge>& edges = graph.GetEdges(current);
+        for (int i = 0; i < edges.GetSize(); i++) {
+            const Edge& edge = edges[i];
+            int neighbor = edge.to;
+            double edgeCost = EdgeWeight(edge.data, metric);
+            double arrivalTime = arrival[current] + policy.TravelTime(edge.data);
+            
+            //ребро разорвано до конца перелёта или планета поглощена к прибытию
+            double deadline = arrivalTime + policy.safetyMargin;
+            bool threatened = forecast.GetLaneDoomTime(current, neighbor) <= deadline ||
+                              forecast.GetPlanetDoomTime(neighbor) <= deadline;
+            if (threatened) {
+                if (policy.mode == HazardPolicy::Avoid) {
+                    continue;
+                }
+                edgeCost += policy.penalty;
+            }
+            
+            double newDistance = distances[current] + edgeCost;
+            if (newDistance < distances[neighbor]) {
+                distances[neighbor] = newDistance;
+                arrival[neighbor] = arrivalTime;
+                previous[neighbor] = current;
+                pq.Enqueue(neighbor, newDistance);
+            }
+        }
+    }
+    
+    result.pathExists = (distances[end] != std::numeric_limits<double>::infinity());
+    
+    //стоимость в результате - без штрафов за угрозу
+    if (result.pathExists) {
+        result.arrivalTime = arrival[end];
+        result.path = reconstructPath(previous, start, end);
+        describePath(result, metric);
+    }
+    
+    return result;
+}
+
 std::unordered_map<int, double> Dijkstra::FindAllShortestPaths(int start) const {
     std::unordered_map<int, double> distances;
     std::unordered_map<int, bool> visited;
     
     //инициализация
-    DynamicArray<int> allVertices = graph.GetAllVertices();
-    for (int i = 0; i < allVertices.GetSize(); i++) {
-        int vertex = allVertices.Get(i);
+    distances.reserve(graph.GetVertexCount());
+    visited.reserve(graph.GetVertexCount());
+    for (int vertex : graph.Vertices()) {
         distances[vertex] = std::numeric_limits<double>::infinity();
         visited[vertex] = false;
     }
@@ -150,7 +307,7 @@ std::unordered_map<int, double> Dijkstra::FindAllShortestPaths(int start) const
         //обрабатываем всех соседей
         const DynamicArray<Edge>& edges = graph.GetEdges(current);
         for (int i = 0; i < edges.GetSize(); i++) {
-            const Edge& edge = edges.Get(i);
+            const Edge& edge = edges[i];
             int neighbor = edge.to;
             double edgeCost = edge.data.getTotalCost();
             
@@ -165,4 +322,67 @@ std::unordered_map<int, double> Dijkstra::FindAllShortestPaths(int start) const
     return distances;
 }
 
+std::unordered_map<int, double> Dijkstra::FindAllShortestPathsTo(int target, RouteMetric metric) const {
+    std::unordered_map<int, double> distances;
+    std::unordered_map<int, bool> visited;
+    
+    //обратные списки смежности: вершина -> (откуда, вес)
+    std::unordered_map<int, std::vector<std::pair<int, double>>> incoming;
+    distances.reserve(graph.GetVertexCount());
+    visited.reserve(graph.GetVertexCount());
+    incoming.reserve(graph.GetVertexCount());
+    for (int vertex : graph.Vertices()) {
+        distances[vertex] = std::numeric_limits<double>::infinity();
+        visited[vertex] = false;
+        
+        const DynamicArray<Edge>& edges = graph.GetEdges(vertex);
+        for (int i = 0; i < edges.GetSize(); i++) {
+            incoming[edges[i].to].emplace_back(vertex, EdgeWeight(edges[i].data, metric));
+        }
+    }
+    
+    if (!graph.HasVertex(target)) {
+        return distances;
+    }
+    
+    distances[target] = 0.0;
+    
+    PriorityQueue<int, double> pq;
+    pq.Enqueue(target, 0.0);
+    
+    while (!pq.IsEmpty()) {
+        int current = pq.Dequeue();
+        
+        if (visited[current]) {
+            continue;
+        }
+        
+        visited[current] = true;
+        
+        auto it = incoming.find(current);
+        if (it == incoming.end()) {
+            continue;
+        }
+        for (const auto& edge : it->second) {
+            double newDistance = distances[current] + edge.second;
+            if (newDistance < distances[edge.first]) {
+                distances[edge.first] = newDistance;
+                pq.Enqueue(edge.first, newDistance);
+            }
+        }
+    }
+    
+    return distances;
+}
 
+DijkstraResult Dijkstra::DescribePath(const DynamicArray<int>& path, RouteMetric metric) const {
+    DijkstraResult result;
+    if (path.GetSize() == 0) {
+        return result;
+    }
+    
+    result.pathExists = true;
+    result.path = path;
+    describePath(result, metric);
+    return result;
+}
@@ -0,0 +1,367 @@
+#include "ForceLayout.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+static const int MAX_TREE_DEPTH = 32;           //глубже - совпадающие точки, не делим
+static const int PARALLEL_THRESHOLD = 512;      //меньше вершин - считаем в одном потоке
+static const double GOLDEN_ANGLE = 2.39996322972865332;
+
+ForceLayout::Settings::Settings()
+    : iterations(300), idealLength(150.0), theta(0.9), gravity(0.01), threadCount(0) {}
+
+ForceLayout::ForceLayout(const StarGraph& graph, const std::unordered_map<int, LayoutPoint>& initial,
+                         const Settings& layoutSettings)
+    : settings(layoutSettings), temperature(0.0), iteration(0),
+      poolGeneration(0), poolPending(0), poolChunk(0), poolStopping(false) {
+    if (settings.idealLength <= 0.0) {
+        throw std::invalid_argument("Ideal edge length must be positive");
+    }
+    
+    //снимок вершин: id -> плотный индекс
+    const DynamicArray<int>& vertices = graph.GetVertexArray();
+    std::unordered_map<int, int> indexOf;
+    ids.reserve(vertices.GetSize());
+    for (int i = 0; i < vertices.GetSize(); i++) {
+        indexOf[vertices.Get(i)] = i;
+        ids.push_back(vertices.Get(i));
+    }
+    
+    //снимок рёбер (петли не влияют на раскладку)
+    for (int i = 0; i < vertices.GetSize(); i++) {
+        const DynamicArray<Edge>& out = graph.GetEdges(vertices.Get(i));
+        for (int j = 0; j < out.GetSize(); j++) {
+            int to = indexOf[out.Get(j).to];
+            if (to != i) {
+                edges.push_back(std::make_pair(i, to));
+            }
+        }
+    }
+    
+    //известные позиции и центр, вокруг которого раскладываются остальные
+    positions.resize(ids.size());
+    std::vector<bool> placed(ids.size(), false);
+    double centerX = 0.0, centerY = 0.0;
+    int known = 0;
+    for (size_t i = 0; i < ids.size(); i++) {
+        auto it = initial.find(ids[i]);
+        if (it != initial.end()) {
+            positions[i] = it->second;
+            placed[i] = true;
+            centerX += it->second.x;
+            centerY += it->second.y;
+            known++;
+        }
+    }
+    if (known > 0) {
+        centerX /= known;
+        centerY /= known;
+    }
+    
+    //вершины без координат (например, после LoadFromFile) - по спирали
+    int spiral = 0;
+    for (size_t i = 0; i < ids.size(); i++) {
+        if (!placed[i]) {
+            double radius = settings.idealLength * 0.5 * std::sqrt(spiral + 1.0);
+            double angle = spiral * GOLDEN_ANGLE;
+            positions[i] = LayoutPoint(centerX + radius * std::cos(angle),
+                                       centerY + radius * std::sin(angle));
+            spiral++;
+        }
+    }
+    
+    displacement.resize(ids.size());
+    
+    //большие карты требуют больших сдвигов на первых итерациях
+    temperature = settings.idealLength * std::max(1.0, std::sqrt(static_cast<double>(ids.size())) / 10.0);
+    
+    if (settings.threadCount <= 0) {
+        settings.threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+ForceLayout::~ForceLayout() {
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        poolStopping = true;
+    }
+    poolWake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+int ForceLayout::newNode(double centerX, double centerY, double halfSize) {
+    QuadNode node;
+    node.centerX = centerX;
+    node.centerY = centerY;
+    node.halfSize = halfSize;
+    node.massX = 0.0;
+    node.massY = 0.0;
+    node.count = 0;
+    node.body = -1;
+    for (int q = 0; q < 4; q++) {
+        node.children[q] = -1;
+    }
+    tree.push_back(node);
+    return static_cast<int>(tree.size()) - 1;
+}
+
+void ForceLayout::buildTree() {
+    //clear сохраняет емкость - дерево перестраивается без выделения памяти
+    tree.clear();
+    
+    double minX = positions[0].x, maxX = positions[0].x;
+    double minY = positions[0].y, maxY = positions[0].y;
+    for (const LayoutPoint& p : positions) {
+        minX = std::min(minX, p.x);
+        maxX = std::max(maxX, p.x);
+        minY = std::min(minY, p.y);
+        maxY = std::max(maxY, p.y);
+    }
+    
+    double halfSize = std::max(maxX - minX, maxY - minY) / 2.0 + 1.0;
+    newNode((minX + maxX) / 2.0, (minY + maxY) / 2.0, halfSize);
+    
+    for (int i = 0; i < GetSize(); i++) {
+        insertBody(i);
+    }
+}
+
+void ForceLayout::insertBody(int body) {
+    const LayoutPoint& p = positions[body];
+    int node = 0;
+    
+    for (int depth = 0; ; depth++) {
+        tree[node].massX += p.x;
+        tree[node].massY += p.y;
+        tree[node].count++;
+        
+        //пустой лист - вершина остаётся здесь
+        if (tree[node].count == 1) {
+            tree[node].body = body;
+            return;
+        }
+        
+        //совпадающие точки: лист становится скоплением
+        if (depth >= MAX_TREE_DEPTH) {
+            return;
+        }
+        
+        //лист с одной вершиной делится: старая вершина опускается в потомка
+        if (tree[node].body != -1) {
+            int existing = tree[node].body;
+            tree[node].body = -1;
+            
+            const LayoutPoint& e = positions[existing];
+            int q = (e.x >= tree[node].centerX ? 1 : 0) + (e.y >= tree[node].centerY ? 2 : 0);
+            double half = tree[node].halfSize / 2.0;
+            int child = newNode(tree[node].centerX + ((q & 1) ? half : -half),
+                                tree[node].centerY + ((q & 2) ? half : -half), half);
+            tree[node].children[q] = child;
+            tree[child].massX = e.x;
+            tree[child].massY = e.y;
+            tree[child].count = 1;
+            tree[child].body = existing;
+        }
+        
+        //спускаемся в квадрант новой вершины
+        int q = (p.x >= tree[node].centerX ? 1 : 0) + (p.y >= tree[node].centerY ? 2 : 0);
+        if (tree[node].children[q] == -1) {
+            double half = tree[node].halfSize / 2.0;
+            int child = newNode(tree[node].centerX + ((q & 1) ? half : -half),
+                                tree[node].centerY + ((q & 2) ? half : -half), half);
+            tree[node].children[q] = child;
+        }
+        node = tree[node].children[q];
+    }
+}
+
+LayoutPoint ForceLayout::repulsion(int body) const {
+    const LayoutPoint& p = positions[body];
+    double k2 = settings.idealLength * settings.idealLength;
+    double theta2 = settings.theta * settings.theta;
+    double fx = 0.0, fy = 0.0;
+    
+    //обход без рекурсии: на каждом уровне в стеке не больше 3 отложенных узлов
+    int stack[4 * MAX_TREE_DEPTH + 8];
+    int top = 0;
+    stack[top++] = 0;
+    
+    while (top > 0) {
+        const QuadNode& node = tree[stack[--top]];
+        if (node.count == 0 || (node.count == 1 && node.body == body)) {
+            continue;
+        }
+        
+        double dx = p.x - node.massX / node.count;
+        double dy = p.y - node.massY / node.count;
+        double distanceSquared = dx * dx + dy * dy;
+        
+        bool isLeaf = node.children[0] == -1 && node.children[1] == -1 &&
+                      node.children[2] == -1 && node.children[3] == -1;
+        double size = 2.0 * node.halfSize;
+        
+        //лист или достаточно далекий узел - как одна масса в центре масс
+        if (isLeaf || size * size < theta2 * distanceSquared) {
+            if (distanceSquared < 1e-6) {
+                //совпадающие точки расталкиваем в детерминированном направлении
+                double angle = body * GOLDEN_ANGLE;
+                dx = std::cos(angle) * 0.01;
+                dy = std::sin(angle) * 0.01;
+                distanceSquared = 1e-4;
+            }
+            //сила k^2 / d вдоль (dx, dy) / d
+            double scale = k2 * node.count / distanceSquared;
+            fx += dx * scale;
+            fy += dy * scale;
+        } else {
+            for (int q = 0; q < 4; q++) {
+                if (node.children[q] != -1) {
+                    stack[top++] = node.children[q];
+                }
+            }
+        }
+    }
+    
+    return LayoutPoint(fx, fy);
+}
+
+void ForceLayout::computeRepulsion(int begin, int end) {
+    for (int i = begin; i < end; i++) {
+        displacement[i] = repulsion(i);
+    }
+}
+
+void ForceLayout::workerLoop(int part) {
+    unsigned long long seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(poolMutex);
+            poolWake.wait(lock, [&]() { return poolStopping || poolGeneration != seen; });
+            if (poolStopping) {
+                return;
+            }
+            seen = poolGeneration;
+        }
+        
+        //число вершин не меняется - части одни и те же на всех итерациях
+        int n = GetSize();
+        int begin = std::min(n, part * poolChunk);
+        computeRepulsion(begin, std::min(n, begin + poolChunk));
+        
+        std::lock_guard<std::mutex> lock(poolMutex);
+        if (--poolPending == 0) {
+            poolDone.notify_one();
+        }
+    }
+}
+
+void ForceLayout::computeRepulsionParallel(int threads) {
+    int n = GetSize();
+    if (workers.empty()) {
+        poolChunk = (n + threads - 1) / threads;
+        for (int part = 1; part < threads; part++) {
+            workers.emplace_back(&ForceLayout::workerLoop, this, part);
+        }
+    }
+    
+    //дерево и позиции записаны до захвата мьютекса - потоки видят их после пробуждения
+    {
+        std::lock_guard<std::mutex> lock(poolMutex);
+        poolPending = static_cast<int>(workers.size());
+        poolGeneration++;
+    }
+    poolWake.notify_all();
+    
+    computeRepulsion(0, std::min(n, poolChunk));
+    
+    std::unique_lock<std::mutex> lock(poolMutex);
+    poolDone.wait(lock, [this]() { return poolPending == 0; });
+}
+
+bool ForceLayout::Step() {
+    if (IsFinished()) {
+        return false;
+    }
+    
+    int n = GetSize();
+    if (n == 0) {
+        iteration = settings.iterations;
+        return false;
+    }
+    
+    //═══ отталкивание (Barnes-Hut), дерево только читается - считаем параллельно ═══
+    buildTree();
+    
+    int threads = std::min(settings.threadCount, std::max(1, n / (PARALLEL_THRESHOLD / 2)));
+    if (n < PARALLEL_THRESHOLD || threads <= 1) {
+        computeRepulsion(0, n);
+    } else {
+        computeRepulsionParallel(threads);
+    }
+    
+    //═══ притяжение вдоль рёбер: сила d^2 / k ═══
+    for (const auto& edge : edges) {
+        LayoutPoint& a = positions[edge.first];
+        LayoutPoint& b = positions[edge.second];
+        double dx = a.x - b.x;
+        double dy = a.y - b.y;
+        double distance = std::sqrt(dx * dx + dy * dy);
+        if (distance < 1e-9) {
+            continue;
+        }
+        double scale = distance / settings.idealLength;  //(d^2 / k) / d
+        displacement[edge.first].x -= dx * scale;
+        displacement[edge.first].y -= dy * scale;
+        displacement[edge.second].x += dx * scale;
+        displacement[edge.second].y += dy * scale;
+    }
+    
+    //═══ притяжение к центру масс и сдвиг не больше температуры ═══
+    double centerX = tree[0].massX / tree[0].count;
+    double centerY = tree[0].massY / tree[0].count;
+    for (int i = 0; i < n; i++) {
+        LayoutPoint& d = displacement[i];
+        d.x -= (positions[i].x - centerX) * settings.gravity * settings.idealLength;
+        d.y -= (positions[i].y - centerY) * settings.gravity * settings.idealLength;
+        
+        double length = std::sqrt(d.x * d.x + d.y * d.y);
+        if (length > 1e-9) {
+            double move = std::min(length, temperature);
+            positions[i].x += d.x / length * move;
+            positions[i].y += d.y / length * move;
+        }
+    }
+    
+    //охлаждение: к концу раскладки вершины почти не двигаются
+    iteration++;
+    double progress = static_cast<double>(iteration) / settings.iterations;
+    temperature = std::max(settings.idealLength * 0.01, temperature * (1.0 - progress * 0.1));
+    
+    return !IsFinished();
+}
+
+bool ForceLayout::Run(const std::atomic<bool>& cancelled,
+                      const std::function<void(const ForceLayout&)>& onProgress,
+                      int progressEvery) {
+    while (!IsFinished()) {
+        if (cancelled.load()) {
+            return false;
+        }
+        Step();
+        if (onProgress && progressEvery > 0 && iteration % progressEvery == 0 && !IsFinished()) {
+            onProgress(*this);
+        }
+    }
+    return true;
+}
+
+std::unordered_map<int, LayoutPoint> ForceLayout::GetPositions() const {
+    std::unordered_map<int, LayoutPoint> result;
+    result.reserve(ids.size());
+    for (size_t i = 0; i < ids.size(); i++) {
+        result[ids[i]] = positions[i];
+    }
+    return result;
+}
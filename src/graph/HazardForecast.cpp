@@ -0,0 +1,256 @@
+#include "HazardForecast.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+static const double EPSILON = 1e-12;
+static const double INF = std::numeric_limits<double>::infinity();
+
+//окно, в течение которого центр p + v*t находится в круге (cx, cy, reach), без обрезки по времени
+static bool discInterval(double px, double py, double vx, double vy,
+                         double cx, double cy, double reach, double& begin, double& end) {
+    double dx = px - cx, dy = py - cy;
+    double a = vx * vx + vy * vy;
+    double c = dx * dx + dy * dy - reach * reach;
+    
+    //неподвижная дыра: либо всегда внутри, либо никогда
+    if (a < EPSILON) {
+        begin = -INF;
+        end = INF;
+        return c <= 0.0;
+    }
+    
+    double b = dx * vx + dy * vy;
+    double discriminant = b * b - a * c;
+    if (discriminant < 0.0) {
+        return false;
+    }
+    double root = std::sqrt(discriminant);
+    begin = (-b - root) / a;
+    end = (-b + root) / a;
+    return true;
+}
+
+//окно, в течение которого value + rate*t лежит в [low, high]; сужает [begin, end]
+static bool clipLinear(double value, double rate, double low, double high,
+                       double& begin, double& end) {
+    if (std::fabs(rate) < EPSILON) {
+        return value >= low && value <= high;
+    }
+    double first = (low - value) / rate;
+    double second = (high - value) / rate;
+    if (first > second) {
+        std::swap(first, second);
+    }
+    begin = std::max(begin, first);
+    end = std::min(end, second);
+    return begin <= end;
+}
+
+//окно обрезается по времени жизни дыры
+static bool clipToLifetime(const HazardTrack& track, double& begin, double& end) {
+    begin = std::max(begin, 0.0);
+    end = std::min(end, track.remaining);
+    return begin <= end;
+}
+
+//hazardTrack реализация
+HazardTrack::HazardTrack()
+    : x(0.0), y(0.0), velocityX(0.0), velocityY(0.0), radius(0.0), remaining(0.0) {}
+
+HazardTrack::HazardTrack(double px, double py, double vx, double vy, double r, double remainingTime)
+    : x(px), y(py), velocityX(vx), velocityY(vy), radius(r), remaining(remainingTime) {}
+
+//hazardWindow реализация
+HazardWindow::HazardWindow() : begin(INF), end(INF), hazard(-1) {}
+
+HazardWindow::HazardWindow(double from, double to, int hazardIndex)
+    : begin(from), end(to), hazard(hazardIndex) {}
+
+//hazardPolicy реализация
+HazardPolicy::HazardPolicy(Mode m, double speed, double penaltyCost, double margin)
+    : mode(m), traderSpeed(speed), penalty(penaltyCost), safetyMargin(margin) {
+    if (traderSpeed <= 0.0) {
+        throw std::invalid_argument("Trader speed must be positive");
+    }
+}
+
+double HazardPolicy::TravelTime(const EdgeData& data) const {
+    return data.distance / traderSpeed;
+}
+
+//hazardForecast реализация
+HazardForecast::HazardForecast(double radius) : planetRadius(radius) {
+    if (planetRadius < 0.0) {
+        throw std::invalid_argument("Planet radius must be non-negative");
+    }
+}
+
+int HazardForecast::AddHazard(const HazardTrack& track) {
+    if (track.radius < 0.0) {
+        throw std::invalid_argument("Hazard radius must be non-negative");
+    }
+    hazards.push_back(track);
+    return static_cast<int>(hazards.size()) - 1;
+}
+
+void HazardForecast::SetPlanetPosition(int id, double x, double y) {
+    positions[id] = Point{x, y};
+}
+
+void HazardForecast::Clear() {
+    hazards.clear();
+    positions.clear();
+    planetWindows.clear();
+    laneWindows.clear();
+}
+
+long long HazardForecast::laneKey(int from, int to) {
+    return (static_cast<long long>(from) << 32) | static_cast<unsigned int>(to);
+}
+
+bool HazardForecast::PointWindow(const HazardTrack& track, double px, double py, double reach,
+                                 double& begin, double& end) {
+    if (!discInterval(track.x, track.y, track.velocityX, track.velocityY, px, py, reach, begin, end)) {
+        return false;
+    }
+    return clipToLifetime(track, begin, end);
+}
+
+bool HazardForecast::SegmentWindow(const HazardTrack& track, double ax, double ay,
+                                   double bx, double by, double reach, double& begin, double& end) {
+    double abX = bx - ax, abY = by - ay;
+    double length = std::sqrt(abX * abX + abY * abY);
+    if (length < EPSILON) {
+        return PointWindow(track, ax, ay, reach, begin, end);
+    }
+    
+    //капсула = два круга на концах + прямоугольник вдоль отрезка;
+    //расстояние до выпуклого множества вдоль прямой выпукло, поэтому
+    //объединение трёх окон - снова один интервал
+    bool found = false;
+    begin = INF;
+    end = -INF;
+    
+    double from, to;
+    if (discInterval(track.x, track.y, track.velocityX, track.velocityY, ax, ay, reach, from, to)) {
+        begin = std::min(begin, from);
+        end = std::max(end, to);
+        found = true;
+    }
+    if (discInterval(track.x, track.y, track.velocityX, track.velocityY, bx, by, reach, from, to)) {
+        begin = std::min(begin, from);
+        end = std::max(end, to);
+        found = true;
+    }
+    
+    //прямоугольник: проекция на отрезок в [0, length], отклонение от прямой в [-reach, reach]
+    double ux = abX / length, uy = abY / length;
+    double relX = track.x - ax, relY = track.y - ay;
+    from = -INF;
+    to = INF;
+    if (clipLinear(relX * ux + relY * uy, track.velocityX * ux + track.velocityY * uy,
+                   0.0, length, from, to) &&
+        clipLinear(relX * uy - relY * ux, track.velocityX * uy - track.velocityY * ux,
+                   -reach, reach, from, to)) {
+        begin = std::min(begin, from);
+        end = std::max(end, to);
+        found = true;
+    }
+    
+    return found && clipToLifetime(track, begin, end);
+}
+
+void HazardForecast::Compute(const StarGraph& graph) {
+    planetWindows.clear();
+    laneWindows.clear();
+    
+    auto byBegin = [](const HazardWindow& a, const HazardWindow& b) { return a.begin < b.begin; };
+    
+    for (int h = 0; h < GetHazardCount(); h++) {
+        const HazardTrack& track = hazards[h];
+        if (track.remaining <= 0.0) {
+            continue;
+        }
+        
+        //габариты всей траектории - дешёвое отсечение далёких элементов
+        double endX = track.x + track.velocityX * track.remaining;
+        double endY = track.y + track.velocityY * track.remaining;
+        double reach = track.radius + planetRadius;
+        double minX = std::min(track.x, endX), maxX = std::max(track.x, endX);
+        double minY = std::min(track.y, endY), maxY = std::max(track.y, endY);
+        
+        for (int vertex : graph.Vertices()) {
+            auto it = positions.find(vertex);
+            if (it == positions.end()) {
+                continue;
+            }
+            const Point& p = it->second;
+            if (p.x < minX - reach || p.x > maxX + reach || p.y < minY - reach || p.y > maxY + reach) {
+                continue;
+            }
+            
+            double begin, end;
+            if (PointWindow(track, p.x, p.y, reach, begin, end)) {
+                planetWindows[vertex].push_back(HazardWindow(begin, end, h));
+            }
+        }
+        
+        //рёбра рвутся от касания самим диском дыры (без радиуса планеты)
+        for (int vertex : graph.Vertices()) {
+            auto fromIt = positions.find(vertex);
+            if (fromIt == positions.end()) {
+                continue;
+            }
+            const Point& a = fromIt->second;
+            
+            const DynamicArray<Edge>& edges = graph.GetEdges(vertex);
+            for (int i = 0; i < edges.GetSize(); i++) {
+                auto toIt = positions.find(edges[i].to);
+                if (toIt == positions.end()) {
+                    continue;
+                }
+                const Point& b = toIt->second;
+                if (std::max(a.x, b.x) < minX - track.radius || std::min(a.x, b.x) > maxX + track.radius ||
+                    std::max(a.y, b.y) < minY - track.radius || std::min(a.y, b.y) > maxY + track.radius) {
+                    continue;
+                }
+                
+                double begin, end;
+                if (SegmentWindow(track, a.x, a.y, b.x, b.y, track.radius, begin, end)) {
+                    laneWindows[laneKey(vertex, edges[i].to)].push_back(HazardWindow(begin, end, h));
+                }
+            }
+        }
+    }
+    
+    for (auto& entry : planetWindows) {
+        std::sort(entry.second.begin(), entry.second.end(), byBegin);
+    }
+    for (auto& entry : laneWindows) {
+        std::sort(entry.second.begin(), entry.second.end(), byBegin);
+    }
+}
+
+const std::vector<HazardWindow>& HazardForecast::GetPlanetWindows(int id) const {
+    static const std::vector<HazardWindow> none;
+    auto it = planetWindows.find(id);
+    return it != planetWindows.end() ? it->second : none;
+}
+
+const std::vector<HazardWindow>& HazardForecast::GetLaneWindows(int from, int to) const {
+    static const std::vector<HazardWindow> none;
+    auto it = laneWindows.find(laneKey(from, to));
+    return it != laneWindows.end() ? it->second : none;
+}
+
+double HazardForecast::GetPlanetDoomTime(int id) const {
+    const std::vector<HazardWindow>& windows = GetPlanetWindows(id);
+    return windows.empty() ? INF : windows.front().begin;
+}
+
+double HazardForecast::GetLaneDoomTime(int from, int to) const {
+    const std::vector<HazardWindow>& windows = GetLaneWindows(from, to);
+    return windows.empty() ? INF : windows.front().begin;
+}
@@ -0,0 +1,319 @@
+#include "KShortestPaths.h"
+#include "PriorityQueue.h"
+#include <algorithm>
+#include <limits>
+#include <set>
+#include <stdexcept>
+#include <utility>
+
+static const double INF = std::numeric_limits<double>::infinity();
+
+//kShortestPaths реализация
+KShortestPaths::Settings::Settings()
+    : k(5), maxSharedFraction(1.0), maxCandidates(0), metric(RouteMetric::Cost) {}
+
+KShortestPaths::KShortestPaths(const StarGraph& g, const Settings& searchSettings)
+    : graph(g), settings(searchSettings), lastSearchCount(0) {
+    if (settings.k <= 0) {
+        throw std::invalid_argument("Number of routes must be positive");
+    }
+    if (settings.maxSharedFraction < 0.0) {
+        throw std::invalid_argument("Shared lane fraction must be non-negative");
+    }
+}
+
+double KShortestPaths::SharedLaneFraction(const DynamicArray<int>& a, const DynamicArray<int>& b) {
+    int lanes = a.GetSize() - 1;
+    if (lanes <= 0) {
+        return 0.0;
+    }
+    
+    std::set<std::pair<int, int>> other;
+    for (int i = 0; i + 1 < b.GetSize(); i++) {
+        other.insert(std::make_pair(b[i], b[i + 1]));
+    }
+    
+    int shared = 0;
+    for (int i = 0; i < lanes; i++) {
+        if (other.count(std::make_pair(a[i], a[i + 1]))) {
+            shared++;
+        }
+    }
+    return static_cast<double>(shared) / lanes;
+}
+
+double KShortestPaths::laneWeight(int from, int to) const {
+    double best = INF;
+    const DynamicArray<Edge>& edges = graph.GetEdges(from);
+    for (int i = 0; i < edges.GetSize(); i++) {
+        if (edges[i].to == to) {
+            best = std::min(best, Dijkstra::EdgeWeight(edges[i].data, settings.metric));
+        }
+    }
+    return best;
+}
+
+bool KShortestPaths::followTree(Query& query, int spur, int end, const std::vector<int>& blockedNext,
+                                std::vector<int>& spurPath, double& spurCost) const {
+    //лучший разрешённый первый шаг: вес ребра + точный остаток по дереву
+    int next = -1;
+    double firstWeight = INF;
+    double best = INF;
+    const DynamicArray<Edge>& edges = graph.GetEdges(spur);
+    for (int i = 0; i < edges.GetSize(); i++) {
+        const Edge& edge = edges[i];
+        if (std::find(blockedNext.begin(), blockedNext.end(), edge.to) != blockedNext.end()) {
+            continue;
+        }
+        double weight = Dijkstra::EdgeWeight(edge.data, settings.metric);
+        double total = weight + query.toTarget[query.index[edge.to]];
+        if (total < best) {
+            best = total;
+            firstWeight = weight;
+            next = edge.to;
+        }
+    }
+    if (next == -1 || best == INF) {
+        return false;
+    }
+    
+    spurPath.clear();
+    spurPath.push_back(spur);
+    spurCost = firstWeight;
+    
+    //дальше по дереву; путь годится, если не задевает корень и не зацикливается (нулевые веса)
+    std::vector<int> visited;
+    int current = next;
+    while (true) {
+        int dense = query.index[current];
+        if (query.blocked[dense] || current == spur
+            || std::find(visited.begin(), visited.end(), current) != visited.end()) {
+            return false;
+        }
+        visited.push_back(current);
+        spurPath.push_back(current);
+        if (current == end) {
+            return true;
+        }
+        
+        int successor = -1;
+        double successorWeight = INF;
+        double successorTotal = INF;
+        const DynamicArray<Edge>& out = graph.GetEdges(current);
+        for (int i = 0; i < out.GetSize(); i++) {
+            double weight = Dijkstra::EdgeWeight(out[i].data, settings.metric);
+            double total = weight + query.toTarget[query.index[out[i].to]];
+            if (total < successorTotal) {
+                successorTotal = total;
+                successorWeight = weight;
+                successor = out[i].to;
+            }
+        }
+        if (successor == -1) {
+            return false;
+        }
+        spurCost += successorWeight;
+        current = successor;
+    }
+}
+
+bool KShortestPaths::findSpur(Query& query, int spur, int end, const std::vector<int>& blockedNext,
+                              std::vector<int>& spurPath, double& spurCost) const {
+    if (followTree(query, spur, end, blockedNext, spurPath, spurCost)) {
+        return true;
+    }
+    
+    //A*: оценка toTarget согласована, поэтому вершина извлекается не более одного раза
+    lastSearchCount++;
+    for (int dense : query.touched) {
+        query.cost[dense] = INF;
+        query.parent[dense] = -1;
+    }
+    query.touched.clear();
+    
+    int source = query.index[spur];
+    int target = query.index[end];
+    query.cost[source] = 0.0;
+    query.touched.push_back(source);
+    
+    PriorityQueue<int, double> pq;
+    pq.Enqueue(source, query.toTarget[source]);
+    
+    bool reached = false;
+    while (!pq.IsEmpty()) {
+        int current = pq.Dequeue();
+        if (current == target) {
+            reached = true;
+            break;
+        }
+        
+        const DynamicArray<Edge>& edges = graph.GetEdges(query.ids[current]);
+        for (int i = 0; i < edges.GetSize(); i++) {
+            const Edge& edge = edges[i];
+            int neighbor = query.index[edge.to];
+            if (query.blocked[neighbor] || neighbor == source || query.toTarget[neighbor] == INF) {
+                continue;
+            }
+            if (current == source
+                && std::find(blockedNext.begin(), blockedNext.end(), edge.to) != blockedNext.end()) {
+                continue;
+            }
+            
+            double newCost = query.cost[current] + Dijkstra::EdgeWeight(edge.data, settings.metric);
+            if (newCost < query.cost[neighbor]) {
+                if (query.cost[neighbor] == INF) {
+                    query.touched.push_back(neighbor);
+                }
+                query.cost[neighbor] = newCost;
+                query.parent[neighbor] = current;
+                pq.Enqueue(neighbor, newCost + query.toTarget[neighbor]);
+            }
+        }
+    }
+    
+    if (!reached) {
+        return false;
+    }
+    
+    spurPath.clear();
+    for (int current = target; current != -1; current = query.parent[current]) {
+        spurPath.push_back(query.ids[current]);
+    }
+    std::reverse(spurPath.begin(), spurPath.end());
+    spurCost = query.cost[target];
+    return true;
+}
+
+std::vector<DijkstraResult> KShortestPaths::FindPaths(int start, int end) const {
+    std::vector<DijkstraResult> results;
+    lastSearchCount = 0;
+    
+    if (!graph.HasVertex(start) || !graph.HasVertex(end)) {
+        return results;
+    }
+    
+    Dijkstra dijkstra(graph);
+    std::unordered_map<int, double> distances = dijkstra.FindAllShortestPathsTo(end, settings.metric);
+    if (distances[start] == INF) {
+        return results;
+    }
+    
+    //плотная нумерация вершин: дальше только векторы вместо хеш-таблиц
+    Query query;
+    int vertexCount = graph.GetVertexCount();
+    query.index.reserve(vertexCount);
+    query.ids.reserve(vertexCount);
+    for (int vertex : graph.Vertices()) {
+        query.index[vertex] = static_cast<int>(query.ids.size());
+        query.ids.push_back(vertex);
+        query.toTarget.push_back(distances[vertex]);
+    }
+    query.blocked.assign(query.ids.size(), 0);
+    query.cost.assign(query.ids.size(), INF);
+    query.parent.assign(query.ids.size(), -1);
+    
+    if (start == end) {
+        DynamicArray<int> single;
+        single.Append(start);
+        results.push_back(dijkstra.DescribePath(single, settings.metric));
+        return results;
+    }
+    
+    std::vector<Candidate> candidates;
+    std::set<std::vector<int>> seen;
+    PriorityQueue<int, double> pq;
+    
+    Candidate first;
+    first.deviation = 0;
+    if (!findSpur(query, start, end, std::vector<int>(), first.path, first.cost)) {
+        return results;
+    }
+    seen.insert(first.path);
+    candidates.push_back(std::move(first));
+    pq.Enqueue(0, candidates[0].cost);
+    
+    int limit = settings.maxCandidates > 0 ? settings.maxCandidates : 20 * settings.k;
+    std::vector<int> found;                          //извлечённые пути по порядку стоимости
+    std::vector<DynamicArray<int>> accepted;
+    std::vector<int> blockedNext;
+    std::vector<int> spurPath;
+    
+    while (!pq.IsEmpty() && static_cast<int>(results.size()) < settings.k
+           && static_cast<int>(found.size()) < limit) {
+        int index = pq.Dequeue();
+        found.push_back(index);
+        
+        DynamicArray<int> path;
+        for (int vertex : candidates[index].path) {
+            path.Append(vertex);
+        }
+        
+        bool diverse = true;
+        for (const DynamicArray<int>& other : accepted) {
+            if (SharedLaneFraction(path, other) > settings.maxSharedFraction) {
+                diverse = false;
+                break;
+            }
+        }
+        if (diverse) {
+            results.push_back(dijkstra.DescribePath(path, settings.metric));
+            accepted.push_back(path);
+        }
+        
+        //копия: вектор кандидатов растёт внутри цикла
+        std::vector<int> current = candidates[index].path;
+        int deviation = candidates[index].deviation;
+        int length = static_cast<int>(current.size());
+        
+        double rootCost = 0.0;
+        for (int j = 0; j < deviation; j++) {
+            rootCost += laneWeight(current[j], current[j + 1]);
+            query.blocked[query.index[current[j]]] = 1;
+        }
+        
+        //ответвления до индекса отклонения уже перебраны у предков (Лоулер)
+        for (int j = deviation; j < length - 1; j++) {
+            blockedNext.clear();
+            for (int other : found) {
+                const std::vector<int>& prefix = candidates[other].path;
+                if (static_cast<int>(prefix.size()) > j + 1
+                    && std::equal(current.begin(), current.begin() + j + 1, prefix.begin())) {
+                    blockedNext.push_back(prefix[j + 1]);
+                }
+            }
+            
+            double spurCost;
+            if (findSpur(query, current[j], end, blockedNext, spurPath, spurCost)) {
+                Candidate candidate;
+                candidate.path.assign(current.begin(), current.begin() + j);
+                candidate.path.insert(candidate.path.end(), spurPath.begin(), spurPath.end());
+                candidate.cost = rootCost + spurCost;
+                candidate.deviation = j;
+                
+                if (seen.insert(candidate.path).second) {
+                    candidates.push_back(std::move(candidate));
+                    int added = static_cast<int>(candidates.size()) - 1;
+                    pq.Enqueue(added, candidates[added].cost);
+                }
+            }
+            
+            rootCost += laneWeight(current[j], current[j + 1]);
+            query.blocked[query.index[current[j]]] = 1;
+        }
+        
+        for (int j = 0; j < length - 1; j++) {
+            query.blocked[query.index[current[j]]] = 0;
+        }
+    }
+    
+    return results;
+}
+
+std::vector<DijkstraResult> KShortestPaths::FindPaths(const std::string& startName,
+                                                      const std::string& endName) const {
+    try {
+        return FindPaths(graph.GetVertexIndex(startName), graph.GetVertexIndex(endName));
+    } catch (const std::exception& e) {
+        return std::vector<DijkstraResult>();
+    }
+}
@@ -0,0 +1,151 @@
+#include "ParetoRouter.h"
+#include "PriorityQueue.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <utility>
+
+//paretoRoute реализация
+ParetoRoute::ParetoRoute() : distance(0.0), riskWeight(0.0), encounterProbability(0.0) {}
+
+//paretoRouter реализация
+ParetoRouter::Settings::Settings()
+    : maxLabelsPerVertex(0), maxRoutes(0), maxDistance(std::numeric_limits<double>::infinity()) {}
+
+ParetoRouter::ParetoRouter(const StarGraph& g, const Settings& routerSettings)
+    : graph(g), settings(routerSettings), lastLabelCount(0) {}
+
+double ParetoRouter::RiskWeight(double riskFactor) {
+    return EdgeData::computeSurvivalCost(riskFactor);
+}
+
+bool ParetoRouter::isDominated(const std::vector<Label>& pool, const std::vector<int>& bag,
+                               double distance, double risk) {
+    //последняя метка с расстоянием <= distance имеет наименьший риск среди таких
+    auto it = std::upper_bound(bag.begin(), bag.end(), distance,
+        [&pool](double value, int label) { return value < pool[label].distance; });
+    return it != bag.begin() && pool[*(it - 1)].risk <= risk;
+}
+
+bool ParetoRouter::insertLabel(std::vector<Label>& pool, std::vector<int>& bag, int label, int maxLabels) {
+    double distance = pool[label].distance;
+    double risk = pool[label].risk;
+    if (isDominated(pool, bag, distance, risk)) {
+        return false;
+    }
+    
+    //вытесняемые метки (расстояние >= и риск >=) идут подряд с позиции вставки
+    auto first = std::lower_bound(bag.begin(), bag.end(), distance,
+        [&pool](int existing, double value) { return pool[existing].distance < value; });
+    auto last = first;
+    while (last != bag.end() && pool[*last].risk >= risk) {
+        pool[*last].alive = false;
+        ++last;
+    }
+    first = bag.erase(first, last);
+    
+    if (maxLabels > 0 && static_cast<int>(bag.size()) >= maxLabels) {
+        return false;
+    }
+    bag.insert(first, label);
+    return true;
+}
+
+std::vector<ParetoRoute> ParetoRouter::FindParetoFront(int start, int end) const {
+    std::vector<ParetoRoute> front;
+    lastLabelCount = 0;
+    
+    if (!graph.HasVertex(start) || !graph.HasVertex(end)) {
+        return front;
+    }
+    
+    std::vector<Label> pool;
+    std::unordered_map<int, std::vector<int>> bags;
+    bags.reserve(graph.GetVertexCount());
+    pool.reserve(graph.GetVertexCount() * 2);
+    
+    pool.push_back(Label{0.0, 0.0, start, -1, -1, true});
+    bags[start].push_back(0);
+    
+    //лексикографический порядок: метка извлекается раньше всех, кто мог бы её доминировать
+    using Key = std::pair<double, double>;
+    PriorityQueue<int, Key> pq(std::less<Key>{});
+    pq.Enqueue(0, Key(0.0, 0.0));
+    
+    std::vector<int>& target = bags[end];
+    
+    while (!pq.IsEmpty()) {
+        int index = pq.Dequeue();
+        Label current = pool[index];   //копия: пул растёт по ходу цикла
+        
+        if (!current.alive || current.vertex == end) {
+            continue;
+        }
+        
+        const DynamicArray<Edge>& edges = graph.GetEdges(current.vertex);
+        for (int i = 0; i < edges.GetSize(); i++) {
+            const Edge& edge = edges[i];
+            double distance = current.distance + edge.data.distance;
+            double risk = current.risk + edge.data.survivalCost;
+            
+            //то, что вышло за бюджет или уже хуже найденного маршрута до цели, не продолжаем
+            if (distance > settings.maxDistance || isDominated(pool, target, distance, risk)) {
+                continue;
+            }
+            
+            pool.push_back(Label{distance, risk, edge.to, index, i, true});
+            int label = static_cast<int>(pool.size()) - 1;
+            if (insertLabel(pool, bags[edge.to], label, settings.maxLabelsPerVertex)) {
+                pq.Enqueue(label, Key(distance, risk));
+            } else {
+                pool.pop_back();
+            }
+        }
+    }
+    
+    lastLabelCount = static_cast<int>(pool.size());
+    
+    //прореживание фронта: равномерно по расстоянию, крайние маршруты сохраняются
+    std::vector<int> chosen(target.begin(), target.end());
+    if (settings.maxRoutes > 0 && static_cast<int>(chosen.size()) > settings.maxRoutes) {
+        std::vector<int> thinned;
+        int count = static_cast<int>(chosen.size());
+        for (int k = 0; k < settings.maxRoutes; k++) {
+            int position = settings.maxRoutes == 1 ? 0
+                : static_cast<int>(std::lround(static_cast<double>(k) * (count - 1) / (settings.maxRoutes - 1)));
+            thinned.push_back(chosen[position]);
+        }
+        chosen.swap(thinned);
+    }
+    
+    for (int label : chosen) {
+        ParetoRoute route;
+        route.distance = pool[label].distance;
+        route.riskWeight = pool[label].risk;
+        route.encounterProbability = -std::expm1(-route.riskWeight);
+        
+        //маршруты фронта с одинаковыми планетами различаются параллельными рёбрами
+        for (int current = label; current != -1; current = pool[current].parent) {
+            route.path.Prepend(pool[current].vertex);
+            if (pool[current].parent != -1) {
+                route.lanes.Prepend(pool[current].edge);
+            }
+        }
+        for (int i = 0; i < route.path.GetSize(); i++) {
+            route.pathNames.Append(graph.GetVertexName(route.path.Get(i)));
+        }
+        front.push_back(std::move(route));
+    }
+    
+    return front;
+}
+
+std::vector<ParetoRoute> ParetoRouter::FindParetoFront(const std::string& startName,
+                                                       const std::string& endName) const {
+    try {
+        return FindParetoFront(graph.GetVertexIndex(startName), graph.GetVertexIndex(endName));
+    } catch (const std::exception& e) {
+        return std::vector<ParetoRoute>();
+    }
+}
@@ -0,0 +1,180 @@
+#include "PlanetNameIndex.h"
+#include <algorithm>
+#include <climits>
+#include <vector>
+
+std::string PlanetNameIndex::FoldCase(const std::string& text) {
+    std::string result;
+    result.reserve(text.size());
+    
+    for (size_t i = 0; i < text.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        
+        //латиница
+        if (c >= 'A' && c <= 'Z') {
+            result += static_cast<char>(c - 'A' + 'a');
+            continue;
+        }
+        
+        //кириллица: заглавные буквы кодируются как D0 81, D0 90..D0 AF
+        if (c == 0xD0 && i + 1 < text.size()) {
+            unsigned char next = static_cast<unsigned char>(text[i + 1]);
+            if (next >= 0x90 && next <= 0x9F) {          //А..П -> а..п
+                result += static_cast<char>(0xD0);
+                result += static_cast<char>(next + 0x20);
+                i++;
+                continue;
+            }
+            if (next >= 0xA0 && next <= 0xAF) {          //Р..Я -> р..я
+                result += static_cast<char>(0xD1);
+                result += static_cast<char>(next - 0x20);
+                i++;
+                continue;
+            }
+            if (next == 0x81) {                          //Ё -> ё
+                result += static_cast<char>(0xD1);
+                result += static_cast<char>(0x91);
+                i++;
+                continue;
+            }
+        }
+        
+        result += static_cast<char>(c);
+    }
+    
+    return result;
+}
+
+std::unordered_set<std::string> PlanetNameIndex::extractTrigrams(const std::string& foldedName) {
+    //границы символов UTF-8, имя дополняется пробелами с краев,
+    //чтобы начало и конец слова тоже давали триграммы
+    std::string padded = " " + foldedName + " ";
+    std::vector<size_t> starts;
+    for (size_t i = 0; i < padded.size(); i++) {
+        if ((static_cast<unsigned char>(padded[i]) & 0xC0) != 0x80) {
+            starts.push_back(i);
+        }
+    }
+    starts.push_back(padded.size());
+    
+    std::unordered_set<std::string> trigrams;
+    for (size_t i = 0; i + 3 < starts.size(); i++) {
+        trigrams.insert(padded.substr(starts[i], starts[i + 3] - starts[i]));
+    }
+    return trigrams;
+}
+
+void PlanetNameIndex::Insert(const std::string& name, int id) {
+    std::string folded = FoldCase(name);
+    sortedNames.insert(std::make_pair(folded, id));
+    
+    std::unordered_set<std::string> trigrams = extractTrigrams(folded);
+    for (const auto& trigram : trigrams) {
+        trigramPostings[trigram].insert(id);
+    }
+    trigramCount[id] = static_cast<int>(trigrams.size());
+}
+
+void PlanetNameIndex::Remove(const std::string& name, int id) {
+    std::string folded = FoldCase(name);
+    sortedNames.erase(std::make_pair(folded, id));
+    
+    for (const auto& trigram : extractTrigrams(folded)) {
+        auto it = trigramPostings.find(trigram);
+        if (it == trigramPostings.end()) {
+            continue;
+        }
+        it->second.erase(id);
+        if (it->second.empty()) {
+            trigramPostings.erase(it);
+        }
+    }
+    trigramCount.erase(id);
+}
+
+void PlanetNameIndex::Clear() {
+    sortedNames.clear();
+    trigramPostings.clear();
+    trigramCount.clear();
+}
+
+DynamicArray<int> PlanetNameIndex::FindByPrefix(const std::string& prefix, int limit) const {
+    DynamicArray<int> result;
+    std::string folded = FoldCase(prefix);
+    
+    //все имена с префиксом лежат подряд, начиная с lower_bound
+    auto it = sortedNames.lower_bound(std::make_pair(folded, INT_MIN));
+    while (it != sortedNames.end() && result.GetSize() < limit) {
+        if (it->first.compare(0, folded.size(), folded) != 0) {
+            break;
+        }
+        result.Append(it->second);
+        ++it;
+    }
+    return result;
+}
+
+DynamicArray<int> PlanetNameIndex::FindFuzzy(const std::string& query, int limit) const {
+    DynamicArray<int> result;
+    std::unordered_set<std::string> queryTrigrams = extractTrigrams(FoldCase(query));
+    if (queryTrigrams.empty() || limit <= 0) {
+        return result;
+    }
+    
+    //считаем общие триграммы для каждой планеты-кандидата
+    std::unordered_map<int, int> shared;
+    for (const auto& trigram : queryTrigrams) {
+        auto it = trigramPostings.find(trigram);
+        if (it == trigramPostings.end()) {
+            continue;
+        }
+        for (int id : it->second) {
+            shared[id]++;
+        }
+    }
+    
+    //сходство Жаккара: |A ∩ B| / |A ∪ B|
+    std::vector<std::pair<double, int>> scored;
+    scored.reserve(shared.size());
+    int querySize = static_cast<int>(queryTrigrams.size());
+    for (const auto& pair : shared) {
+        int nameSize = trigramCount.at(pair.first);
+        double score = static_cast<double>(pair.second) / (querySize + nameSize - pair.second);
+        scored.push_back(std::make_pair(score, pair.first));
+    }
+    
+    auto better = [](const std::pair<double, int>& a, const std::pair<double, int>& b) {
+        if (a.first != b.first) {
+            return a.first > b.first;
+        }
+        return a.second < b.second;
+    };
+    
+    size_t count = std::min(scored.size(), static_cast<size_t>(limit));
+    std::partial_sort(scored.begin(), scored.begin() + count, scored.end(), better);
+    for (size_t i = 0; i < count; i++) {
+        result.Append(scored[i].second);
+    }
+    return result;
+}
+
+DynamicArray<int> PlanetNameIndex::Search(const std::string& query, int limit) const {
+    DynamicArray<int> result = FindByPrefix(query, limit);
+    if (result.GetSize() >= limit || query.empty()) {
+        return result;
+    }
+    
+    std::unordered_set<int> seen;
+    for (int i = 0; i < result.GetSize(); i++) {
+        seen.insert(result.Get(i));
+    }
+    
+    //добираем нечеткими совпадениями, пропуская уже найденные по префиксу
+    DynamicArray<int> fuzzy = FindFuzzy(query, limit + result.GetSize());
+    for (int i = 0; i < fuzzy.GetSize() && result.GetSize() < limit; i++) {
+        if (seen.find(fuzzy.Get(i)) == seen.end()) {
+            result.Append(fuzzy.Get(i));
+        }
+    }
+    return result;
+}
@@ -4,6 +4,8 @@
 #include <sstream>
 #include <iomanip>
 #include <vector>
+#include <algorithm>
+#include <cmath>
 
 //planetData реализация
 PlanetData::PlanetData() : name(""), id(-1), hasArtifact(false) {}
@@ -12,14 +14,30 @@ PlanetData::PlanetData(const std::string& planetName, int planetId, bool artifac
     : name(planetName), id(planetId), hasArtifact(artifact) {}
 
 //edgeData реализация
-EdgeData::EdgeData() : distance(0.0), riskFactor(0.0) {}
+EdgeData::EdgeData() : distance(0.0), riskFactor(0.0), survivalCost(0.0) {}
 
-EdgeData::EdgeData(double dist, double risk) : distance(dist), riskFactor(risk) {}
+EdgeData::EdgeData(double dist, double risk)
+    : distance(dist), riskFactor(risk), survivalCost(computeSurvivalCost(risk)) {}
+
+EdgeData::EdgeData(double dist, double risk, std::shared_ptr<const TimeProfile> timeProfile)
+    : distance(dist), riskFactor(risk), survivalCost(computeSurvivalCost(risk)),
+      profile(std::move(timeProfile)) {}
 
 double EdgeData::getTotalCost() const {
     return distance * (1.0 + riskFactor);
 }
 
+double EdgeData::getSurvivalProbability() const {
+    return std::exp(-survivalCost);
+}
+
+double EdgeData::computeSurvivalCost(double risk) {
+    //риск 1.0 - встреча неизбежна, но вес остаётся конечным (путь всё ещё возможен)
+    const double MAX_RISK = 1.0 - 1e-9;
+    risk = std::min(std::max(risk, 0.0), MAX_RISK);
+    return -std::log1p(-risk);
+}
+
 bool EdgeData::operator<(const EdgeData& other) const {
     return getTotalCost() < other.getTotalCost();
 }
@@ -39,7 +57,17 @@ Edge::Edge(int source, int destination, EdgeData edgeData)
     : from(source), to(destination), data(edgeData) {}
 
 //starGraph реализация
-StarGraph::StarGraph() : vertexCount(0), nextVertexId(0) {}
+StarGraph::StarGraph() 
+    : vertexCount(0), edgeCount(0), nextVertexId(0), version(0), topologyVersion(0) {}
+
+void StarGraph::markChanged() {
+    version++;
+}
+
+void StarGraph::markTopologyChanged() {
+    topologyVersion++;
+    markChanged();
+}
 
 int StarGraph::AddVertex(const std::string& name) {
     //проверка на дубликат имени
@@ -50,8 +78,12 @@ int StarGraph::AddVertex(const std::string& name) {
     int id = nextVertexId++;
     planetData[id] = PlanetData(name, id);
     nameToIndex[name] = id;
+    nameIndex.Insert(name, id);
     adjacencyList[id] = DynamicArray<Edge>();
+    inDegree[id] = 0;
+    vertexArray.Append(id);   //id растут - массив остаётся упорядоченным
     vertexCount++;
+    markTopologyChanged();
     
     return id;
 }
@@ -65,6 +97,9 @@ void StarGraph::AddEdge(int from, int to, const EdgeData& edgeData) {
     }
     
     adjacencyList[from].Append(Edge(from, to, edgeData));
+    inDegree[to]++;
+    edgeCount++;
+    markTopologyChanged();
 }
 
 void StarGraph::AddEdge(const std::string& fromName, const std::string& toName, const EdgeData& edgeData) {
@@ -96,14 +131,27 @@ void StarGraph::RemoveVertex(int vertex) {
                 newEdges.Append(edges.Get(i));
             }
         }
+        edgeCount -= edges.GetSize() - newEdges.GetSize();
         pair.second = newEdges;
     }
     
+    //исходящие ребра вершины больше не входят в свои цели
+    const DynamicArray<Edge>& outgoing = adjacencyList[vertex];
+    for (int i = 0; i < outgoing.GetSize(); i++) {
+        inDegree[outgoing.Get(i).to]--;
+    }
+    edgeCount -= outgoing.GetSize();
+    
     //удаляем саму вершину и её исходящие ребра
     adjacencyList.erase(vertex);
+    inDegree.erase(vertex);
     planetData.erase(vertex);
     nameToIndex.erase(vertexName);
+    nameIndex.Remove(vertexName, vertex);
+    const int* first = &vertexArray[0];
+    vertexArray.RemoveAt(static_cast<int>(std::lower_bound(first, first + vertexArray.GetSize(), vertex) - first));
     vertexCount--;
+    markTopologyChanged();
 }
 
 void StarGraph::RemoveVertex(const std::string& name) {
@@ -131,7 +179,12 @@ void StarGraph::RemoveEdge(int from, int to) {
         }
     }
     
+    int removed = edges.GetSize() - newEdges.GetSize();
+    inDegree[to] -= removed;
+    edgeCount -= removed;
+    
     adjacencyList[from] = newEdges;
+    markTopologyChanged();
 }
 
 void StarGraph::RemoveEdge(const std::string& fromName, const std::string& toName) {
@@ -163,6 +216,7 @@ void StarGraph::UpdateEdgeDistance(int from, int to, double newDistance) {
     for (int i = 0; i < edges.GetSize(); i++) {
         if (edges[i].to == to) {
             edges[i].data.distance = newDistance;
+            markChanged();
             return;
         }
     }
@@ -170,6 +224,23 @@ void StarGraph::UpdateEdgeDistance(int from, int to, double newDistance) {
     //ребро не найдено - это нормально, может его просто нет
 }
 
+void StarGraph::SetEdgeProfile(int from, int to, std::shared_ptr<const TimeProfile> profile) {
+    auto it = adjacencyList.find(from);
+    if (it == adjacencyList.end()) {
+        throw std::invalid_argument("Source vertex does not exist");
+    }
+    
+    DynamicArray<Edge>& edges = it->second;
+    for (int i = 0; i < edges.GetSize(); i++) {
+        if (edges[i].to == to) {
+            edges[i].data.profile = std::move(profile);
+            markChanged();
+            return;
+        }
+    }
+    throw std::invalid_argument("Edge does not exist");
+}
+
 const DynamicArray<Edge>& StarGraph::GetEdges(int vertex) const {
     auto it = adjacencyList.find(vertex);
     if (it == adjacencyList.end()) {
@@ -215,6 +286,7 @@ void StarGraph::SetArtifact(int vertex, bool hasArtifact) {
         throw std::invalid_argument("Vertex does not exist");
     }
     planetData[vertex].hasArtifact = hasArtifact;
+    markChanged();
 }
 
 bool StarGraph::HasArtifact(int vertex) const {
@@ -237,12 +309,32 @@ int StarGraph::GetVertexCount() const {
     return vertexCount;
 }
 
-DynamicArray<int> StarGraph::GetAllVertices() const {
-    DynamicArray<int> vertices;
-    for (const auto& pair : adjacencyList) {
-        vertices.Append(pair.first);
+int StarGraph::GetInDegree(int vertex) const {
+    auto it = inDegree.find(vertex);
+    if (it == inDegree.end()) {
+        throw std::invalid_argument("Vertex does not exist");
     }
-    return vertices;
+    return it->second;
+}
+
+int StarGraph::GetOutDegree(int vertex) const {
+    return GetEdges(vertex).GetSize();
+}
+
+int StarGraph::GetDegree(int vertex) const {
+    return GetInDegree(vertex) + GetOutDegree(vertex);
+}
+
+DynamicArray<int> StarGraph::GetAllVertices() const {
+    return GetVertexArray();
+}
+
+VertexRange StarGraph::Vertices() const {
+    return VertexRange(adjacencyList.begin(), adjacencyList.end());
+}
+
+const DynamicArray<int>& StarGraph::GetVertexArray() const {
+    return vertexArray;
 }
 
 const std::unordered_map<int, std::string>& StarGraph::GetAllPlanets() const {
@@ -255,12 +347,29 @@ const std::unordered_map<int, std::string>& StarGraph::GetAllPlanets() const {
     return namesMap;
 }
 
+DynamicArray<int> StarGraph::FindVerticesByPrefix(const std::string& prefix, int limit) const {
+    return nameIndex.FindByPrefix(prefix, limit);
+}
+
+DynamicArray<int> StarGraph::FindVerticesFuzzy(const std::string& query, int limit) const {
+    return nameIndex.FindFuzzy(query, limit);
+}
+
+DynamicArray<int> StarGraph::SearchVertices(const std::string& query, int limit) const {
+    return nameIndex.Search(query, limit);
+}
+
 void StarGraph::Clear() {
     adjacencyList.clear();
+    inDegree.clear();
     planetData.clear();
     nameToIndex.clear();
+    nameIndex.Clear();
+    vertexArray.Clear();
     vertexCount = 0;
+    edgeCount = 0;
     nextVertexId = 0;
+    markTopologyChanged();
 }
 
 //═══════════════════════════════════════════════════════════
@@ -0,0 +1,159 @@
+#include "TimeDependentRouter.h"
+#include "PriorityQueue.h"
+#include <stdexcept>
+
+//timeDependentResult реализация
+TimeDependentResult::TimeDependentResult()
+    : pathExists(false), departureTime(0.0), arrivalTime(TimeProfile::NEVER) {}
+
+//timeDependentRouter реализация
+TimeDependentRouter::TimeDependentRouter(const StarGraph& g, double travelSpeed)
+    : graph(g), speed(travelSpeed) {
+    if (speed <= 0.0) {
+        throw std::invalid_argument("Travel speed must be positive");
+    }
+}
+
+double TimeDependentRouter::arrivalAlong(const EdgeData& data, double ready, double& departure) const {
+    double staticTravelTime = data.distance / speed;
+    if (!data.profile) {
+        departure = ready;
+        return ready + staticTravelTime;
+    }
+    return data.profile->EarliestArrival(ready, staticTravelTime, &departure);
+}
+
+TimeDependentResult TimeDependentRouter::FindEarliestArrival(int start, int end, double departureTime) const {
+    TimeDependentResult result;
+    result.departureTime = departureTime;
+    
+    if (!graph.HasVertex(start) || !graph.HasVertex(end)) {
+        return result;
+    }
+    
+    std::unordered_map<int, double> arrival;
+    std::unordered_map<int, int> previous;
+    std::unordered_map<int, double> leftPrevious;   //когда торговец покинул предшественника
+    std::unordered_map<int, bool> visited;
+    
+    arrival.reserve(graph.GetVertexCount());
+    visited.reserve(graph.GetVertexCount());
+    for (int vertex : graph.Vertices()) {
+        arrival[vertex] = TimeProfile::NEVER;
+        visited[vertex] = false;
+    }
+    
+    arrival[start] = departureTime;
+    
+    PriorityQueue<int, double> pq;
+    pq.Enqueue(start, departureTime);
+    
+    while (!pq.IsEmpty()) {
+        int current = pq.Dequeue();
+        
+        if (visited[current]) {
+            continue;
+        }
+        
+        visited[current] = true;
+        
+        if (current == end) {
+            break;
+        }
+        
+        const DynamicArray<Edge>& edges = graph.GetEdges(current);
+        for (int i = 0; i < edges.GetSize(); i++) {
+            const Edge& edge = edges[i];
+            int neighbor = edge.to;
+            
+            double departure;
+            double newArrival = arrivalAlong(edge.data, arrival[current], departure);
+            if (newArrival < arrival[neighbor]) {
+                arrival[neighbor] = newArrival;
+                previous[neighbor] = current;
+                leftPrevious[neighbor] = departure;
+                pq.Enqueue(neighbor, newArrival);
+            }
+        }
+    }
+    
+    result.arrivalTime = arrival[end];
+    result.pathExists = (result.arrivalTime != TimeProfile::NEVER);
+    
+    if (result.pathExists) {
+        //восстанавливаем путь и моменты отправления от конца к началу
+        int current = end;
+        while (current != start) {
+            result.path.Prepend(current);
+            result.departures.Prepend(leftPrevious[current]);
+            current = previous[current];
+        }
+        result.path.Prepend(start);
+        result.departures.Append(result.arrivalTime);   //в конечной вершине - момент прибытия
+        
+        for (int i = 0; i < result.path.GetSize(); i++) {
+            result.pathNames.Append(graph.GetVertexName(result.path.Get(i)));
+        }
+    }
+    
+    return result;
+}
+
+TimeDependentResult TimeDependentRouter::FindEarliestArrival(const std::string& startName,
+                                                             const std::string& endName,
+                                                             double departureTime) const {
+    try {
+        int start = graph.GetVertexIndex(startName);
+        int end = graph.GetVertexIndex(endName);
+        return FindEarliestArrival(start, end, departureTime);
+    } catch (const std::exception& e) {
+        TimeDependentResult result;
+        result.departureTime = departureTime;
+        return result;
+    }
+}
+
+std::unordered_map<int, double> TimeDependentRouter::FindAllEarliestArrivals(int start,
+                                                                            double departureTime) const {
+    std::unordered_map<int, double> arrival;
+    std::unordered_map<int, bool> visited;
+    
+    arrival.reserve(graph.GetVertexCount());
+    visited.reserve(graph.GetVertexCount());
+    for (int vertex : graph.Vertices()) {
+        arrival[vertex] = TimeProfile::NEVER;
+        visited[vertex] = false;
+    }
+    
+    if (!graph.HasVertex(start)) {
+        return arrival;
+    }
+    
+    arrival[start] = departureTime;
+    
+    PriorityQueue<int, double> pq;
+    pq.Enqueue(start, departureTime);
+    
+    while (!pq.IsEmpty()) {
+        int current = pq.Dequeue();
+        
+        if (visited[current]) {
+            continue;
+        }
+        
+        visited[current] = true;
+        
+        const DynamicArray<Edge>& edges = graph.GetEdges(current);
+        for (int i = 0; i < edges.GetSize(); i++) {
+            const Edge& edge = edges[i];
+            double departure;
+            double newArrival = arrivalAlong(edge.data, arrival[current], departure);
+            if (newArrival < arrival[edge.to]) {
+                arrival[edge.to] = newArrival;
+                pq.Enqueue(edge.to, newArrival);
+            }
+        }
+    }
+    
+    return arrival;
+}
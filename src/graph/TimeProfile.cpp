@@ -0,0 +1,128 @@
+#include "TimeProfile.h"
+#include <algorithm>
+#include <stdexcept>
+
+//timeProfile реализация
+TimeProfile::TimeProfile() {}
+
+void TimeProfile::AddPoint(double time, double travelTime) {
+    if (travelTime < 0.0) {
+        throw std::invalid_argument("Travel time must be non-negative");
+    }
+    
+    auto position = std::lower_bound(points.begin(), points.end(), time,
+        [](const Point& point, double value) { return point.time < value; });
+    if (position != points.end() && position->time == time) {
+        position->travelTime = travelTime;
+        return;
+    }
+    points.insert(position, Point{time, travelTime});
+}
+
+void TimeProfile::AddClosure(double from, double to) {
+    if (!(from < to)) {
+        throw std::invalid_argument("Closure must end after it starts");
+    }
+    
+    //пересекающиеся и соприкасающиеся закрытия сливаются в одно
+    Closure merged{from, to};
+    std::vector<Closure> result;
+    result.reserve(closures.size() + 1);
+    bool inserted = false;
+    for (const Closure& closure : closures) {
+        if (closure.to < merged.from) {
+            result.push_back(closure);
+        } else if (closure.from > merged.to) {
+            if (!inserted) {
+                result.push_back(merged);
+                inserted = true;
+            }
+            result.push_back(closure);
+        } else {
+            merged.from = std::min(merged.from, closure.from);
+            merged.to = std::max(merged.to, closure.to);
+        }
+    }
+    if (!inserted) {
+        result.push_back(merged);
+    }
+    closures.swap(result);
+}
+
+double TimeProfile::TravelTime(double departure, double staticTravelTime) const {
+    if (points.empty()) {
+        return staticTravelTime;
+    }
+    if (departure <= points.front().time) {
+        return points.front().travelTime;
+    }
+    if (departure >= points.back().time) {
+        return points.back().travelTime;
+    }
+    
+    //линейная интерполяция между соседними точками
+    auto next = std::upper_bound(points.begin(), points.end(), departure,
+        [](double value, const Point& point) { return value < point.time; });
+    const Point& right = *next;
+    const Point& left = *(next - 1);
+    double share = (departure - left.time) / (right.time - left.time);
+    return left.travelTime + (right.travelTime - left.travelTime) * share;
+}
+
+bool TimeProfile::IsOpen(double time) const {
+    //первое закрытие, которое заканчивается позже time
+    auto it = std::upper_bound(closures.begin(), closures.end(), time,
+        [](double value, const Closure& closure) { return value < closure.to; });
+    return it == closures.end() || time <= it->from;
+}
+
+double TimeProfile::EarliestArrival(double ready, double staticTravelTime, double* departure) const {
+    //без закрытий и будущих точек функция постоянна - ждать бессмысленно
+    if (closures.empty() && (points.empty() || points.back().time <= ready)) {
+        if (departure) {
+            *departure = ready;
+        }
+        return ready + TravelTime(ready, staticTravelTime);
+    }
+    
+    //arrival(d) = d + travelTime(d) линейна между точками и границами закрытий,
+    //поэтому минимум по d >= ready достигается в ready или в одной из этих границ
+    std::vector<double> candidates;
+    candidates.push_back(ready);
+    for (const Point& point : points) {
+        if (point.time > ready) {
+            candidates.push_back(point.time);
+        }
+    }
+    for (const Closure& closure : closures) {
+        if (closure.from > ready) {
+            candidates.push_back(closure.from);
+        }
+        if (closure.to > ready && closure.to != NEVER) {
+            candidates.push_back(closure.to);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    
+    double best = NEVER;
+    double bestDeparture = NEVER;
+    for (double candidate : candidates) {
+        //длительность неотрицательна: позже отправившись, раньше best не прибыть
+        if (candidate >= best) {
+            break;
+        }
+        if (!IsOpen(candidate)) {
+            continue;
+        }
+        double arrival = candidate + TravelTime(candidate, staticTravelTime);
+        if (arrival < best) {
+            best = arrival;
+            bestDeparture = candidate;
+        }
+    }
+    
+    if (departure) {
+        *departure = bestDeparture;
+    }
+    return best;
+}
@@ -0,0 +1,409 @@
+#include "TourPlanner.h"
+#include "PriorityQueue.h"
+#include "Xoshiro256.h"
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+static const double INF = std::numeric_limits<double>::infinity();
+static const double UNREACHABLE_COST = 1e12;   //вместо бесконечности в матрице: разности остаются конечными
+static const double IMPROVEMENT_EPSILON = 1e-9;
+static const int OR_OPT_MAX_SEGMENT = 3;       //длины переносимых цепочек 1..3
+static const int RANDOM_CHOICES = 3;           //рандомизированный сосед - из трёх ближайших
+
+//tourPlan реализация
+TourPlan::TourPlan() : feasible(false), timedOut(false), totalCost(0.0) {}
+
+//tourPlanner реализация
+TourPlanner::Settings::Settings()
+    : metric(RouteMetric::Cost), returnToStart(false), threadCount(0), constructions(0), timeBudgetMs(500.0) {}
+
+TourPlanner::TourPlanner(const StarGraph& g, const Settings& plannerSettings)
+    : graph(g), settings(plannerSettings) {
+    if (settings.threadCount <= 0) {
+        settings.threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    if (settings.constructions <= 0) {
+        settings.constructions = std::max(3, settings.threadCount);
+    }
+}
+
+void TourPlanner::searchFrom(const Adjacency& adjacency, int source, const std::vector<int>& goals,
+                             std::vector<double>& distance, std::vector<int>& parent) {
+    int n = static_cast<int>(adjacency.offsets.size()) - 1;
+    distance.assign(n, INF);
+    parent.assign(n, -1);
+    std::vector<char> settled(n, 0);
+    std::vector<char> isGoal(n, 0);
+    int remaining = 0;
+    for (int goal : goals) {
+        if (!isGoal[goal]) {
+            isGoal[goal] = 1;
+            remaining++;
+        }
+    }
+    
+    distance[source] = 0.0;
+    PriorityQueue<int, double> pq;
+    pq.Enqueue(source, 0.0);
+    
+    while (!pq.IsEmpty() && remaining > 0) {
+        int current = pq.Dequeue();
+        if (settled[current]) {
+            continue;
+        }
+        settled[current] = 1;
+        if (isGoal[current]) {
+            remaining--;
+        }
+        
+        for (int i = adjacency.offsets[current]; i < adjacency.offsets[current + 1]; i++) {
+            int neighbor = adjacency.targets[i];
+            double newDistance = distance[current] + adjacency.weights[i];
+            if (newDistance < distance[neighbor]) {
+                distance[neighbor] = newDistance;
+                parent[neighbor] = current;
+                pq.Enqueue(neighbor, newDistance);
+            }
+        }
+    }
+}
+
+std::vector<int> TourPlanner::nearestNeighbor(const Matrix& matrix, unsigned seed, int choices) {
+    int finish = matrix.size - 1;
+    std::vector<int> tour{0};
+    std::vector<char> visited(matrix.size, 0);
+    visited[0] = 1;
+    Xoshiro256 random(seed);
+    
+    for (int step = 1; step < finish; step++) {
+        //несколько ближайших непосещённых, выбирается случайный из них (choices = 1 - жадно)
+        int from = tour.back();
+        std::vector<int> nearest;
+        for (int to = 1; to < finish; to++) {
+            if (visited[to]) {
+                continue;
+            }
+            auto it = std::upper_bound(nearest.begin(), nearest.end(), to,
+                [&matrix, from](int a, int b) { return matrix(from, a) < matrix(from, b); });
+            nearest.insert(it, to);
+            if (static_cast<int>(nearest.size()) > choices) {
+                nearest.pop_back();
+            }
+        }
+        int next = nearest[random.NextBelow(nearest.size())];
+        visited[next] = 1;
+        tour.push_back(next);
+    }
+    
+    tour.push_back(finish);
+    return tour;
+}
+
+std::vector<int> TourPlanner::cheapestInsertion(const Matrix& matrix) {
+    //обход как список преемников; для каждой невставленной цели помним лучшее место
+    int finish = matrix.size - 1;
+    std::vector<int> next(matrix.size, -1);
+    next[0] = finish;
+    
+    std::vector<double> bestDelta(matrix.size, INF);
+    std::vector<int> bestAfter(matrix.size, -1);
+    std::vector<char> inserted(matrix.size, 0);
+    
+    auto recompute = [&](int node) {
+        bestDelta[node] = INF;
+        for (int after = 0; after != finish; after = next[after]) {
+            double delta = matrix(after, node) + matrix(node, next[after]) - matrix(after, next[after]);
+            if (delta < bestDelta[node]) {
+                bestDelta[node] = delta;
+                bestAfter[node] = after;
+            }
+        }
+    };
+    for (int node = 1; node < finish; node++) {
+        recompute(node);
+    }
+    
+    for (int step = 1; step < finish; step++) {
+        int node = -1;
+        for (int candidate = 1; candidate < finish; candidate++) {
+            if (!inserted[candidate] && (node == -1 || bestDelta[candidate] < bestDelta[node])) {
+                node = candidate;
+            }
+        }
+        
+        int after = bestAfter[node];
+        int before = next[after];
+        next[node] = before;
+        next[after] = node;
+        inserted[node] = 1;
+        
+        //ребро after -> before исчезло: его кандидатам нужен полный пересчёт,
+        //остальным достаточно проверить два новых ребра
+        for (int candidate = 1; candidate < finish; candidate++) {
+            if (inserted[candidate]) {
+                continue;
+            }
+            if (bestAfter[candidate] == after) {
+                recompute(candidate);
+                continue;
+            }
+            double viaAfter = matrix(after, candidate) + matrix(candidate, node) - matrix(after, node);
+            if (viaAfter < bestDelta[candidate]) {
+                bestDelta[candidate] = viaAfter;
+                bestAfter[candidate] = after;
+            }
+            double viaNode = matrix(node, candidate) + matrix(candidate, before) - matrix(node, before);
+            if (viaNode < bestDelta[candidate]) {
+                bestDelta[candidate] = viaNode;
+                bestAfter[candidate] = node;
+            }
+        }
+    }
+    
+    std::vector<int> tour;
+    for (int node = 0; node != finish; node = next[node]) {
+        tour.push_back(node);
+    }
+    tour.push_back(finish);
+    return tour;
+}
+
+double TourPlanner::tourCost(const Matrix& matrix, const std::vector<int>& tour) {
+    double cost = 0.0;
+    for (size_t i = 0; i + 1 < tour.size(); i++) {
+        cost += matrix(tour[i], tour[i + 1]);
+    }
+    return cost;
+}
+
+bool TourPlanner::improve(const Matrix& matrix, std::vector<int>& tour, Clock::time_point deadline) {
+    //позиции 0 (старт) и last (финиш) закреплены, двигаются только цели 1..last-1
+    int last = static_cast<int>(tour.size()) - 1;
+    std::vector<double> forward(tour.size(), 0.0);
+    std::vector<double> backward(tour.size(), 0.0);
+    
+    //префиксные суммы по обходу и против него: разворот отрезка в несимметричном графе за O(1)
+    auto rebuildPrefix = [&]() {
+        for (int k = 0; k < last; k++) {
+            forward[k + 1] = forward[k] + matrix(tour[k], tour[k + 1]);
+            backward[k + 1] = backward[k] + matrix(tour[k + 1], tour[k]);
+        }
+    };
+    
+    bool improved = true;
+    while (improved) {
+        improved = false;
+        rebuildPrefix();
+        
+        //═══ 2-opt: развернуть tour[i..j] ═══
+        for (int i = 1; i < last - 1; i++) {
+            if (Clock::now() > deadline) {
+                return false;
+            }
+            for (int j = i + 1; j < last; j++) {
+                double before = matrix(tour[i - 1], tour[i]) + (forward[j] - forward[i])
+                              + matrix(tour[j], tour[j + 1]);
+                double after = matrix(tour[i - 1], tour[j]) + (backward[j] - backward[i])
+                             + matrix(tour[i], tour[j + 1]);
+                if (after < before - IMPROVEMENT_EPSILON) {
+                    std::reverse(tour.begin() + i, tour.begin() + j + 1);
+                    rebuildPrefix();
+                    improved = true;
+                }
+            }
+        }
+        
+        //═══ Or-opt: перенести цепочку tour[i..i+length-1] на ребро tour[k] -> tour[k+1] ═══
+        for (int length = 1; length <= OR_OPT_MAX_SEGMENT; length++) {
+            for (int i = 1; i + length - 1 < last; i++) {
+                if (Clock::now() > deadline) {
+                    return false;
+                }
+                int first = tour[i];
+                int end = tour[i + length - 1];
+                double removeGain = matrix(tour[i - 1], first) + matrix(end, tour[i + length])
+                                  - matrix(tour[i - 1], tour[i + length]);
+                
+                for (int k = 0; k < last; k++) {
+                    if (k >= i - 1 && k <= i + length - 1) {
+                        continue;
+                    }
+                    double insertCost = matrix(tour[k], first) + matrix(end, tour[k + 1])
+                                      - matrix(tour[k], tour[k + 1]);
+                    if (insertCost < removeGain - IMPROVEMENT_EPSILON) {
+                        if (k < i) {
+                            std::rotate(tour.begin() + k + 1, tour.begin() + i, tour.begin() + i + length);
+                        } else {
+                            std::rotate(tour.begin() + i, tour.begin() + i + length, tour.begin() + k + 1);
+                        }
+                        improved = true;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+TourPlan TourPlanner::PlanTour(int start, const std::vector<int>& targets) const {
+    TourPlan plan;
+    Clock::time_point begin = Clock::now();
+    Clock::time_point deadline = begin + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double, std::milli>(settings.timeBudgetMs));
+    
+    if (!graph.HasVertex(start)) {
+        return plan;
+    }
+    
+    //═══ сжатый граф: плотные индексы и рёбра подряд ═══
+    Adjacency adjacency;
+    std::vector<int> ids;
+    std::unordered_map<int, int> index;
+    index.reserve(graph.GetVertexCount());
+    for (int vertex : graph.Vertices()) {
+        index[vertex] = static_cast<int>(ids.size());
+        ids.push_back(vertex);
+    }
+    adjacency.offsets.push_back(0);
+    for (int vertex : ids) {
+        const DynamicArray<Edge>& edges = graph.GetEdges(vertex);
+        for (int i = 0; i < edges.GetSize(); i++) {
+            adjacency.targets.push_back(index[edges[i].to]);
+            adjacency.weights.push_back(Dijkstra::EdgeWeight(edges[i].data, settings.metric));
+        }
+        adjacency.offsets.push_back(static_cast<int>(adjacency.targets.size()));
+    }
+    
+    //цели без повторов и без стартовой планеты
+    std::vector<int> goals;
+    std::unordered_set<int> unique;
+    for (int target : targets) {
+        if (target != start && graph.HasVertex(target) && unique.insert(target).second) {
+            goals.push_back(target);
+        }
+    }
+    
+    //═══ поиск из старта отсеивает недостижимые цели ═══
+    std::vector<int> denseGoals;
+    for (int goal : goals) {
+        denseGoals.push_back(index[goal]);
+    }
+    std::vector<std::vector<double>> distance(1);
+    std::vector<std::vector<int>> parent(1);
+    searchFrom(adjacency, index[start], denseGoals, distance[0], parent[0]);
+    
+    std::vector<int> nodes{index[start]};   //узлы матрицы 0..m в плотных индексах
+    for (size_t i = 0; i < goals.size(); i++) {
+        if (distance[0][denseGoals[i]] == INF) {
+            plan.unreachable.push_back(goals[i]);
+        } else {
+            nodes.push_back(denseGoals[i]);
+        }
+    }
+    int m = static_cast<int>(nodes.size()) - 1;
+    
+    //═══ поиски из каждой цели, источники разбираются потоками по счётчику ═══
+    distance.resize(m + 1);
+    parent.resize(m + 1);
+    std::vector<int> reachableGoals(nodes.begin() + 1, nodes.end());
+    std::atomic<int> nextSource(1);
+    auto worker = [&]() {
+        for (int source = nextSource++; source <= m; source = nextSource++) {
+            std::vector<int> toFind = reachableGoals;
+            if (settings.returnToStart) {
+                toFind.push_back(nodes[0]);
+            }
+            searchFrom(adjacency, nodes[source], toFind, distance[source], parent[source]);
+        }
+    };
+    int threads = std::max(1, std::min(settings.threadCount, m));
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; t++) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+    
+    Matrix matrix;
+    matrix.size = m + 2;
+    matrix.cost.assign(matrix.size * matrix.size, 0.0);
+    for (int from = 0; from <= m; from++) {
+        for (int to = 0; to <= m; to++) {
+            double value = distance[from][nodes[to]];
+            matrix.cost[from * matrix.size + to] = value == INF ? UNREACHABLE_COST : value;
+        }
+        //фиктивный финиш: для пути вход бесплатен, для цикла - это возврат на старт
+        matrix.cost[from * matrix.size + m + 1] = settings.returnToStart ? matrix(from, 0) : 0.0;
+    }
+    
+    //═══ стартовые обходы и локальный поиск, каждый вариант в своём потоке ═══
+    int variants = m < 2 ? 1 : settings.constructions;
+    std::vector<std::vector<int>> tours(variants);
+    std::vector<char> finished(variants, 1);
+    std::atomic<int> nextVariant(0);
+    auto solver = [&]() {
+        for (int variant = nextVariant++; variant < variants; variant = nextVariant++) {
+            if (variant == 1) {
+                tours[variant] = cheapestInsertion(matrix);
+            } else {
+                tours[variant] = nearestNeighbor(matrix, static_cast<unsigned>(variant),
+                                                 variant == 0 ? 1 : RANDOM_CHOICES);
+            }
+            finished[variant] = improve(matrix, tours[variant], deadline);
+        }
+    };
+    threads = std::max(1, std::min(settings.threadCount, variants));
+    workers.clear();
+    for (int t = 1; t < threads; t++) {
+        workers.emplace_back(solver);
+    }
+    solver();
+    for (std::thread& thread : workers) {
+        thread.join();
+    }
+    
+    int best = 0;
+    for (int variant = 1; variant < variants; variant++) {
+        if (tourCost(matrix, tours[variant]) < tourCost(matrix, tours[best])) {
+            best = variant;
+        }
+    }
+    const std::vector<int>& tour = tours[best];
+    plan.timedOut = std::find(finished.begin(), finished.end(), 0) != finished.end();
+    
+    //═══ маршрут по планетам: пути между соседями по обходу из деревьев поисков ═══
+    plan.feasible = true;
+    plan.path.Append(start);
+    int stops = settings.returnToStart ? m + 1 : m;
+    for (int step = 0; step < stops; step++) {
+        int from = tour[step];
+        int to = step + 1 <= m ? tour[step + 1] : 0;
+        if (to != 0) {
+            plan.order.push_back(ids[nodes[to]]);
+        }
+        
+        double leg = distance[from][nodes[to]];
+        if (leg == INF) {
+            plan.feasible = false;
+            continue;
+        }
+        plan.totalCost += leg;
+        
+        DynamicArray<int> legPath;
+        for (int current = nodes[to]; current != nodes[from]; current = parent[from][current]) {
+            legPath.Prepend(ids[current]);
+        }
+        for (int i = 0; i < legPath.GetSize(); i++) {
+            plan.path.Append(legPath[i]);
+        }
+    }
+    
+    return plan;
+}
@@ -1,5 +1,7 @@
 #include "addedgedialog.h"
 #include "ui_addedgedialog.h"
+#include <QCompleter>
+#include <QLineEdit>
 
 AddEdgeDialog::AddEdgeDialog(StarGraph* graph, QWidget *parent) :
     QDialog(parent),
@@ -8,13 +10,9 @@ AddEdgeDialog::AddEdgeDialog(StarGraph* graph, QWidget *parent) :
     ui->setupUi(this);
     setWindowTitle("Добавить гиперпространственный переход");
     
-    //заполняем списки планет
-    const auto& planets = graph->GetAllPlanets();
-    for (const auto& pair : planets) {
-        QString planetName = QString::fromStdString(pair.second);
-        ui->fromComboBox->addItem(planetName);
-        ui->toComboBox->addItem(planetName);
-    }
+    //списки планет подгружаются из индекса по мере прокрутки и ввода
+    setupPlanetComboBox(ui->fromComboBox, graph);
+    setupPlanetComboBox(ui->toComboBox, graph);
     
     //устанавливаем значения по умолчанию
     ui->distanceSpinBox->setValue(100.0);
@@ -26,6 +24,24 @@ AddEdgeDialog::~AddEdgeDialog()
     delete ui;
 }
 
+void AddEdgeDialog::setupPlanetComboBox(QComboBox* comboBox, StarGraph* graph)
+{
+    //выпадающий список: первые страницы в алфавитном порядке
+    comboBox->setModel(new PlanetSearchModel(graph, comboBox));
+    comboBox->setEditable(true);
+    comboBox->setInsertPolicy(QComboBox::NoInsert);
+    
+    //автодополнение: отдельная модель, которая следует за вводом
+    PlanetSearchModel* completerModel = new PlanetSearchModel(graph, comboBox);
+    QCompleter* completer = new QCompleter(completerModel, comboBox);
+    completer->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    completer->setCaseSensitivity(Qt::CaseInsensitive);
+    comboBox->setCompleter(completer);
+    
+    connect(comboBox->lineEdit(), &QLineEdit::textEdited,
+            completerModel, &PlanetSearchModel::setQuery);
+}
+
 QString AddEdgeDialog::getFromPlanet() const
 {
     return ui->fromComboBox->currentText();
@@ -2,74 +2,131 @@
 #include <QPainter>
 #include <QPainterPath>
 #include <QMouseEvent>
-#include <QRandomGenerator>
+#include <QWheelEvent>
+#include <QCursor>
 #include <QtMath>
 #include <QFont>
 #include <QTimer>
-#include <QMessageBox>
+#include <QPaintEvent>
+#include <QRegion>
+#include <QMetaObject>
+#include <QElapsedTimer>
+#include <memory>
 #include <cmath>
-#include <cstdlib>
 #include <algorithm>
 
-GraphView::GraphView(StarGraph* g, QWidget *parent)
-    : QWidget(parent), graph(g), trader(nullptr), selectedNode(-1), isDragging(false),
-      animationStep(0), isAnimating(false), blackHole(nullptr)
+GraphView::GraphView(GameSimulation* simulation, QWidget *parent)
+    : QWidget(parent), game(simulation), graph(&simulation->getGraph()), trader(&simulation->getTrader()),
+      selectedNode(-1), isDragging(false),
+      zoom(1.0), panOffset(0, 0), isPanning(false),
+      layoutCancelled(false), layoutGeneration(0), layoutFitsView(false),
+      backgroundDirty(true), graphLayerDirty(true),
+      syncedGraphVersion(graph->GetVersion() - 1),  //заведомо отличается от текущей
+      syncedTopologyVersion(graph->GetTopologyVersion() - 1),
+      clock(SIMULATION_STEP), pendingFullRepaint(false), animationSystem(-1),
+      animationStep(0), isAnimating(false), hazards(simulation->getHazards()),
+      perfOverlayVisible(false), perfSeenMapFrames(0), perfOverlaySystem(-1)
 {
     setMinimumSize(800, 600);
     setMouseTracking(true);
     
+    //статичная карта растеризуется тайлами в фоновых потоках
+    mapRenderer = new MapRenderer(this);
+    connect(mapRenderer, &MapRenderer::frameReady, this, [this]() { update(); });
+    
     //инициализируем статичные звезды (один раз)
     initStars();
     
-    //═══ инициализация эффектов (только если включены) ═══
+    //═══ системы симуляции (все - на одних часах) ═══
     if constexpr (ENABLE_VISUAL_EFFECTS) {
-        //таймер для анимации пути
+        //анимация пути - включается при подсветке пути
         if constexpr (ENABLE_PATH_ANIMATION) {
-            animationTimer = new QTimer(this);
-            connect(animationTimer, &QTimer::timeout, this, &GraphView::onAnimationStep);
+            animationSystem = clock.addSystem("animation", PATH_ANIMATION_DELAY_MS / 1000.0,
+                                              [this](double) { onAnimationStep(); }, false);
         }
         
-        //таймер для метеоритов
+        //метеориты
         if constexpr (ENABLE_METEORS) {
-            meteorTimer = new QTimer(this);
-            connect(meteorTimer, &QTimer::timeout, this, &GraphView::onMeteorUpdate);
             initMeteors();
-            meteorTimer->start(METEOR_UPDATE_INTERVAL_MS);
+            clock.addSystem("meteors", METEOR_UPDATE_INTERVAL_MS / 1000.0,
+                            [this](double) { onMeteorUpdate(); });
         }
     }
     
-    //═══ инициализация черной дыры ═══
-    //таймер спавна (60 секунд)
-    blackHoleSpawnTimer = new QTimer(this);
-    connect(blackHoleSpawnTimer, &QTimer::timeout, this, &GraphView::onBlackHoleSpawn);
-    blackHoleSpawnTimer->start(60000);  //60000 мс = 60 сек
+    //═══ черная дыра ═══
+    //шаг мира симуляции (часы игры, появление, движение и столкновения) - на каждом шаге
+    clock.addSystem("blackHole", 0.0, [this](double deltaTime) { onBlackHoleUpdate(deltaTime); });
+    
+    //таймер кадра: единственный таймер, который продвигает симуляцию
+    frameTimer = new QTimer(this);
+    frameTimer->setTimerType(Qt::PreciseTimer);
+    connect(frameTimer, &QTimer::timeout, this, &GraphView::onFrame);
+    frameClock.start();
+    frameTimer->start(static_cast<int>(SIMULATION_STEP * 1000));
     
-    //таймер обновления позиции (50 мс)
-    blackHoleUpdateTimer = new QTimer(this);
-    connect(blackHoleUpdateTimer, &QTimer::timeout, this, &GraphView::onBlackHoleUpdate);
-    blackHoleUpdateTimer->start(16);  //16 мс = ~60 FPS
+    //оверлей производительности обновляется сам, даже когда карта стоит
+    perfOverlaySystem = clock.addSystem("perfOverlay", PERF_OVERLAY_REFRESH_MS / 1000.0,
+                                        [this](double) { scheduleRepaint(perfOverlayRect()); }, false);
+}
+
+GraphView::~GraphView()
+{
+    //фоновый поток не должен пережить виджет
+    stopAutoLayout();
 }
 
 void GraphView::paintEvent(QPaintEvent *event)
 {
-    Q_UNUSED(event);
+    //═══ замер по слоям: mark закрывает текущий слой ═══
+    QElapsedTimer layerTimer;
+    if constexpr (ENABLE_PERF_OVERLAY) {
+        perf.beginFrame();
+        layerTimer.start();
+    }
+    auto mark = [this, &layerTimer](PerfMonitor::Layer layer) {
+        if constexpr (ENABLE_PERF_OVERLAY) {
+            perf.addLayerTime(layer, layerTimer.nsecsElapsed());
+            layerTimer.restart();
+        }
+    };
+    
+    //═══ статичные слои пересобираются только после изменений ═══
+    syncWithGraph();
+    if (backgroundDirty) {
+        rebuildBackgroundLayer();
+    }
+    mark(PerfMonitor::LayerStars);
+    if (graphLayerDirty) {
+        rebuildGraphLayer();
+    }
+    mark(PerfMonitor::LayerSnapshot);
+    
+    //время тайлов учитывается в кадре, который первым показал их результат
+    if constexpr (ENABLE_PERF_OVERLAY) {
+        if (mapRenderer->completedFrames() != perfSeenMapFrames) {
+            perfSeenMapFrames = mapRenderer->completedFrames();
+            perf.addLayerTime(PerfMonitor::LayerEdges, mapRenderer->lastFrameStats().lanesNs);
+            perf.addLayerTime(PerfMonitor::LayerNodes, mapRenderer->lastFrameStats().nodesNs);
+        }
+    }
     
     QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
     
-    //фон - космос
-    QLinearGradient gradient(0, 0, 0, height());
-    gradient.setColorAt(0, QColor(10, 10, 30));
-    gradient.setColorAt(1, QColor(20, 20, 50));
-    painter.fillRect(rect(), gradient);
+    //при анимации перерисовывается только грязная область
+    //(прямоугольники метеоритов и черной дыры)
+    painter.setClipRegion(event->region());
+    
+    //фон - космос и статичные звезды (из кэша)
+    painter.drawPixmap(0, 0, backgroundLayer);
+    mark(PerfMonitor::LayerStars);
+    
+    painter.setRenderHint(QPainter::Antialiasing);
     
     //═══ метеориты на фоне (если включены) ═══
     if constexpr (ENABLE_VISUAL_EFFECTS && ENABLE_METEORS) {
         drawMeteors(painter);
     }
-    
-    //рисуем статичные звезды на фоне
-    drawStars(painter);
+    mark(PerfMonitor::LayerMeteors);
     
     if (graph->GetVertexCount() == 0) {
         //показываем подсказку, если граф пуст
@@ -92,277 +149,98 @@ void GraphView::paintEvent(QPaintEvent *event)
                 y -= 20;
             }
         }
+    } else {
+        //рёбра, узлы и артефакты - последний кадр фоновой растеризации
+        mapRenderer->composite(painter, worldTransform());
+        mark(PerfMonitor::LayerMap);
         
-        return;
-    }
-    
-    updateNodePositions();
-    
-    //рисуем ребра
-    DynamicArray<int> vertices = graph->GetAllVertices();
-    for (int i = 0; i < vertices.GetSize(); i++) {
-        int fromId = vertices.Get(i);
-        if (!nodePositions.contains(fromId)) continue;
+        //═══ торговец и черная дыра - в мировых координатах ═══
+        painter.save();
+        painter.setTransform(worldTransform(), true);
+        drawTrader(painter);
+        mark(PerfMonitor::LayerTrader);
+        drawBlackHoles(painter);
+        mark(PerfMonitor::LayerBlackHole);
+        painter.restore();
         
-        const DynamicArray<Edge>& edges = graph->GetEdges(fromId);
-        for (int j = 0; j < edges.GetSize(); j++) {
-            const Edge& edge = edges.Get(j);
-            int toId = edge.to;
-            
-            if (!nodePositions.contains(toId)) continue;
-            
-            //проверяем, является ли ребро частью подсвеченного пути
-            bool isHighlighted = false;
-            for (int k = 0; k < highlightedPath.GetSize() - 1; k++) {
-                if (highlightedPath.Get(k) == fromId && 
-                    highlightedPath.Get(k + 1) == toId) {
-                    isHighlighted = true;
-                    break;
-                }
-            }
-            
-            drawEdge(painter, 
-                    nodePositions[fromId].position,
-                    nodePositions[toId].position,
-                    edge.data,
-                    isHighlighted);
-        }
-    }
-    
-    //рисуем узлы
-    for (auto it = nodePositions.begin(); it != nodePositions.end(); ++it) {
-        bool isHighlighted = false;
-        for (int i = 0; i < highlightedPath.GetSize(); i++) {
-            if (highlightedPath.Get(i) == it.key()) {
-                isHighlighted = true;
-                break;
-            }
-        }
-        drawNode(painter, it.value(), isHighlighted);
-    }
-    
-    //═══ рисуем артефакты (звезды) на планетах ═══
-    for (auto it = nodePositions.begin(); it != nodePositions.end(); ++it) {
-        int planetId = it.key();
-        if (graph->HasArtifact(planetId)) {
-            NodePosition node = it.value();
-            QPointF center = node.position;
-            
-            //рисуем блестящую звезду ⭐
-            painter.save();
-            painter.translate(center.x(), center.y() - 45); //над планетой
-            
-            //свечение вокруг звезды
-            QRadialGradient glow(0, 0, 20);
-            glow.setColorAt(0, QColor(255, 215, 0, 200));
-            glow.setColorAt(0.5, QColor(255, 140, 0, 100));
-            glow.setColorAt(1, QColor(255, 69, 0, 0));
-            painter.setBrush(glow);
-            painter.setPen(Qt::NoPen);
-            painter.drawEllipse(QPointF(0, 0), 20, 20);
+        //лог сообщений
+        if (!logMessages.isEmpty()) {
+            painter.setPen(QColor(200, 200, 220));
+            QFont font("Monospace");
+            font.setPointSize(9);
+            painter.setFont(font);
             
-            //рисуем 5-конечную звезду
-            QPolygonF star;
-            for (int i = 0; i < 5; i++) {
-                double angle1 = i * 2 * M_PI / 5 - M_PI / 2;
-                double angle2 = (i + 0.5) * 2 * M_PI / 5 - M_PI / 2;
-                star << QPointF(12 * cos(angle1), 12 * sin(angle1));
-                star << QPointF(5 * cos(angle2), 5 * sin(angle2));
+            int y = height() - 15;
+            for (int i = logMessages.size() - 1; i >= 0 && i >= logMessages.size() - 8; i--) {
+                //полупрозрачный фон для читаемости
+                QRect textRect = painter.fontMetrics().boundingRect(logMessages[i]);
+                textRect.moveBottomLeft(QPoint(10, y));
+                textRect.adjust(-5, -2, 5, 2);
+                painter.fillRect(textRect, QColor(0, 0, 0, 150));
+                
+                painter.drawText(10, y, logMessages[i]);
+                y -= 18;
             }
-            
-            //желтая звезда с обводкой
-            painter.setBrush(QColor(255, 215, 0));
-            painter.setPen(QPen(QColor(255, 140, 0), 2));
-            painter.drawPolygon(star);
-            
-            painter.restore();
         }
     }
     
-    //═══ рисуем торговца ═══
-    if (trader && trader->getIsPlaced() && nodePositions.contains(trader->getCurrentPlanetId())) {
-        NodePosition traderNode = nodePositions[trader->getCurrentPlanetId()];
-        QPointF center = traderNode.position;
-        
-        //иконка корабля 🚀
-        painter.setPen(Qt::NoPen);
-        
-        //корпус корабля (белый треугольник)
-        QPolygonF ship;
-        ship << QPointF(center.x(), center.y() - 20)           //нос
-             << QPointF(center.x() - 10, center.y() + 10)      //левый край
-             << QPointF(center.x() + 10, center.y() + 10);     //правый край
-        
-        painter.setBrush(QColor(255, 255, 255));
-        painter.drawPolygon(ship);
-        
-        //окно кабины (голубое)
-        painter.setBrush(QColor(100, 180, 255));
-        painter.drawEllipse(center, 4, 4);
-        
-        //пламя двигателя (оранжевое)
-        painter.setBrush(QColor(255, 150, 50, 180));
-        painter.drawEllipse(QPointF(center.x(), center.y() + 12), 3, 5);
-        
-        //текст с именем торговца
-        painter.setPen(QColor(255, 255, 255));
-        QFont font = painter.font();
-        font.setPointSize(8);
-        font.setBold(true);
-        painter.setFont(font);
-        painter.drawText(QRectF(center.x() - 50, center.y() + 20, 100, 20),
-                        Qt::AlignCenter,
-                        QString::fromStdString(trader->getName()));
-    }
-    
-    //═══ рисуем черную дыру ═══
-    drawBlackHole(painter);
-    
-    
-    //лог сообщений
-    if (!logMessages.isEmpty()) {
-        painter.setPen(QColor(200, 200, 220));
-        QFont font("Monospace");
-        font.setPointSize(9);
-        painter.setFont(font);
-        
-        int y = height() - 15;
-        for (int i = logMessages.size() - 1; i >= 0 && i >= logMessages.size() - 8; i--) {
-            //полупрозрачный фон для читаемости
-            QRect textRect = painter.fontMetrics().boundingRect(logMessages[i]);
-            textRect.moveBottomLeft(QPoint(10, y));
-            textRect.adjust(-5, -2, 5, 2);
-            painter.fillRect(textRect, QColor(0, 0, 0, 150));
-            
-            painter.drawText(10, y, logMessages[i]);
-            y -= 18;
+    if constexpr (ENABLE_PERF_OVERLAY) {
+        if (perfOverlayVisible) {
+            drawPerfOverlay(painter);
         }
+        mark(PerfMonitor::LayerOverlay);
+        perf.endFrame();
     }
 }
 
-void GraphView::drawNode(QPainter& painter, const NodePosition& node, bool isHighlighted)
+void GraphView::drawTrader(QPainter& painter)
 {
-    const int radius = 30;
-    QPointF center = node.position;
-    
-    //тень
-    painter.setPen(Qt::NoPen);
-    painter.setBrush(QColor(0, 0, 0, 80));
-    painter.drawEllipse(center + QPointF(3, 3), radius + 2, radius + 2);
-    
-    //свечение для подсвеченных узлов
-    if (isHighlighted) {
-        QRadialGradient glowGradient(center, radius + 15);
-        glowGradient.setColorAt(0, QColor(255, 215, 0, 150));
-        glowGradient.setColorAt(0.5, QColor(255, 140, 0, 80));
-        glowGradient.setColorAt(1, QColor(255, 69, 0, 0));
-        painter.setBrush(glowGradient);
-        painter.drawEllipse(center, radius + 15, radius + 15);
-    }
-    
-    //градиент планеты
-    QRadialGradient gradient(center - QPointF(10, 10), radius * 1.5);
-    if (isHighlighted) {
-        gradient.setColorAt(0, QColor(255, 215, 0));
-        gradient.setColorAt(0.6, QColor(255, 140, 0));
-        gradient.setColorAt(1, QColor(200, 100, 0));
-    } else {
-        //═══ цвет зависит от количества связей (если включена градация) ═══
-        QColor baseColor = getNodeColorByConnections(node.id);
-        QColor darkColor = baseColor.darker(150);
-        QColor darkerColor = baseColor.darker(200);
-        
-        gradient.setColorAt(0, baseColor);
-        gradient.setColorAt(0.6, darkColor);
-        gradient.setColorAt(1, darkerColor);
-    }
-    
-    painter.setBrush(gradient);
-    painter.setPen(QPen(isHighlighted ? QColor(255, 215, 0) : QColor(200, 220, 255), 2));
-    painter.drawEllipse(center, radius, radius);
-    
-    //текст
-    painter.setPen(Qt::white);
-    QFont font = painter.font();
-    font.setPointSize(9);
-    font.setBold(isHighlighted);
-    painter.setFont(font);
-    
-    QRect textRect(center.x() - radius, center.y() - radius, 
-                   radius * 2, radius * 2);
-    painter.drawText(textRect, Qt::AlignCenter | Qt::TextWordWrap, node.name);
-}
-
-void GraphView::drawEdge(QPainter& painter, const QPointF& from, const QPointF& to, 
-                        const EdgeData& data, bool isHighlighted)
-{
-    const int nodeRadius = 30;
-    
-    //вычисляем направление
-    QLineF line(from, to);
-    double angle = line.angle() * M_PI / 180.0;
-    
-    //укорачиваем линию, чтобы не заходила на узлы
-    QPointF start = from + QPointF(qCos(angle) * nodeRadius, -qSin(angle) * nodeRadius);
-    QPointF end = to - QPointF(qCos(angle) * nodeRadius, -qSin(angle) * nodeRadius);
-    
-    //цвет в зависимости от риска
-    QColor edgeColor;
-    if (isHighlighted) {
-        edgeColor = QColor(255, 215, 0);
-    } else {
-        int green = 255 - static_cast<int>(data.riskFactor * 255);
-        edgeColor = QColor(255, green, 50, 180);
+    if (!trader || !trader->getIsPlaced() || !nodePositions.contains(trader->getCurrentPlanetId())) {
+        return;
     }
     
-    //рисуем линию
-    painter.setPen(QPen(edgeColor, isHighlighted ? 4 : 2, 
-                       isHighlighted ? Qt::SolidLine : Qt::DashLine));
-    painter.drawLine(start, end);
+    NodePosition traderNode = nodePositions[trader->getCurrentPlanetId()];
+    QPointF center = traderNode.position;
     
-    //стрелка
-    QPointF arrowP1 = end - QPointF(qCos(angle + M_PI / 6) * 12,
-                                    -qSin(angle + M_PI / 6) * 12);
-    QPointF arrowP2 = end - QPointF(qCos(angle - M_PI / 6) * 12,
-                                    -qSin(angle - M_PI / 6) * 12);
+    //иконка корабля 🚀
+    painter.setPen(Qt::NoPen);
     
-    painter.setBrush(edgeColor);
-    QPolygonF arrowHead;
-    arrowHead << end << arrowP1 << arrowP2;
-    painter.drawPolygon(arrowHead);
+    //корпус корабля (белый треугольник)
+    QPolygonF ship;
+    ship << QPointF(center.x(), center.y() - 20)           //нос
+         << QPointF(center.x() - 10, center.y() + 10)      //левый край
+         << QPointF(center.x() + 10, center.y() + 10);     //правый край
     
-    //вес ребра (посередине)
-    QPointF midPoint = (start + end) / 2;
-    QString costText = QString::number(data.getTotalCost(), 'f', 1);
+    painter.setBrush(QColor(255, 255, 255));
+    painter.drawPolygon(ship);
     
-    //фон для текста
-    QRect textRect = painter.fontMetrics().boundingRect(costText);
-    textRect.moveCenter(midPoint.toPoint());
-    textRect.adjust(-3, -2, 3, 2);
+    //окно кабины (голубое)
+    painter.setBrush(QColor(100, 180, 255));
+    painter.drawEllipse(center, 4, 4);
     
-    painter.setPen(Qt::NoPen);
-    painter.setBrush(QColor(20, 20, 50, 200));
-    painter.drawRoundedRect(textRect, 3, 3);
+    //пламя двигателя (оранжевое)
+    painter.setBrush(QColor(255, 150, 50, 180));
+    painter.drawEllipse(QPointF(center.x(), center.y() + 12), 3, 5);
     
-    //текст
-    painter.setPen(isHighlighted ? Qt::yellow : Qt::white);
+    //текст с именем торговца
+    painter.setPen(QColor(255, 255, 255));
     QFont font = painter.font();
     font.setPointSize(8);
-    font.setBold(isHighlighted);
+    font.setBold(true);
     painter.setFont(font);
-    painter.drawText(textRect, Qt::AlignCenter, costText);
+    painter.drawText(QRectF(center.x() - 50, center.y() + 20, 100, 20),
+                    Qt::AlignCenter,
+                    QString::fromStdString(trader->getName()));
 }
 
 void GraphView::updateNodePositions()
 {
-    DynamicArray<int> vertices = graph->GetAllVertices();
-    
     //добавляем новые узлы
-    for (int i = 0; i < vertices.GetSize(); i++) {
-        int id = vertices.Get(i);
+    for (int id : graph->Vertices()) {
         if (!nodePositions.contains(id)) {
             QString name = QString::fromStdString(graph->GetVertexName(id));
             nodePositions[id] = NodePosition(getRandomPosition(), name, id);
+            nodeGrid.Insert(id, nodePositions[id].position.x(), nodePositions[id].position.y());
         }
     }
     
@@ -375,44 +253,132 @@ void GraphView::updateNodePositions()
     }
     for (int id : toRemove) {
         nodePositions.remove(id);
+        nodeGrid.Remove(id);
+        nodeColorCache.remove(id);
     }
 }
 
 QPointF GraphView::getRandomPosition()
 {
-    const int margin = 60;
-    int x = QRandomGenerator::global()->bounded(margin, width() - margin);
-    int y = QRandomGenerator::global()->bounded(margin, height() - margin - 150);
+    //новые планеты появляются в видимой части карты
+    const double margin = 60;
+    const double logHeight = 150 / zoom;  //внизу экрана лог сообщений
+    QRectF visible = visibleWorldRect();
+    Xoshiro256& random = game->getRandom().stream("placement");
+    
+    double x = visible.left() + margin +
+               random.NextDouble() * std::max(1.0, visible.width() - 2 * margin);
+    double y = visible.top() + margin +
+               random.NextDouble() * std::max(1.0, visible.height() - 2 * margin - logHeight);
     return QPointF(x, y);
 }
 
 int GraphView::getNodeAtPosition(const QPoint& pos)
 {
     const int radius = 30;
-    for (auto it = nodePositions.begin(); it != nodePositions.end(); ++it) {
-        QPointF nodePos = it.value().position;
-        if (QLineF(nodePos, pos).length() <= radius) {
-            return it.key();
-        }
+    
+    //ближайшая планета из соседних ячеек сетки вместо обхода всех узлов
+    QPointF worldPos = screenToWorld(pos);
+    int nodeId = -1;
+    if (nodeGrid.FindNearest(worldPos.x(), worldPos.y(), radius, nodeId) && nodePositions.contains(nodeId)) {
+        return nodeId;
     }
     return -1;
 }
 
+//═══════════════════════════════════════════════════════════════
+// КАМЕРА
+//═══════════════════════════════════════════════════════════════
+
+QTransform GraphView::worldTransform() const
+{
+    return QTransform(zoom, 0, 0, zoom, panOffset.x(), panOffset.y());
+}
+
+QPointF GraphView::screenToWorld(const QPointF& pos) const
+{
+    return (pos - panOffset) / zoom;
+}
+
+QRectF GraphView::visibleWorldRect() const
+{
+    return QRectF(screenToWorld(QPointF(0, 0)), screenToWorld(QPointF(width(), height())));
+}
+
+QRectF GraphView::planetsWorldRect() const
+{
+    QRectF bounds;
+    for (auto it = nodePositions.constBegin(); it != nodePositions.constEnd(); ++it) {
+        bounds |= QRectF(it.value().position, QSizeF(1, 1));
+    }
+    return bounds;
+}
+
+void GraphView::zoomAround(const QPointF& anchor, double factor)
+{
+    double newZoom = qBound(MIN_ZOOM, zoom * factor, MAX_ZOOM);
+    if (qFuzzyCompare(newZoom, zoom)) {
+        return;
+    }
+    
+    //точка мира под anchor остаётся под ним
+    QPointF worldAnchor = screenToWorld(anchor);
+    zoom = newZoom;
+    panOffset = anchor - worldAnchor * zoom;
+    
+    invalidateGraphLayer();
+    update();
+}
+
+void GraphView::wheelEvent(QWheelEvent *event)
+{
+    //один щелчок колеса (120) - примерно 20% масштаба
+    double factor = std::pow(1.0015, event->angleDelta().y());
+    zoomAround(mapFromGlobal(QCursor::pos()), factor);
+    event->accept();
+}
+
 void GraphView::mousePressEvent(QMouseEvent *event)
 {
     if (event->button() == Qt::LeftButton) {
         selectedNode = getNodeAtPosition(event->pos());
         if (selectedNode != -1) {
+            //ручное перемещение важнее раскладки
+            if (isLayoutRunning()) {
+                stopAutoLayout();
+                updateAllEdgeDistances();
+            }
             isDragging = true;
-            dragOffset = event->pos() - nodePositions[selectedNode].position.toPoint();
+            dragOffset = screenToWorld(event->pos()) - nodePositions[selectedNode].position;
+            return;
         }
     }
+    
+    //пустое место левой кнопкой или средняя кнопка - панорамирование
+    if (event->button() == Qt::LeftButton || event->button() == Qt::MiddleButton) {
+        isPanning = true;
+        lastPanPos = event->pos();
+        setCursor(Qt::ClosedHandCursor);
+    }
 }
 
 void GraphView::mouseMoveEvent(QMouseEvent *event)
 {
+    if (isPanning) {
+        panOffset += event->pos() - lastPanPos;
+        lastPanPos = event->pos();
+        invalidateGraphLayer();
+        update();
+        return;
+    }
+    
     if (isDragging && selectedNode != -1) {
-        nodePositions[selectedNode].position = event->pos() - dragOffset;
+        nodePositions[selectedNode].position = screenToWorld(event->pos()) - dragOffset;
+        QPointF newPos = nodePositions[selectedNode].position;
+        nodeGrid.Move(selectedNode, newPos.x(), newPos.y());
+        updateNodeLanes(selectedNode);
+        pushPlanetPosition(selectedNode);
+        invalidateGraphLayer();
         update();
     }
 }
@@ -426,6 +392,11 @@ void GraphView::mouseReleaseEvent(QMouseEvent *event)
         updateEdgeDistances(selectedNode);
     }
     
+    if (isPanning) {
+        isPanning = false;
+        unsetCursor();
+    }
+    
     isDragging = false;
     selectedNode = -1;
 }
@@ -433,14 +404,17 @@ void GraphView::mouseReleaseEvent(QMouseEvent *event)
 void GraphView::resizeEvent(QResizeEvent *event)
 {
     Q_UNUSED(event);
-    //пересоздаем звезды при изменении размера окна
+    //пересоздаем звезды и слои при изменении размера окна
     initStars();
+    backgroundDirty = true;
+    invalidateGraphLayer();
     update();
 }
 
 void GraphView::highlightPath(const DynamicArray<int>& path)
 {
     highlightedPath = path;
+    invalidateGraphLayer();
     
     //═══ анимация пути (если включена) ═══
     if constexpr (ENABLE_VISUAL_EFFECTS && ENABLE_PATH_ANIMATION) {
@@ -451,11 +425,11 @@ void GraphView::highlightPath(const DynamicArray<int>& path)
             for (auto it = nodePositions.begin(); it != nodePositions.end(); ++it) {
                 it.value().isHighlighted = false;
             }
-            animationTimer->start(PATH_ANIMATION_DELAY_MS);
-            return;  //не обновляем сразу, будет через анимацию
+            clock.restartSystem(animationSystem);
         }
     }
     
+    //подсветка пути - в снимке карты, шаги анимации слой не пересобирают
     update();
 }
 
@@ -465,7 +439,241 @@ void GraphView::addLogMessage(const QString& message)
     if (logMessages.size() > 20) {
         logMessages.removeFirst();
     }
-    update();
+    scheduleRepaint();
+}
+
+//═══════════════════════════════════════════════════════════════
+// КЭШИРОВАННЫЕ СЛОИ ОТРИСОВКИ
+//═══════════════════════════════════════════════════════════════
+
+void GraphView::invalidateGraphLayer()
+{
+    graphLayerDirty = true;
+}
+
+QPixmap GraphView::createLayerPixmap() const
+{
+    qreal ratio = devicePixelRatioF();
+    QPixmap pixmap(size() * ratio);
+    pixmap.setDevicePixelRatio(ratio);
+    return pixmap;
+}
+
+void GraphView::rebuildBackgroundLayer()
+{
+    backgroundLayer = createLayerPixmap();
+    
+    QPainter painter(&backgroundLayer);
+    
+    //фон - космос
+    QLinearGradient gradient(0, 0, 0, height());
+    gradient.setColorAt(0, QColor(10, 10, 30));
+    gradient.setColorAt(1, QColor(20, 20, 50));
+    painter.fillRect(rect(), gradient);
+    
+    //статичные звезды
+    drawStars(painter);
+    
+    backgroundDirty = false;
+}
+
+void GraphView::rebuildGraphLayer()
+{
+    graphLayerDirty = false;
+    
+    if (graph->GetVertexCount() == 0) {
+        mapRenderer->clear();
+        return;
+    }
+    
+    //═══ снимок видимой части карты - дальше рисуют фоновые потоки ═══
+    auto snapshot = std::make_shared<MapSnapshot>();
+    snapshot->transform = worldTransform();
+    snapshot->viewportSize = size();
+    snapshot->devicePixelRatio = devicePixelRatioF();
+    snapshot->font = font();
+    snapshot->detailed = zoom >= LOD_LABEL_ZOOM;
+    
+    //видимая часть мира с запасом на радиус планет, свечение и звезду-артефакт
+    QRectF visible = visibleWorldRect().adjusted(-70, -70, 70, 70);
+    
+    //═══ крупный масштаб - скопления вместо отдельных планет ═══
+    if (zoom < LOD_CLUSTER_ZOOM) {
+        snapshot->clustered = true;
+        collectClusters(*snapshot, visible);
+        mapRenderer->render(snapshot);
+        return;
+    }
+    
+    //только рёбра, задевающие видимую область
+    DynamicArray<qint64> visibleLanes;
+    laneGrid.ForEachInBox(visible.left(), visible.top(), visible.right(), visible.bottom(),
+                          [&visibleLanes](qint64 key) { visibleLanes.Append(key); });
+    
+    for (int i = 0; i < visibleLanes.GetSize(); i++) {
+        int fromId = static_cast<int>(visibleLanes.Get(i) >> 32);
+        int toId = static_cast<int>(visibleLanes.Get(i) & 0xFFFFFFFF);
+        
+        if (!nodePositions.contains(fromId) || !nodePositions.contains(toId)) continue;
+        
+        //проверяем, является ли ребро частью подсвеченного пути
+        bool isHighlighted = false;
+        for (int k = 0; k < highlightedPath.GetSize() - 1; k++) {
+            if (highlightedPath.Get(k) == fromId && 
+                highlightedPath.Get(k + 1) == toId) {
+                isHighlighted = true;
+                break;
+            }
+        }
+        
+        //параллельные рёбра from -> to делят один отрезок индекса
+        const DynamicArray<Edge>& edges = graph->GetEdges(fromId);
+        for (int j = 0; j < edges.GetSize(); j++) {
+            if (edges.Get(j).to != toId) continue;
+            
+            snapshot->lanes.append({nodePositions[fromId].position,
+                                    nodePositions[toId].position,
+                                    edges.Get(j).data,
+                                    isHighlighted});
+        }
+    }
+    
+    //видимые планеты (цвет берётся из кэша здесь - фоновые потоки граф не читают)
+    nodeGrid.ForEachInBox(visible.left(), visible.top(), visible.right(), visible.bottom(),
+                          [&](int nodeId) {
+        if (!nodePositions.contains(nodeId)) {
+            return;
+        }
+        
+        bool isHighlighted = false;
+        for (int i = 0; i < highlightedPath.GetSize(); i++) {
+            if (highlightedPath.Get(i) == nodeId) {
+                isHighlighted = true;
+                break;
+            }
+        }
+        
+        const NodePosition& node = nodePositions[nodeId];
+        snapshot->nodes.append({node.position, node.name,
+                                isHighlighted ? QColor() : getNodeColorByConnections(nodeId),
+                                isHighlighted, graph->HasArtifact(nodeId)});
+    });
+    
+    mapRenderer->render(snapshot);
+}
+
+void GraphView::collectClusters(MapSnapshot& snapshot, const QRectF& visible)
+{
+    //планеты группируются по ячейкам фиксированного экранного размера
+    double cell = CLUSTER_CELL_PX / zoom;
+    auto cellOf = [cell](const QPointF& p) {
+        return qMakePair(static_cast<int>(std::floor(p.x() / cell)),
+                         static_cast<int>(std::floor(p.y() / cell)));
+    };
+    
+    struct Cluster {
+        QPointF sum;
+        int count = 0;
+        bool hasHighlighted = false;
+    };
+    QHash<QPair<int, int>, Cluster> clusters;
+    
+    nodeGrid.ForEachInBox(visible.left(), visible.top(), visible.right(), visible.bottom(),
+                          [&](int id) {
+        if (!nodePositions.contains(id)) {
+            return;
+        }
+        QPointF pos = nodePositions[id].position;
+        Cluster& cluster = clusters[cellOf(pos)];
+        cluster.sum += pos;
+        cluster.count++;
+        for (int i = 0; i < highlightedPath.GetSize(); i++) {
+            if (highlightedPath.Get(i) == id) {
+                cluster.hasHighlighted = true;
+                break;
+            }
+        }
+    });
+    
+    //связи между скоплениями - одна линия на пару ячеек
+    QSet<QPair<QPair<int, int>, QPair<int, int>>> linkedCells;
+    laneGrid.ForEachInBox(visible.left(), visible.top(), visible.right(), visible.bottom(),
+                          [&](qint64 key) {
+        int fromId = static_cast<int>(key >> 32);
+        int toId = static_cast<int>(key & 0xFFFFFFFF);
+        if (!nodePositions.contains(fromId) || !nodePositions.contains(toId)) {
+            return;
+        }
+        
+        QPair<int, int> a = cellOf(nodePositions[fromId].position);
+        QPair<int, int> b = cellOf(nodePositions[toId].position);
+        if (a == b || !clusters.contains(a) || !clusters.contains(b)) {
+            return;
+        }
+        if (b < a) {
+            std::swap(a, b);
+        }
+        if (linkedCells.contains(qMakePair(a, b))) {
+            return;
+        }
+        linkedCells.insert(qMakePair(a, b));
+        
+        const Cluster& ca = clusters[a];
+        const Cluster& cb = clusters[b];
+        snapshot.clusterLinks.append(QLineF(ca.sum / ca.count, cb.sum / cb.count));
+    });
+    
+    //размер скопления растёт с числом планет
+    for (auto it = clusters.constBegin(); it != clusters.constEnd(); ++it) {
+        const Cluster& cluster = it.value();
+        double radius = (6 + std::min(14.0, 3.0 * std::sqrt(cluster.count))) / zoom;
+        snapshot.clusters.append({cluster.sum / cluster.count, radius, cluster.count, cluster.hasHighlighted});
+    }
+}
+
+//═══════════════════════════════════════════════════════════════
+// ЧАСЫ СИМУЛЯЦИИ
+//═══════════════════════════════════════════════════════════════
+
+void GraphView::onFrame()
+{
+    reportTimerTick(PerfMonitor::TimerFrame);
+    
+    //реальное время с прошлого кадра -> фиксированные шаги всех систем
+    double elapsed = frameClock.nsecsElapsed() / 1e9;
+    frameClock.restart();
+    clock.advance(elapsed);
+    
+    flushRepaint();
+}
+
+void GraphView::runSimulationFor(double seconds)
+{
+    clock.runFor(seconds);
+    frameClock.restart();   //прогнанное время не должно повториться в следующем кадре
+    flushRepaint();
+}
+
+void GraphView::scheduleRepaint()
+{
+    pendingFullRepaint = true;
+}
+
+void GraphView::scheduleRepaint(const QRegion& region)
+{
+    pendingRepaint += region;
+}
+
+void GraphView::flushRepaint()
+{
+    //все изменения за кадр - одна перерисовка
+    if (pendingFullRepaint) {
+        update();
+    } else if (!pendingRepaint.isEmpty()) {
+        update(pendingRepaint);
+    }
+    pendingFullRepaint = false;
+    pendingRepaint = QRegion();
 }
 
 //═══════════════════════════════════════════════════════════════
@@ -477,18 +685,19 @@ void GraphView::onAnimationStep()
     if constexpr (!ENABLE_VISUAL_EFFECTS || !ENABLE_PATH_ANIMATION) {
         return;
     }
+    reportTimerTick(PerfMonitor::TimerAnimation);
     
     if (animationStep < highlightedPath.GetSize()) {
-        //подсвечиваем следующую планету в пути
+        //отмечаем следующую планету в пути; сам путь уже подсвечен в снимке карты (highlightPath),
+        //флаг в тайлы не попадает - пересобирать слой и перерисовывать окно не нужно
         int nodeId = highlightedPath.Get(animationStep);
         if (nodePositions.contains(nodeId)) {
             nodePositions[nodeId].isHighlighted = true;
         }
         animationStep++;
-        update();
     } else {
         //анимация завершена
-        animationTimer->stop();
+        clock.setEnabled(animationSystem, false);
         isAnimating = false;
     }
 }
@@ -498,22 +707,29 @@ void GraphView::onMeteorUpdate()
     if constexpr (!ENABLE_VISUAL_EFFECTS || !ENABLE_METEORS) {
         return;
     }
+    reportTimerTick(PerfMonitor::TimerMeteor);
+    
+    //перерисовываем только старые и новые области метеоритов
+    QRegion dirty;
     
     //обновляем позиции метеоритов
+    Xoshiro256& random = game->getRandom().stream("meteors");
     for (auto& meteor : meteors) {
+        dirty += meteorBounds(meteor);
         meteor.position += meteor.velocity;
         
         //если вылетел за экран - возвращаем наверх
         if (meteor.position.y() > height() || meteor.position.x() > width() || 
             meteor.position.x() < 0) {
             meteor.position = QPointF(
-                rand() % width(),
+                random.NextBelow(std::max(1, width())),
                 -10
             );
         }
+        dirty += meteorBounds(meteor);
     }
     
-    update();
+    scheduleRepaint(dirty);
 }
 
 void GraphView::initMeteors()
@@ -523,25 +739,25 @@ void GraphView::initMeteors()
     }
     
     meteors.clear();
+    Xoshiro256& random = game->getRandom().stream("meteors");
     for (int i = 0; i < METEOR_COUNT; i++) {
         Meteor meteor;
         meteor.position = QPointF(
-            rand() % width(),
-            rand() % height()
+            random.NextBelow(std::max(1, width())),
+            random.NextBelow(std::max(1, height()))
         );
         
         //случайная скорость и направление
-        double speed = METEOR_MIN_SPEED + 
-                      (rand() % (METEOR_MAX_SPEED - METEOR_MIN_SPEED + 1));
-        double angle = (rand() % 60) + 60;  //угол от 60 до 120 градусов
+        double speed = random.NextInt(METEOR_MIN_SPEED, METEOR_MAX_SPEED);
+        double angle = random.NextInt(60, 119);  //угол от 60 до 120 градусов
         
         meteor.velocity = QPointF(
             speed * cos(angle * M_PI / 180.0),
             speed * sin(angle * M_PI / 180.0)
         );
         
-        meteor.size = 1 + (rand() % 3);
-        meteor.opacity = 0.3 + (rand() % 40) / 100.0;
+        meteor.size = random.NextInt(1, 3);
+        meteor.opacity = 0.3 + random.NextInt(0, 39) / 100.0;
         
         meteors.append(meteor);
     }
@@ -552,12 +768,12 @@ void GraphView::initStars()
     //генерируем статичные звезды один раз
     stars.clear();
     
-    //используем фиксированный seed для воспроизводимости
-    srand(42);
+    //свой генератор с фиксированным seed: одно и то же небо при любом seed игры
+    Xoshiro256 random(42);
     
     for (int i = 0; i < 150; i++) {
-        QPointF pos(rand() % 2000, rand() % 2000);  //больше чем экран
-        int brightness = 100 + (rand() % 156);      //100-255
+        QPointF pos(random.NextBelow(2000), random.NextBelow(2000));  //больше чем экран
+        int brightness = random.NextInt(100, 255);
         stars.append(Star(pos, brightness));
     }
 }
@@ -610,6 +826,16 @@ void GraphView::drawMeteors(QPainter& painter)
     }
 }
 
+QRect GraphView::meteorBounds(const Meteor& meteor) const
+{
+    //свечение радиусом size*3 и шлейф длиной velocity*3
+    double glow = meteor.size * 3;
+    QRectF bounds(meteor.position - QPointF(glow, glow), QSizeF(glow * 2, glow * 2));
+    QPointF tail = meteor.position - meteor.velocity * 3;
+    bounds = bounds.united(QRectF(tail, QSizeF(1, 1)));
+    return bounds.toAlignedRect().adjusted(-2, -2, 2, 2);
+}
+
 QColor GraphView::getNodeColorByConnections(int nodeId)
 {
     if constexpr (!ENABLE_VISUAL_EFFECTS || !ENABLE_PLANET_GRADATION) {
@@ -617,25 +843,17 @@ QColor GraphView::getNodeColorByConnections(int nodeId)
         return QColor(100, 150, 255);
     }
     
-    //считаем количество связей (входящих + исходящих)
-    int connectionCount = 0;
-    
-    //исходящие ребра
-    if (graph->HasVertex(nodeId)) {
-        const DynamicArray<Edge>& edges = graph->GetEdges(nodeId);
-        connectionCount += edges.GetSize();
+    if (!graph->HasVertex(nodeId)) {
+        return QColor(100, 150, 255);
     }
     
-    //входящие ребра
-    DynamicArray<int> allVertices = graph->GetAllVertices();
-    for (int i = 0; i < allVertices.GetSize(); i++) {
-        int v = allVertices.Get(i);
-        const DynamicArray<Edge>& edges = graph->GetEdges(v);
-        for (int j = 0; j < edges.GetSize(); j++) {
-            if (edges.Get(j).to == nodeId) {
-                connectionCount++;
-            }
-        }
+    //количество связей (входящих + исходящих) граф хранит готовым
+    int connectionCount = graph->GetDegree(nodeId);
+    
+    //цвет пересчитывается только при изменении степени планеты
+    auto cached = nodeColorCache.constFind(nodeId);
+    if (cached != nodeColorCache.constEnd() && cached.value().first == connectionCount) {
+        return cached.value().second;
     }
     
     //градация от синего (мало связей) к красному (много связей)
@@ -646,7 +864,9 @@ QColor GraphView::getNodeColorByConnections(int nodeId)
     int green = static_cast<int>(150 * (1 - ratio));  //150 → 0
     int blue = static_cast<int>(255 - ratio * 155);   //255 → 100
     
-    return QColor(red, green, blue);
+    QColor color(red, green, blue);
+    nodeColorCache.insert(nodeId, qMakePair(connectionCount, color));
+    return color;
 }
 
 //═══════════════════════════════════════════════════════════════
@@ -671,15 +891,8 @@ void GraphView::updateEdgeDistances(int vertexId)
     }
     QPointF movedPos = nodePositions[vertexId].position;
     
-    //получаем все вершины графа
-    DynamicArray<int> allVertices = graph->GetAllVertices();
-    
-    //масштабный коэффициент (пиксели -> условные единицы расстояния)
-    const double SCALE_FACTOR = 2.0;
+    for (int otherId : graph->Vertices()) {
     
-    for (int i = 0; i < allVertices.GetSize(); i++) {
-        int otherId = allVertices.Get(i);
-        
         //пропускаем саму перемещённую планету
         if (otherId == vertexId) {
             continue;
@@ -691,290 +904,420 @@ void GraphView::updateEdgeDistances(int vertexId)
         }
         QPointF otherPos = nodePositions[otherId].position;
         
-        //вычисляем евклидово расстояние в пикселях
-        double pixelDistance = QLineF(movedPos, otherPos).length();
-        
-        //переводим в условные единицы
-        double logicalDistance = pixelDistance / SCALE_FACTOR;
-        
-        //минимум 1.0
-        if (logicalDistance < 1.0) {
-            logicalDistance = 1.0;
-        }
+        double distance = logicalDistance(movedPos, otherPos);
         
         //обновляем рёбра в обе стороны (если они существуют)
         //из перемещённой планеты в другую
-        graph->UpdateEdgeDistance(vertexId, otherId, logicalDistance);
+        graph->UpdateEdgeDistance(vertexId, otherId, distance);
         
         //из другой планеты в перемещённую
-        graph->UpdateEdgeDistance(otherId, vertexId, logicalDistance);
+        graph->UpdateEdgeDistance(otherId, vertexId, distance);
+    }
+}
+
+double GraphView::logicalDistance(const QPointF& a, const QPointF& b)
+{
+    //масштабный коэффициент (пиксели -> условные единицы расстояния)
+    const double SCALE_FACTOR = 2.0;
+    
+    //евклидово расстояние в пикселях, переведённое в условные единицы (минимум 1.0)
+    return std::max(1.0, QLineF(a, b).length() / SCALE_FACTOR);
+}
+
+void GraphView::updateAllEdgeDistances()
+{
+    //один проход по рёбрам вместо updateEdgeDistances для каждой планеты
+    for (int fromId : graph->Vertices()) {
+        if (!nodePositions.contains(fromId)) {
+            continue;
+        }
+        
+        const DynamicArray<Edge>& edges = graph->GetEdges(fromId);
+        for (int j = 0; j < edges.GetSize(); j++) {
+            int toId = edges.Get(j).to;
+            if (nodePositions.contains(toId)) {
+                graph->UpdateEdgeDistance(fromId, toId,
+                    logicalDistance(nodePositions[fromId].position, nodePositions[toId].position));
+            }
+        }
     }
 }
 
 //═══════════════════════════════════════════════════════════════
-// ЧЕРНАЯ ДЫРА - ОПАСНОСТЬ ДЛЯ ПЛАНЕТ
+// АВТОМАТИЧЕСКАЯ РАСКЛАДКА
 //═══════════════════════════════════════════════════════════════
 
-void GraphView::onBlackHoleSpawn()
+void GraphView::startAutoLayout(bool fromScratch)
 {
-    //если уже есть активная черная дыра - не спавним новую
-    if (blackHole && blackHole->getIsActive()) {
+    stopAutoLayout();
+    syncWithGraph();
+    
+    if (graph->GetVertexCount() < 2) {
         return;
     }
     
-    //удаляем старую черную дыру если она была
-    if (blackHole) {
-        delete blackHole;
-        blackHole = nullptr;
+    //текущие позиции - отправная точка (после загрузки файла они случайны)
+    std::unordered_map<int, LayoutPoint> initial;
+    if (!fromScratch) {
+        for (auto it = nodePositions.constBegin(); it != nodePositions.constEnd(); ++it) {
+            initial[it.key()] = LayoutPoint(it.value().position.x(), it.value().position.y());
+        }
     }
     
-    spawnBlackHole();
+    //снимок графа делается здесь, в потоке GUI - фоновый поток граф не трогает
+    auto layout = std::make_shared<ForceLayout>(*graph, initial);
+    
+    layoutCancelled = false;
+    layoutFitsView = fromScratch;
+    unsigned long long generation = ++layoutGeneration;
+    
+    addLogMessage(QString("🌀 Раскладка карты: %1 планет...").arg(graph->GetVertexCount()));
+    
+    layoutThread = std::thread([this, layout, generation]() {
+        auto post = [this, generation](std::unordered_map<int, LayoutPoint> positions, bool finished) {
+            QMetaObject::invokeMethod(this, [this, positions = std::move(positions), generation, finished]() {
+                applyLayoutPositions(positions, generation, finished);
+            }, Qt::QueuedConnection);
+        };
+        
+        bool completed = layout->Run(layoutCancelled, [&post](const ForceLayout& current) {
+            post(current.GetPositions(), false);
+        });
+        
+        if (completed) {
+            post(layout->GetPositions(), true);
+        }
+    });
 }
 
-void GraphView::spawnBlackHole()
+void GraphView::stopAutoLayout()
 {
-    //проверяем что есть планеты в графе
-    if (graph->GetVertexCount() == 0) {
+    layoutCancelled = true;
+    if (layoutThread.joinable()) {
+        layoutThread.join();
+    }
+    
+    //уже отправленные в очередь позиции этой раскладки устарели
+    layoutGeneration++;
+}
+
+void GraphView::applyLayoutPositions(const std::unordered_map<int, LayoutPoint>& positions,
+                                     unsigned long long generation, bool finished)
+{
+    if (generation != layoutGeneration) {
         return;
     }
     
-    //случайная позиция за пределами экрана (слева или справа)
-    QPointF startPos;
-    QPointF velocity;
+    //планеты, удалённые за время раскладки, пропускаются
+    for (const auto& entry : positions) {
+        auto it = nodePositions.find(entry.first);
+        if (it == nodePositions.end()) {
+            continue;
+        }
+        it.value().position = QPointF(entry.second.x, entry.second.y);
+        nodeGrid.Move(entry.first, entry.second.x, entry.second.y);
+        pushPlanetPosition(entry.first);
+    }
+    rebuildLaneGrid();
     
-    //50% шанс слева, 50% справа
-    if (rand() % 2 == 0) {
-        //слева направо
-        startPos = QPointF(-100, rand() % height());
-        velocity = QPointF(7.5 + (rand() % 500) / 100.0, (rand() % 200 - 100) / 100.0);
-    } else {
-        //справа налево
-        startPos = QPointF(width() + 100, rand() % height());
-        velocity = QPointF(-7.5 - (rand() % 500) / 100.0, (rand() % 200 - 100) / 100.0);
+    if (layoutFitsView) {
+        fitViewToNodes();
     }
     
-    //создаем черную дыру
-    blackHole = new BlackHole(startPos, velocity, 50.0);
+    if (finished) {
+        if (layoutThread.joinable()) {
+            layoutThread.join();
+        }
+        
+        //расстояния рёбер соответствуют итоговой геометрии
+        updateAllEdgeDistances();
+        addLogMessage("✓ Раскладка карты завершена");
+    }
     
-    //логируем событие
-    addLogMessage("⚠️ ВНИМАНИЕ! Черная дыра появилась в секторе!");
+    invalidateGraphLayer();
+    update();
 }
 
-void GraphView::onBlackHoleUpdate()
+void GraphView::fitViewToNodes()
 {
-    if (!blackHole || !blackHole->getIsActive()) {
+    if (nodePositions.isEmpty()) {
         return;
     }
     
-    //обновляем позицию черной дыры (deltaTime = 0.016 сек для 60 FPS)
-    blackHole->update(0.016);
-    
-    //проверяем коллизии с планетами
-    checkBlackHoleCollisions();
+    QRectF bounds = planetsWorldRect().adjusted(-60, -60, 60, 60);  //радиус планеты и подписи
     
+    zoom = qBound(MIN_ZOOM, std::min(width() / bounds.width(), height() / bounds.height()), MAX_ZOOM);
+    panOffset = QPointF(width() / 2.0, height() / 2.0) - bounds.center() * zoom;
+    invalidateGraphLayer();
+}
+
+//═══════════════════════════════════════════════════════════════
+// ЧЕРНАЯ ДЫРА - ОПАСНОСТЬ ДЛЯ ПЛАНЕТ
+//═══════════════════════════════════════════════════════════════
+
+void GraphView::onBlackHoleUpdate(double deltaTime)
+{
+    reportTimerTick(PerfMonitor::TimerBlackHole);
     
-    //проверяем коллизии с путями (рёбрами)
-    checkBlackHoleEdgeCollisions();
-    //проверяем коллизии с путями (рёбрами)
+    //старые области черных дыр тоже требуют перерисовки
+    QRegion dirty;
+    for (int slot : hazards.getActiveSlots()) {
+        dirty += blackHoleBounds(slot);
+    }
     
-    //проверяем что черная дыра пересекла весь экран и вышла с другой стороны
-    QPointF pos = blackHole->getPosition();
-    QPointF vel = blackHole->getVelocity();
+    //координаты планет в симуляции должны соответствовать графу до шага
+    syncWithGraph();
+    unsigned long long graphVersion = graph->GetVersion();
+    bool traderWasPlaced = trader->getIsPlaced();
     
-    bool exitedScreen = false;
+    //появление, движение, поглощения и уход черных дыр - правила симуляции,
+    //события (в том числе гибель торговца) уходят в журнал через MainWindow::onGameEvent
+    game->step(deltaTime);
     
-    //если летела слева направо (velocity.x > 0) - проверяем правый край
-    if (vel.x() > 0 && pos.x() > width() + 200) {
-        exitedScreen = true;
+    if (traderWasPlaced && !trader->getIsPlaced()) {
+        //торговец погиб: карта, торговец и черные дыры уже сброшены
+        stopAutoLayout();
+        scheduleRepaint();
+        return;
     }
     
-    //если летела справа налево (velocity.x < 0) - проверяем левый край
-    if (vel.x() < 0 && pos.x() < -200) {
-        exitedScreen = true;
+    for (int slot : hazards.getActiveSlots()) {
+        dirty += blackHoleBounds(slot);
     }
     
-    //удаляем только если улетела за экран ИЛИ время жизни вышло
-    if (exitedScreen || !blackHole->getIsActive()) {
-        delete blackHole;
-        blackHole = nullptr;
-        addLogMessage("✓ Черная дыра покинула сектор");
+    //если черные дыры что-то уничтожили - индексы и слой графа пересобираются, перерисовываем всё
+    if (graph->GetVersion() != graphVersion) {
+        syncWithGraph();
+        scheduleRepaint();
+    } else if (!dirty.isEmpty()) {
+        scheduleRepaint(dirty);
     }
-    
-    update();
 }
 
-void GraphView::checkBlackHoleCollisions()
+QRect GraphView::blackHoleBounds(int slot) const
 {
-    if (!blackHole || !blackHole->getIsActive()) {
-        return;
-    }
-    
-    //получаем все планеты
-    DynamicArray<int> vertices = graph->GetAllVertices();
+    QPointF center(hazards.getX(slot), hazards.getY(slot));
+    double radius = hazards.getRadius(slot);
+    
+    //свечение (radius * 2) и надпись под горизонтом событий
+    QRectF glow(center.x() - radius * 2.0, center.y() - radius * 2.0,
+                radius * 4.0, radius * 4.0);
+    QRectF label(center.x() - 100, center.y() + radius + 10, 200, 30);
+    return worldTransform().mapRect(glow.united(label)).toAlignedRect().adjusted(-2, -2, 2, 2);
+}
+
+void GraphView::drawBlackHoles(QPainter& painter)
+{
+    QRectF visible = visibleWorldRect();
     
-    for (int i = 0; i < vertices.GetSize(); i++) {
-        int planetId = vertices.Get(i);
+    for (int slot : hazards.getActiveSlots()) {
+        QPointF center(hazards.getX(slot), hazards.getY(slot));
+        double radius = hazards.getRadius(slot);
         
-        //проверяем есть ли позиция планеты
-        if (!nodePositions.contains(planetId)) {
+        //за пределами экрана (вместе со свечением и надписью) - не рисуем
+        QRectF bounds(center.x() - std::max(radius * 2.0, 100.0), center.y() - radius * 2.0,
+                      std::max(radius * 4.0, 200.0), radius * 4.0 + 40);
+        if (!visible.intersects(bounds)) {
             continue;
         }
         
-        QPointF planetPos = nodePositions[planetId].position;
-        
-        //проверяем столкновение с черной дырой
-        if (blackHole->collidesWithPoint(planetPos, 30.0)) {  //30 = радиус планеты
-            //получаем имя планеты
-            QString planetName = QString::fromStdString(graph->GetVertexName(planetId));
-            
-            //проверяем был ли на планете торговец
-            if (trader && trader->getIsPlaced() && trader->getCurrentPlanetId() == planetId) {
-                //сохраняем статистику до сброса
-                int completedRoutes = trader->getCompletedRoutes();
-                int totalDistance = trader->getTotalDistance();
-                QString traderName = QString::fromStdString(trader->getName());
-                
-                //сбрасываем игру
-                graph->Clear();
-                trader->reset();
-                
-                //удаляем черную дыру
-                delete blackHole;
-                blackHole = nullptr;
-                
-                addLogMessage("💀 GAME OVER - Торговец погиб!");
-                
-                //показываем сообщение ПОСЛЕ очистки
-                QMessageBox::information(this, "💀 GAME OVER", 
-                    QString("Черная дыра поглотила планету \"%1\" вместе с торговцем %2!\n\n"
-                            "🚀 Финальная статистика:\n"
-                            "   • Завершено маршрутов: %3\n"
-                            "   • Пройдено расстояние: %4\n\n"
-                            "Карта очищена. Начните новую игру!")
-                    .arg(planetName)
-                    .arg(traderName)
-                    .arg(completedRoutes)
-                    .arg(totalDistance));
-                
-                //выходим, игра уже сброшена
-                return;
-            } else {
-                //просто уничтожаем планету
-                addLogMessage(QString("💥 Черная дыра поглотила планету \"%1\"!").arg(planetName));
-                graph->RemoveVertex(planetId);
-            }
+        //эффект аккреционного диска (вращающиеся частицы)
+        double age = hazards.getAge(slot);
+        for (int i = 0; i < 12; i++) {
+            double angle = (age * 50.0 + i * 30.0) * M_PI / 180.0;
+            double dist = radius * 1.5;
+            QPointF particlePos = center + QPointF(cos(angle) * dist, sin(angle) * dist);
             
-            //выходим из цикла, так как граф изменился
-            break;
+            painter.setPen(Qt::NoPen);
+            painter.setBrush(QColor(255, 150, 0, 180));
+            painter.drawEllipse(particlePos, 3, 3);
         }
+        
+        //свечение вокруг черной дыры
+        QRadialGradient glowGradient(center, radius * 2.0);
+        glowGradient.setColorAt(0.0, QColor(255, 100, 0, 200));
+        glowGradient.setColorAt(0.5, QColor(200, 50, 0, 100));
+        glowGradient.setColorAt(1.0, QColor(100, 0, 0, 0));
+        painter.setBrush(glowGradient);
+        painter.setPen(Qt::NoPen);
+        painter.drawEllipse(center, radius * 2.0, radius * 2.0);
+        
+        //горизонт событий (черный круг)
+        painter.setBrush(QColor(10, 10, 10));
+        painter.setPen(QPen(QColor(255, 50, 0), 2));
+        painter.drawEllipse(center, radius, radius);
+        
+        //центральная сингулярность
+        painter.setBrush(QColor(0, 0, 0));
+        painter.setPen(Qt::NoPen);
+        painter.drawEllipse(center, radius * 0.3, radius * 0.3);
+        
+        //предупреждающий текст
+        painter.setPen(QColor(255, 100, 0));
+        QFont font = painter.font();
+        font.setPointSize(10);
+        font.setBold(true);
+        painter.setFont(font);
+        painter.drawText(QRectF(center.x() - 100, center.y() + radius + 10, 200, 30),
+                        Qt::AlignCenter,
+                        "⚠️ ОПАСНО ⚠️");
     }
 }
 
-void GraphView::drawBlackHole(QPainter& painter)
+HazardForecast GraphView::forecastHazards()
 {
-    if (!blackHole || !blackHole->getIsActive()) {
+    //позиции должны соответствовать текущему графу
+    syncWithGraph();
+    
+    HazardForecast forecast;
+    for (int slot : hazards.getActiveSlots()) {
+        forecast.AddHazard(HazardTrack(hazards.getX(slot), hazards.getY(slot),
+                                       hazards.getVelocityX(slot), hazards.getVelocityY(slot),
+                                       hazards.getRadius(slot),
+                                       hazards.getLifetime(slot) - hazards.getAge(slot)));
+    }
+    for (auto it = nodePositions.constBegin(); it != nodePositions.constEnd(); ++it) {
+        forecast.SetPlanetPosition(it.key(), it->position.x(), it->position.y());
+    }
+    forecast.Compute(*graph);
+    return forecast;
+}
+
+//═══════════════════════════════════════════════════════════════
+// ИНДЕКСЫ ПЛАНЕТ И РЁБЕР
+//═══════════════════════════════════════════════════════════════
+
+void GraphView::syncWithGraph()
+{
+    if (isSyncedWithGraph()) {
         return;
     }
     
-    QPointF center = blackHole->getPosition();
-    double radius = blackHole->getRadius();
-    
-    //эффект аккреционного диска (вращающиеся частицы)
-    double age = blackHole->getAge();
-    for (int i = 0; i < 12; i++) {
-        double angle = (age * 50.0 + i * 30.0) * M_PI / 180.0;
-        double dist = radius * 1.5;
-        QPointF particlePos = center + QPointF(cos(angle) * dist, sin(angle) * dist);
+    //артефакты и веса переходов меняют только слой карты, индексы перестраиваются при смене вершин и рёбер
+    if (syncedTopologyVersion != graph->GetTopologyVersion()) {
+        updateNodePositions();
+        rebuildLaneGrid();
         
-        painter.setPen(Qt::NoPen);
-        painter.setBrush(QColor(255, 150, 0, 180));
-        painter.drawEllipse(particlePos, 3, 3);
+        //симуляция сама следит за своими планетами, передаём только новые
+        //(после очистки или загрузки reset сбросил все её координаты)
+        for (auto it = nodePositions.constBegin(); it != nodePositions.constEnd(); ++it) {
+            if (!game->hasPlanetPosition(it.key())) {
+                pushPlanetPosition(it.key());
+            }
+        }
+        syncedTopologyVersion = graph->GetTopologyVersion();
     }
+    syncedGraphVersion = graph->GetVersion();
+    invalidateGraphLayer();
+}
+
+void GraphView::pushPlanetPosition(int nodeId)
+{
+    //столкновения с черными дырами симуляция проверяет по этим координатам
+    if (graph->HasVertex(nodeId)) {
+        QPointF position = nodePositions.value(nodeId).position;
+        game->setPlanetPosition(nodeId, position.x(), position.y());
+    }
+}
+
+qint64 GraphView::laneKey(int from, int to)
+{
+    return (static_cast<qint64>(from) << 32) | static_cast<quint32>(to);
+}
+
+void GraphView::rebuildLaneGrid()
+{
+    laneGrid.Clear();
+    nodeLanes.clear();
     
-    //свечение вокруг черной дыры
-    QRadialGradient glowGradient(center, radius * 2.0);
-    glowGradient.setColorAt(0.0, QColor(255, 100, 0, 200));
-    glowGradient.setColorAt(0.5, QColor(200, 50, 0, 100));
-    glowGradient.setColorAt(1.0, QColor(100, 0, 0, 0));
-    painter.setBrush(glowGradient);
-    painter.setPen(Qt::NoPen);
-    painter.drawEllipse(center, radius * 2.0, radius * 2.0);
-    
-    //горизонт событий (черный круг)
-    painter.setBrush(QColor(10, 10, 10));
-    painter.setPen(QPen(QColor(255, 50, 0), 2));
-    painter.drawEllipse(center, radius, radius);
+    for (int fromId : graph->Vertices()) {
+        const DynamicArray<Edge>& edges = graph->GetEdges(fromId);
+        for (int j = 0; j < edges.GetSize(); j++) {
+            updateLane(fromId, edges.Get(j).to);
+        }
+    }
+}
+
+void GraphView::updateLane(int from, int to)
+{
+    if (!nodePositions.contains(from) || !nodePositions.contains(to)) {
+        return;
+    }
     
-    //центральная сингулярность
-    painter.setBrush(QColor(0, 0, 0));
-    painter.setPen(Qt::NoPen);
-    painter.drawEllipse(center, radius * 0.3, radius * 0.3);
+    QPointF a = nodePositions[from].position;
+    QPointF b = nodePositions[to].position;
+    qint64 key = laneKey(from, to);
     
-    //предупреждающий текст
-    painter.setPen(QColor(255, 100, 0));
-    QFont font = painter.font();
-    font.setPointSize(10);
-    font.setBold(true);
-    painter.setFont(font);
-    painter.drawText(QRectF(center.x() - 100, center.y() + radius + 10, 200, 30),
-                    Qt::AlignCenter,
-                    "⚠️ ОПАСНО ⚠️");
+    laneGrid.InsertBox(key, a.x(), a.y(), b.x(), b.y());
+    nodeLanes[from].insert(key);
+    nodeLanes[to].insert(key);
 }
 
-void GraphView::checkBlackHoleEdgeCollisions()
+void GraphView::updateNodeLanes(int nodeId)
+{
+    //копия: updateLane изменяет nodeLanes
+    const QSet<qint64> lanes = nodeLanes.value(nodeId);
+    for (qint64 key : lanes) {
+        updateLane(static_cast<int>(key >> 32), static_cast<int>(key & 0xFFFFFFFF));
+    }
+}
+
+//═══════════════════════════════════════════════════════════════
+// ОВЕРЛЕЙ ПРОИЗВОДИТЕЛЬНОСТИ (ENABLE_PERF_OVERLAY в visual_effects.h)
+//═══════════════════════════════════════════════════════════════
+
+void GraphView::setPerfOverlayVisible(bool visible)
 {
-    if (!blackHole || !blackHole->getIsActive()) {
+    if constexpr (!ENABLE_PERF_OVERLAY) {
         return;
     }
     
-    QPointF blackHolePos = blackHole->getPosition();
-    double blackHoleRadius = blackHole->getRadius();
-    
-    DynamicArray<int> vertices = graph->GetAllVertices();
+    perfOverlayVisible = visible;
+    clock.setEnabled(perfOverlaySystem, visible);
+    update(perfOverlayRect());
+}
+
+void GraphView::reportTimerTick(PerfMonitor::Timer timer)
+{
+    if constexpr (ENABLE_PERF_OVERLAY) {
+        perf.tick(timer);
+    }
+}
+
+bool GraphView::dumpPerfStats(const QString& path) const
+{
+    return perf.writeCsv(path);
+}
+
+QRect GraphView::perfOverlayRect() const
+{
+    //строка сводки + слои + таймеры + строка тайлов
+    const int lines = 2 + PerfMonitor::LayerCount + PerfMonitor::TimerCount;
+    return QRect(10, 10, 340, lines * 14 + 12);
+}
+
+void GraphView::drawPerfOverlay(QPainter& painter)
+{
+    QStringList lines = perf.report();
+    const MapRenderer::FrameStats& tiles = mapRenderer->lastFrameStats();
+    lines << QString("тайлы: %1, растеризация %2 мс")
+                 .arg(tiles.tiles)
+                 .arg(tiles.wallNs / 1e6, 0, 'f', 2);
+    
+    QRect box = perfOverlayRect();
+    painter.save();
+    painter.resetTransform();
+    painter.fillRect(box, QColor(0, 0, 0, 170));
+    
+    QFont font("Monospace");
+    font.setPointSize(8);
+    painter.setFont(font);
+    painter.setPen(QColor(120, 255, 160));
     
-    for (int i = 0; i < vertices.GetSize(); i++) {
-        int fromId = vertices.Get(i);
-        
-        if (!nodePositions.contains(fromId)) {
-            continue;
-        }
-        
-        const DynamicArray<Edge>& edges = graph->GetEdges(fromId);
-        
-        for (int j = 0; j < edges.GetSize(); j++) {
-            const Edge& edge = edges.Get(j);
-            int toId = edge.to;
-            
-            if (!nodePositions.contains(toId)) {
-                continue;
-            }
-            
-            QPointF fromPos = nodePositions[fromId].position;
-            QPointF toPos = nodePositions[toId].position;
-            
-            QPointF lineVec = toPos - fromPos;
-            QPointF pointVec = blackHolePos - fromPos;
-            
-            double lineLen = QLineF(fromPos, toPos).length();
-            if (lineLen < 0.001) continue;
-            
-            double t = QPointF::dotProduct(pointVec, lineVec) / (lineLen * lineLen);
-            t = qBound(0.0, t, 1.0);
-            
-            QPointF closestPoint = fromPos + lineVec * t;
-            
-            double distance = QLineF(blackHolePos, closestPoint).length();
-            
-            if (distance <= blackHoleRadius) {
-                QString fromName = QString::fromStdString(graph->GetVertexName(fromId));
-                QString toName = QString::fromStdString(graph->GetVertexName(toId));
-                
-                addLogMessage(QString("💥 Черная дыра разорвала путь %1 → %2!")
-                             .arg(fromName).arg(toName));
-                
-                graph->RemoveEdge(fromId, toId);
-                break;
-            }
-        }
+    int y = box.top() + 16;
+    for (const QString& line : lines) {
+        painter.drawText(box.left() + 6, y, line);
+        y += 14;
     }
+    painter.restore();
 }
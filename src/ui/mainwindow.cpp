@@ -3,35 +3,44 @@
 #include "addplanetdialog.h"
 #include "addedgedialog.h"
 #include "Dijkstra.h"
+#include "ParetoRouter.h"
+#include "KShortestPaths.h"
+#include "TourPlanner.h"
+#include "RouteRiskSimulator.h"
 #include "piratebattle.h"
+#include "planetpickerdialog.h"
 #include <cstdlib>
 #include <ctime>
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QFileInfo>
-#include <QInputDialog>
 #include <QToolBar>
 #include <QAction>
 #include <QMenu>
 #include <QMenuBar>
 #include <QStatusBar>
 #include <QLabel>
+#include <QInputDialog>
+#include <QActionGroup>
+#include <QTimer>
 #include <chrono>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
-    , trader("Капитан Смит")
-    , gameTimeSeconds(0)
-    , collectedArtifacts(0)
-    , gameStarted(false)
+    , game(gameSettings())
+    , graph(game.getGraph())
+    , trader(game.getTrader())
+    , gameSystem(-1)
+    , routeMetric(RouteMetric::Cost)
+    , routeDistanceBudget(0.0)
 {
     ui->setupUi(this);
     
     setWindowTitle("🚀 Навигатор Вольного Торговца - Космическая Логистика");
     
     //создаем виджет визуализации графа
-    graphView = new GraphView(&graph, this);
+    graphView = new GraphView(&game, this);
     setCentralWidget(graphView);
     
     //создаем панель инструментов
@@ -45,6 +54,10 @@ MainWindow::MainWindow(QWidget *parent)
     QAction *removeEdgeAction = toolbar->addAction("✂️ Удалить переход");
     toolbar->addSeparator();
     QAction *findPathAction = toolbar->addAction("🎯 Найти путь");
+    QAction *chooseRouteAction = toolbar->addAction("⚖️ Варианты маршрута");
+    QAction *alternativeRoutesAction = toolbar->addAction("🔀 Альтернативные маршруты");
+    QAction *artifactTourAction = toolbar->addAction("🗺️ Сбор артефактов");
+    QAction *autoLayoutAction = toolbar->addAction("🌀 Раскладка");
     toolbar->addSeparator();
     QAction *loadFileAction = toolbar->addAction("📂 Открыть файл");
     QAction *saveFileAction = toolbar->addAction("💾 Сохранить в файл");
@@ -70,9 +83,72 @@ MainWindow::MainWindow(QWidget *parent)
     
     QMenu *toolsMenu = menuBar()->addMenu("&Инструменты");
     toolsMenu->addAction(findPathAction);
+    toolsMenu->addAction(chooseRouteAction);
+    toolsMenu->addAction(alternativeRoutesAction);
+    toolsMenu->addAction(artifactTourAction);
+    toolsMenu->addAction(autoLayoutAction);
+    
+    //═══ режим выбора маршрута для "Найти путь" ═══
+    QMenu *routeModeMenu = toolsMenu->addMenu("🧭 Режим маршрута");
+    QActionGroup *routeModeGroup = new QActionGroup(this);
+    QAction *costModeAction = routeModeMenu->addAction("Минимальная стоимость");
+    QAction *survivalModeAction = routeModeMenu->addAction("Максимальный шанс избежать пиратов");
+    QAction *budgetModeAction = routeModeMenu->addAction("Шанс избежать пиратов с лимитом расстояния...");
+    for (QAction *action : {costModeAction, survivalModeAction, budgetModeAction}) {
+        action->setCheckable(true);
+        routeModeGroup->addAction(action);
+    }
+    costModeAction->setChecked(true);
+    
+    connect(costModeAction, &QAction::triggered, this, [this]() {
+        routeMetric = RouteMetric::Cost;
+        logMessage("🧭 Режим маршрута: минимальная стоимость");
+    });
+    connect(survivalModeAction, &QAction::triggered, this, [this]() {
+        routeMetric = RouteMetric::Survival;
+        routeDistanceBudget = 0.0;
+        logMessage("🧭 Режим маршрута: максимальный шанс избежать пиратов");
+    });
+    connect(budgetModeAction, &QAction::triggered, this,
+            [this, costModeAction, survivalModeAction, budgetModeAction]() {
+        bool ok;
+        double budget = QInputDialog::getDouble(this, "Лимит расстояния",
+            "Максимальное суммарное расстояние маршрута:",
+            routeDistanceBudget > 0.0 ? routeDistanceBudget : 500.0, 1.0, 1e9, 1, &ok);
+        if (!ok) {
+            //отмена - отметка возвращается на действующий режим
+            if (routeMetric == RouteMetric::Cost) {
+                costModeAction->setChecked(true);
+            } else if (routeDistanceBudget <= 0.0) {
+                survivalModeAction->setChecked(true);
+            } else {
+                budgetModeAction->setChecked(true);
+            }
+            return;
+        }
+        routeMetric = RouteMetric::Survival;
+        routeDistanceBudget = budget;
+        logMessage(QString("🧭 Режим маршрута: шанс избежать пиратов, расстояние не больше %1")
+                  .arg(budget, 0, 'f', 1));
+    });
+    
     toolsMenu->addSeparator();
     toolsMenu->addAction(traderInfoAction);
     
+    //═══ оверлей производительности (только если включен в visual_effects.h) ═══
+    if constexpr (ENABLE_PERF_OVERLAY) {
+        toolsMenu->addSeparator();
+        QAction *perfOverlayAction = toolsMenu->addAction("📊 Производительность");
+        perfOverlayAction->setCheckable(true);
+        perfOverlayAction->setShortcut(Qt::Key_F3);
+        connect(perfOverlayAction, &QAction::toggled, this, [this](bool checked) {
+            graphView->setPerfOverlayVisible(checked);
+        });
+        
+        QAction *perfDumpAction = toolsMenu->addAction("Сохранить статистику кадров...");
+        connect(perfDumpAction, &QAction::triggered, this, &MainWindow::onSavePerfStats);
+    }
+    
     QMenu *helpMenu = menuBar()->addMenu("&Справка");
     QAction *aboutAction = helpMenu->addAction("О программе");
     
@@ -82,6 +158,12 @@ MainWindow::MainWindow(QWidget *parent)
     connect(removePlanetAction, &QAction::triggered, this, &MainWindow::onRemovePlanet);
     connect(removeEdgeAction, &QAction::triggered, this, &MainWindow::onRemoveEdge);
     connect(findPathAction, &QAction::triggered, this, &MainWindow::onFindPath);
+    connect(chooseRouteAction, &QAction::triggered, this, &MainWindow::onChooseRoute);
+    connect(alternativeRoutesAction, &QAction::triggered, this, &MainWindow::onAlternativeRoutes);
+    connect(artifactTourAction, &QAction::triggered, this, &MainWindow::onPlanArtifactTour);
+    connect(autoLayoutAction, &QAction::triggered, this, [this]() {
+        graphView->startAutoLayout();
+    });
     connect(loadFileAction, &QAction::triggered, this, &MainWindow::onLoadFromFile);
     connect(saveFileAction, &QAction::triggered, this, &MainWindow::onSaveToFile);
     connect(clearAction, &QAction::triggered, this, &MainWindow::onClearGraph);
@@ -90,16 +172,20 @@ MainWindow::MainWindow(QWidget *parent)
     connect(traderInfoAction, &QAction::triggered, this, &MainWindow::onShowTraderInfo);
     
     //═══ инициализация игровых таймеров ═══
-    gameTimer = new QTimer(this);
-    connect(gameTimer, &QTimer::timeout, this, &MainWindow::onGameTimerTick);
+    //секундомер игры - система на часах симуляции карты (включается при старте игры)
+    gameSystem = graphView->simulationClock().addSystem("game", 1.0,
+        [this](double) { onGameTimerTick(); }, false);
+    
+    //правила игры сообщают о происходящем событиями
+    game.setEventHandler([this](const GameEvent& event) { onGameEvent(event); });
+    
     
-
     //═══ статус бар ═══
     statusLabel = new QLabel(this);
     statusBar()->addWidget(statusLabel, 1); //растягивается
     
     //добавляем лейбл для артефактов
-    artifactLabel = new QLabel("⭐ Артефактов: 0 / 10", this);
+    artifactLabel = new QLabel(QString("⭐ Артефактов: 0 / %1").arg(game.getSettings().requiredArtifacts), this);
     artifactLabel->setStyleSheet("color: gold; font-weight: bold; padding: 0 10px;");
     statusBar()->addPermanentWidget(artifactLabel);
     
@@ -115,6 +201,7 @@ MainWindow::MainWindow(QWidget *parent)
     
     logMessage("Добро пожаловать в Навигатор Вольного Торговца!");
     logMessage("📍 Торговец: " + QString::fromStdString(trader.getName()));
+    logMessage(QString("🎲 Seed: %1").arg(game.getRandom().getSeed()));
     logMessage("⚠️ Загрузите граф или создайте первую планету для размещения торговца");
 }
 
@@ -139,20 +226,14 @@ void MainWindow::onAddPlanet()
         try {
             graph.AddVertex(planetName.toStdString());
             
-            //если это первая планета - размещаем торговца
-            if (graph.GetVertexCount() == 1 && !trader.getIsPlaced()) {
-                int planetId = graph.GetVertexIndex(planetName.toStdString());
-                trader.placeOnPlanet(planetId);
-                logMessage("🚀 Торговец \"" + QString::fromStdString(trader.getName()) + 
-                          "\" высадился на планете \"" + planetName + "\"");
-            }
+            //если торговца ещё нет на карте - высаживаем на первую планету
+            game.placeTraderIfNeeded();
             
-            graphView->setTrader(&trader);  //передаём торговца в graphview
             graphView->update();
             updateStatusBar();
             logMessage("✓ Планета \"" + planetName + "\" добавлена");
             
-            checkGameStart(); //проверяем запуск игры
+            game.checkGameStart(); //проверяем запуск игры
         } catch (const std::exception& e) {
             QMessageBox::warning(this, "Ошибка", 
                 QString("Не удалось добавить планету: %1").arg(e.what()));
@@ -198,17 +279,10 @@ void MainWindow::onRemovePlanet()
         return;
     }
     
-    //получаем список всех планет
-    QStringList planets;
-    const auto& allPlanets = graph.GetAllPlanets();
-    for (const auto& pair : allPlanets) {
-        planets << QString::fromStdString(pair.second);
-    }
-    
     //выбор планеты для удаления
     bool ok;
-    QString planetName = QInputDialog::getItem(this, "Удаление планеты",
-        "Выберите планету для удаления:", planets, 0, false, &ok);
+    QString planetName = PlanetPickerDialog::getPlanet(this, &graph, "Удаление планеты",
+        "Выберите планету для удаления:", &ok);
     
     if (ok && !planetName.isEmpty()) {
         //проверяем, не находится ли торговец на этой планете
@@ -261,17 +335,10 @@ void MainWindow::onRemoveEdge()
         return;
     }
     
-    //получаем список всех планет
-    QStringList planets;
-    const auto& allPlanets = graph.GetAllPlanets();
-    for (const auto& pair : allPlanets) {
-        planets << QString::fromStdString(pair.second);
-    }
-    
     //выбор начальной планеты
     bool ok1;
-    QString fromPlanet = QInputDialog::getItem(this, "Удаление перехода",
-        "Выберите начальную планету:", planets, 0, false, &ok1);
+    QString fromPlanet = PlanetPickerDialog::getPlanet(this, &graph, "Удаление перехода",
+        "Выберите начальную планету:", &ok1);
     
     if (!ok1 || fromPlanet.isEmpty()) {
         return;
@@ -279,8 +346,8 @@ void MainWindow::onRemoveEdge()
     
     //выбор конечной планеты
     bool ok2;
-    QString toPlanet = QInputDialog::getItem(this, "Удаление перехода",
-        "Выберите конечную планету:", planets, 0, false, &ok2);
+    QString toPlanet = PlanetPickerDialog::getPlanet(this, &graph, "Удаление перехода",
+        "Выберите конечную планету:", &ok2);
     
     if (!ok2 || toPlanet.isEmpty()) {
         return;
@@ -321,137 +388,290 @@ void MainWindow::onRemoveEdge()
     }
 }
 
-void MainWindow::onFindPath()
+bool MainWindow::pickRouteEndpoints(QString& fromPlanet, QString& toPlanet)
 {
     if (graph.GetVertexCount() < 2) {
         QMessageBox::information(this, "Информация", 
             "Недостаточно планет для построения маршрута!");
-        return;
+        return false;
     }
     
     if (!trader.getIsPlaced()) {
         QMessageBox::warning(this, "Ошибка",
             "⚠️ Торговец не размещён на карте!\n\nСоздайте планету или загрузите граф.");
-        return;
-    }
-    
-    //получаем список всех планет
-    QStringList planets;
-    const auto& allPlanets = graph.GetAllPlanets();
-    for (const auto& pair : allPlanets) {
-        planets << QString::fromStdString(pair.second);
+        return false;
     }
     
     //текущая позиция торговца как начальная точка
     std::string currentPlanetName = graph.GetVertexName(trader.getCurrentPlanetId());
-    QString fromPlanet = QString::fromStdString(currentPlanetName);
+    fromPlanet = QString::fromStdString(currentPlanetName);
     
     logMessage(QString("🚀 Торговец находится на планете: %1").arg(fromPlanet));
     
     //выбор конечной планеты
     bool ok;
-    QString toPlanet = QInputDialog::getItem(this, "Пункт назначения",
-        QString("Торговец на: %1\nВыберите пункт назначения:").arg(fromPlanet),
-        planets, 0, false, &ok);
+    toPlanet = PlanetPickerDialog::getPlanet(this, &graph, "Пункт назначения",
+        QString("Торговец на: %1\nВыберите пункт назначения:").arg(fromPlanet), &ok);
     
-    if (!ok) return;
+    if (!ok) return false;
     
     if (fromPlanet == toPlanet) {
         QMessageBox::information(this, "Информация",
             "Торговец уже находится на этой планете!");
+        return false;
+    }
+    
+    return true;
+}
+
+void MainWindow::onFindPath()
+{
+    QString fromPlanet, toPlanet;
+    if (!pickRouteEndpoints(fromPlanet, toPlanet)) {
         return;
     }
     
-    //поиск пути
+    //поиск пути в обход черных дыр: рёбра и планеты, которые будут поглощены
+    //до прохода торговца, исключаются; если обхода нет - только штрафуются
+    int startId = graph.GetVertexIndex(fromPlanet.toStdString());
+    int endId = graph.GetVertexIndex(toPlanet.toStdString());
+    HazardForecast forecast = graphView->forecastHazards();
+    
     Dijkstra dijkstra(graph);
     auto start = std::chrono::high_resolution_clock::now();
-    DijkstraResult result = dijkstra.FindShortestPath(
-        fromPlanet.toStdString(), toPlanet.toStdString());
+    DijkstraResult result;
+    bool hazardAvoided = true;
+    if (routeMetric == RouteMetric::Survival && routeDistanceBudget > 0.0) {
+        //выживание с лимитом расстояния (прогноз черных дыр здесь не учитывается)
+        result = dijkstra.FindSafestPath(startId, endId, routeDistanceBudget);
+    } else {
+        result = dijkstra.FindShortestPath(startId, endId, forecast,
+            HazardPolicy(HazardPolicy::Avoid, Trader::CRUISE_SPEED), routeMetric);
+        hazardAvoided = result.pathExists;
+        if (!result.pathExists && forecast.GetHazardCount() > 0) {
+            result = dijkstra.FindShortestPath(startId, endId, forecast,
+                HazardPolicy(HazardPolicy::Penalize, Trader::CRUISE_SPEED), routeMetric);
+        }
+    }
     auto end = std::chrono::high_resolution_clock::now();
     
+    if (forecast.GetThreatenedLaneCount() > 0 || forecast.GetThreatenedPlanetCount() > 0) {
+        logMessage(QString("🕳️ Прогноз: черные дыры поглотят планет - %1, путей - %2")
+                  .arg(forecast.GetThreatenedPlanetCount())
+                  .arg(forecast.GetThreatenedLaneCount()));
+        if (result.pathExists && !hazardAvoided) {
+            logMessage("⚠ Безопасного обхода нет - маршрут проходит через зону черной дыры!");
+        }
+    }
+    
     auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
     
     showPathResult(result, fromPlanet, toPlanet, duration.count());
     
-    //визуализируем путь
+    //визуализируем путь и отправляем торговца теми переходами, по которым посчитан результат
     if (result.pathExists) {
-        graphView->highlightPath(result.path);
-        
-        //перемещаем торговца в конечную точку
-        int destinationId = graph.GetVertexIndex(toPlanet.toStdString());
-        //═══ ПРОВЕРКА НАПАДЕНИЯ ПИРАТОВ ═══
-        bool defeatedByPirates = false;
-        for (int i = 0; i < result.path.GetSize() - 1; i++) {
-            int fromId = result.path.Get(i);
-            int toId = result.path.Get(i + 1);
-            
-            const DynamicArray<Edge>& edges = graph.GetEdges(fromId);
-            for (int j = 0; j < edges.GetSize(); j++) {
-                if (edges.Get(j).to == toId) {
-                    double riskFactor = edges.Get(j).data.riskFactor;
-                    double random = (rand() % 100) / 100.0;
-                    
-                    if (random < riskFactor) {
-                        QString fromName = QString::fromStdString(graph.GetVertexName(fromId));
-                        QString toName = QString::fromStdString(graph.GetVertexName(toId));
-                        
-                        logMessage(QString("🏴‍☠️ ТРЕВОГА! Пираты атакуют на пути %1 → %2!")
-                                  .arg(fromName).arg(toName));
-                        
-                        PirateBattle battle(riskFactor, this);
-                        battle.exec();
-                        
-                        if (!battle.isVictory()) {
-                            defeatedByPirates = true;
-                            QMessageBox::critical(this, "💀 GAME OVER",
-                                QString("💀 Пираты уничтожили ваш корабль!\n\n"
-                                       "🏴‍☠️ Место гибели: между %1 и %2\n"
-                                       "🚀 Статистика:\n"
-                                       "   • Завершено маршрутов: %3\n"
-                                       "   • Пройдено расстояние: %4\n\n"
-                                       "Игра окончена!")
-                                .arg(fromName).arg(toName)
-                                .arg(trader.getCompletedRoutes())
-                                .arg(trader.getTotalDistance()));
-                            
-                            graph.Clear();
-                            trader.reset();
-                            updateTraderDisplay();
-                            logMessage("💀 GAME OVER - Корабль уничтожен пиратами!");
-                            return;
-                        } else {
-                            logMessage(QString("⚔️ Пираты повержены! Путь %1 → %2 свободен!")
-                                      .arg(fromName).arg(toName));
-                        }
-                    }
-                    break;
-                }
-            }
-            
-            if (defeatedByPirates) break;
-        }
-        
-        if (!defeatedByPirates) {
-        trader.setCurrentPlanet(destinationId);
-        
-        //собираем артефакты на всех планетах пути
-        for (int i = 0; i < result.path.GetSize(); i++) {
-            int planetId = result.path.Get(i);
-            if (graph.HasArtifact(planetId)) {
-                collectArtifact(planetId);
-            }
-        }
-        trader.completeRoute(static_cast<int>(result.totalCost));
-        
-        logMessage(QString("✓ Торговец прибыл на планету: %1").arg(toPlanet));
-        logMessage(QString("📊 Всего маршрутов: %1 | Пройдено: %2")
-                  .arg(trader.getCompletedRoutes())
-                  .arg(trader.getTotalDistance()));
-        
-        updateTraderDisplay();
+        travelRoute(result.path, result.lanes, result.totalCost);
+    }
+}
+
+void MainWindow::onChooseRoute()
+{
+    QString fromPlanet, toPlanet;
+    if (!pickRouteEndpoints(fromPlanet, toPlanet)) {
+        return;
+    }
+    
+    //фронт Парето: каждый следующий вариант длиннее, но безопаснее предыдущего
+    ParetoRouter::Settings settings;
+    settings.maxRoutes = MAX_ROUTE_OPTIONS;
+    ParetoRouter router(graph, settings);
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<ParetoRoute> front = router.FindParetoFront(
+        fromPlanet.toStdString(), toPlanet.toStdString());
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    
+    if (front.empty()) {
+        QMessageBox::warning(this, "Маршрут не найден",
+            QString("Не удалось найти путь от %1 до %2.\n"
+                   "Планеты не связаны.").arg(fromPlanet).arg(toPlanet));
+        logMessage(QString("⚠ Путь %1 → %2 не найден").arg(fromPlanet).arg(toPlanet));
+        return;
     }
+    
+    logMessage(QString("⚖️ Вариантов маршрута %1 → %2: %3 (расчет: %4 мкс)")
+              .arg(fromPlanet).arg(toPlanet)
+              .arg(front.size())
+              .arg(duration.count()));
+    
+    QStringList options;
+    for (size_t i = 0; i < front.size(); i++) {
+        options << QString("%1. Расстояние: %2 | Риск встречи с пиратами: %3% | Переходов: %4")
+                   .arg(i + 1)
+                   .arg(front[i].distance, 0, 'f', 1)
+                   .arg(front[i].encounterProbability * 100.0, 0, 'f', 1)
+                   .arg(front[i].path.GetSize() - 1);
+    }
+    
+    bool ok;
+    QString choice = QInputDialog::getItem(this, "Варианты маршрута",
+        QString("%1 → %2\nКороткие маршруты опаснее, безопасные - длиннее:").arg(fromPlanet).arg(toPlanet),
+        options, 0, false, &ok);
+    if (!ok) return;
+    
+    const ParetoRoute& route = front[options.indexOf(choice)];
+    logMessage(QString("🎯 Выбран маршрут %1 → %2 (расстояние: %3, риск встречи: %4%)")
+              .arg(fromPlanet).arg(toPlanet)
+              .arg(route.distance, 0, 'f', 1)
+              .arg(route.encounterProbability * 100.0, 0, 'f', 1));
+    
+    //летим именно теми переходами, по которым посчитаны расстояние и риск варианта
+    travelRoute(route.path, route.lanes, route.distance);
 }
+
+void MainWindow::onAlternativeRoutes()
+{
+    QString fromPlanet, toPlanet;
+    if (!pickRouteEndpoints(fromPlanet, toPlanet)) {
+        return;
+    }
+    
+    //K лучших маршрутов в текущем режиме; почти совпадающие с уже выбранными пропускаются
+    KShortestPaths::Settings settings;
+    settings.k = ALTERNATIVE_ROUTES;
+    settings.maxSharedFraction = MAX_SHARED_LANES;
+    settings.metric = routeMetric;
+    KShortestPaths finder(graph, settings);
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<DijkstraResult> routes = finder.FindPaths(fromPlanet.toStdString(), toPlanet.toStdString());
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    
+    if (routes.empty()) {
+        QMessageBox::warning(this, "Маршрут не найден",
+            QString("Не удалось найти путь от %1 до %2.\n"
+                   "Планеты не связаны.").arg(fromPlanet).arg(toPlanet));
+        logMessage(QString("⚠ Путь %1 → %2 не найден").arg(fromPlanet).arg(toPlanet));
+        return;
+    }
+    
+    logMessage(QString("🔀 Альтернативных маршрутов %1 → %2: %3 (расчет: %4 мкс)")
+              .arg(fromPlanet).arg(toPlanet)
+              .arg(routes.size())
+              .arg(duration.count()));
+    
+    //вероятность долететь с учётом битв (встреча с пиратами ещё не гибель) - в замкнутой форме,
+    //без моделирования в потоке окна; переходы - те же, что у описания маршрута и полёта
+    RouteRiskSimulator simulator;
+    
+    //список упорядочен по метрике поиска - она и показывается первой
+    bool bySurvival = routeMetric == RouteMetric::Survival;
+    QStringList options;
+    for (size_t i = 0; i < routes.size(); i++) {
+        double arrival = simulator.exactSurvival(RouteRiskSimulator::laneRisks(graph, routes[i].path, routeMetric));
+        QString cost = QString("Стоимость: %1").arg(routes[i].totalCost, 0, 'f', 1);
+        QString survival = QString("Шанс без пиратов: %1%").arg(routes[i].survivalProbability * 100.0, 0, 'f', 1);
+        options << QString("%1. %2 | %3 | Долетит: %4% | Переходов: %5")
+                   .arg(i + 1)
+                   .arg(bySurvival ? survival : cost)
+                   .arg(bySurvival ? cost : survival)
+                   .arg(arrival * 100.0, 0, 'f', 1)
+                   .arg(routes[i].path.GetSize() - 1);
+    }
+    
+    bool ok;
+    QString choice = QInputDialog::getItem(this, "Альтернативные маршруты",
+        QString("%1 → %2\n%3").arg(fromPlanet).arg(toPlanet)
+            .arg(bySurvival ? "Маршруты от самого безопасного:" : "Маршруты по возрастанию стоимости:"),
+        options, 0, false, &ok);
+    if (!ok) return;
+    
+    const DijkstraResult& route = routes[options.indexOf(choice)];
+    logMessage(QString("🎯 Выбран маршрут %1 → %2 (стоимость: %3, шанс без пиратов: %4%)")
+              .arg(fromPlanet).arg(toPlanet)
+              .arg(route.totalCost, 0, 'f', 1)
+              .arg(route.survivalProbability * 100.0, 0, 'f', 1));
+    
+    travelRoute(route.path, route.totalCost, routeMetric);
+}
+
+void MainWindow::onPlanArtifactTour()
+{
+    if (!trader.getIsPlaced()) {
+        QMessageBox::warning(this, "Ошибка",
+            "⚠️ Торговец не размещён на карте!\n\nСоздайте планету или загрузите граф.");
+        return;
+    }
+    
+    std::vector<int> targets;
+    for (int planetId : graph.Vertices()) {
+        if (graph.HasArtifact(planetId) && planetId != trader.getCurrentPlanetId()) {
+            targets.push_back(planetId);
         }
+    }
+    if (targets.empty()) {
+        QMessageBox::information(this, "Информация", "На карте нет артефактов для сбора.");
+        return;
+    }
+    
+    TourPlanner::Settings settings;
+    settings.metric = routeMetric;
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    TourPlan plan = TourPlanner(graph, settings).PlanTour(trader.getCurrentPlanetId(), targets);
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    
+    for (int planetId : plan.unreachable) {
+        logMessage(QString("⚠ Артефакт на планете \"%1\" недостижим")
+                  .arg(QString::fromStdString(graph.GetVertexName(planetId))));
+    }
+    if (plan.order.empty() || !plan.feasible) {
+        QMessageBox::warning(this, "Маршрут не найден",
+            "Не удалось построить обход планет с артефактами.");
+        return;
+    }
+    
+    QStringList stops;
+    for (int planetId : plan.order) {
+        stops << QString::fromStdString(graph.GetVertexName(planetId));
+    }
+    logMessage(QString("🗺️ Обход артефактов: %1 (стоимость: %2, расчет: %3 мкс%4)")
+              .arg(stops.join(" → "))
+              .arg(plan.totalCost, 0, 'f', 1)
+              .arg(duration.count())
+              .arg(plan.timedOut ? ", остановлен по времени" : ""));
+    
+    travelRoute(plan.path, plan.totalCost, routeMetric);
+}
+
+void MainWindow::travelRoute(const DynamicArray<int>& path, double cost, RouteMetric metric)
+{
+    graphView->highlightPath(path);
+    
+    //нападения, артефакты и прибытие - правила симуляции; битву ведёт игрок в диалоге
+    game.travelRoute(path, cost, metric, battleResolver());
+    
+    updateTraderDisplay();
+}
+
+void MainWindow::travelRoute(const DynamicArray<int>& path, const DynamicArray<int>& lanes, double cost)
+{
+    graphView->highlightPath(path);
+    game.travelRoute(path, lanes, cost, battleResolver());
+    updateTraderDisplay();
+}
+
+GameSimulation::BattleResolver MainWindow::battleResolver()
+{
+    return [this](int, int, double riskFactor) {
+        PirateBattle battle(riskFactor, this);
+        battle.exec();
+        return battle.isVictory();
+    };
+}
 
 void MainWindow::onClearGraph()
 {
@@ -462,20 +682,9 @@ void MainWindow::onClearGraph()
         QMessageBox::Yes | QMessageBox::No);
     
     if (reply == QMessageBox::Yes) {
-        graph.Clear();
-        trader.reset();  //сбрасываем торговца
-        
-        //останавливаем игру
-        if (gameStarted) {
-            gameTimer->stop();
-            gameStarted = false;
-            gameTimeSeconds = 0;
-            collectedArtifacts = 0;
-            
-            timerLabel->setText("⏱️ Игра не начата");
-            timerLabel->setStyleSheet("color: gray; padding: 0 10px;");
-            artifactLabel->setText("⭐ Артефактов: 0 / 10");
-        }
+        graphView->stopAutoLayout();
+        game.reset();  //карта, торговец, черные дыры и игра
+        resetGameLabels();
         
         graphView->update();
         updateStatusBar();
@@ -504,34 +713,29 @@ void MainWindow::onLoadFromFile()
         
         if (reply != QMessageBox::Yes) return;
         
-        //явно очищаем граф и сбрасываем торговца
-        graph.Clear();
-        trader.reset();
+        //явно очищаем граф и начинаем игру заново
+        graphView->stopAutoLayout();
+        game.reset();
+        resetGameLabels();
     }
     
     try {
+        graphView->stopAutoLayout();
         graph.LoadFromFile(filename.toStdString());
         
         //размещаем торговца на первой планете
-        if (graph.GetVertexCount() > 0) {
-            DynamicArray<int> allVertices = graph.GetAllVertices();
-            if (allVertices.GetSize() > 0) {
-                int firstPlanetId = allVertices.Get(0);
-                trader.placeOnPlanet(firstPlanetId);
-                std::string planetName = graph.GetVertexName(firstPlanetId);
-                logMessage("🚀 Торговец \"" + QString::fromStdString(trader.getName()) + 
-                          "\" высадился на планете \"" + QString::fromStdString(planetName) + "\"");
-            }
-        }
+        game.placeTraderIfNeeded();
         
-        graphView->setTrader(&trader);
         graphView->update();
         updateStatusBar();
         
-        checkGameStart(); //проверяем запуск игры
+        game.checkGameStart(); //проверяем запуск игры
         
         logMessage("✓ Граф загружен из файла: " + QFileInfo(filename).fileName());
         logMessage(QString("  Содержит %1 планет").arg(graph.GetVertexCount()));
+        
+        //в файле нет координат - раскладываем карту заново
+        graphView->startAutoLayout(true);
     } catch (const std::exception& e) {
         QMessageBox::warning(this, "Ошибка",
             QString("Не удалось загрузить граф: %1").arg(e.what()));
@@ -568,6 +772,25 @@ void MainWindow::onSaveToFile()
     }
 }
 
+void MainWindow::onSavePerfStats()
+{
+    QString filename = QFileDialog::getSaveFileName(this,
+        "Сохранить статистику кадров",
+        "frame_stats.csv",
+        "CSV Files (*.csv);;All Files (*)");
+    
+    if (filename.isEmpty()) {
+        return;  //пользователь отменил выбор
+    }
+    
+    if (graphView->dumpPerfStats(filename)) {
+        logMessage("✓ Статистика кадров сохранена: " + QFileInfo(filename).fileName());
+    } else {
+        QMessageBox::warning(this, "Ошибка",
+            QString("Не удалось записать файл: %1").arg(filename));
+    }
+}
+
 void MainWindow::onAbout()
 {
     QMessageBox::about(this, "О программе",
@@ -593,9 +816,8 @@ void MainWindow::updateStatusBar()
     int vertices = graph.GetVertexCount();
     int edges = 0;
     
-    DynamicArray<int> allVertices = graph.GetAllVertices();
-    for (int i = 0; i < allVertices.GetSize(); i++) {
-        edges += graph.GetEdges(allVertices.Get(i)).GetSize();
+    for (int vertex : graph.Vertices()) {
+        edges += graph.GetEdges(vertex).GetSize();
     }
     
     QString status = QString("Планет: %1 | Переходов: %2").arg(vertices).arg(edges);
@@ -638,11 +860,13 @@ void MainWindow::showPathResult(const DijkstraResult& result,
             "От: %1\n"
             "До: %2\n"
             "Стоимость: %3 единиц\n"
-            "Время расчета: %4 мкс\n\n"
-            "Путь:\n%5")
+            "Шанс пройти без пиратов: %4%\n"
+            "Время расчета: %5 мкс\n\n"
+            "Путь:\n%6")
             .arg(from)
             .arg(to)
             .arg(result.totalCost, 0, 'f', 2)
+            .arg(result.survivalProbability * 100.0, 0, 'f', 1)
             .arg(timeMicrosec, 0, 'f', 2)
             .arg(pathStr);
         
@@ -699,171 +923,206 @@ void MainWindow::updateTraderDisplay()
     }
 }
 
-void MainWindow::startGame()
+GameSimulation::Settings MainWindow::gameSettings()
 {
-    if (gameStarted) {
-        return; //игра уже начата
-    }
-    
-    gameStarted = true;
-    gameTimeSeconds = 0;
-    collectedArtifacts = 0;
-    
-    //запускаем таймер игры
-    gameTimer->start(1000); //обновление каждую секунду
-    
-    //спавним первый артефакт
-    spawnArtifact();
+    GameSimulation::Settings settings;
+    settings.traderName = "Капитан Смит";
     
-    timerLabel->setStyleSheet("color: green; font-weight: bold; padding: 0 10px;");
-    timerLabel->setText("⏱️ 00:00");
-    
-    artifactLabel->setText(QString("⭐ Артефактов: %1 / %2")
-                          .arg(collectedArtifacts)
-                          .arg(REQUIRED_ARTIFACTS));
-    
-    logMessage("🎮 ИГРА НАЧАЛАСЬ! Соберите 10 артефактов!");
-    logMessage("⭐ На карте одновременно может быть только одна звезда");
-    logMessage("⭐ Новая звезда появится после сбора предыдущей");
+    //COSMIC_SEED повторяет прежний запуск бит в бит (seed пишется в журнал при старте)
+    const char* seed = std::getenv("COSMIC_SEED");
+    settings.seed = seed ? std::strtoull(seed, nullptr, 10) : static_cast<uint64_t>(std::time(nullptr));
+    return settings;
 }
 
-void MainWindow::checkGameStart()
+void MainWindow::resetGameLabels()
 {
-    if (!gameStarted && graph.GetVertexCount() >= MIN_PLANETS_TO_START) {
-        startGame();
-    }
+    graphView->simulationClock().setEnabled(gameSystem, false);
+    
+    timerLabel->setText("⏱️ Игра не начата");
+    timerLabel->setStyleSheet("color: gray; padding: 0 10px;");
+    artifactLabel->setText(QString("⭐ Артефактов: 0 / %1").arg(game.getSettings().requiredArtifacts));
 }
 
-void MainWindow::spawnArtifact()
+void MainWindow::onGameEvent(const GameEvent& event)
 {
-    if (!gameStarted) {
-        return;
-    }
-    
-    DynamicArray<int> allVertices = graph.GetAllVertices();
-    if (allVertices.GetSize() == 0) {
-        return;
-    }
-    
-    //проверяем, есть ли уже артефакт на карте
-    bool hasArtifactOnMap = false;
-    for (int i = 0; i < allVertices.GetSize(); i++) {
-        if (graph.HasArtifact(allVertices.Get(i))) {
-            hasArtifactOnMap = true;
+    QString planetName = QString::fromStdString(event.planetName);
+    QString otherName = QString::fromStdString(event.otherPlanetName);
+    int requiredArtifacts = game.getSettings().requiredArtifacts;
+    
+    switch (event.type) {
+        case GameEvent::TraderLanded:
+            logMessage("🚀 Торговец \"" + QString::fromStdString(trader.getName()) + 
+                      "\" высадился на планете \"" + planetName + "\"");
+            break;
+        
+        case GameEvent::GameStarted:
+            //запускаем таймер игры
+            graphView->simulationClock().restartSystem(gameSystem); //обновление каждую секунду
+            
+            timerLabel->setStyleSheet("color: green; font-weight: bold; padding: 0 10px;");
+            timerLabel->setText("⏱️ 00:00");
+            artifactLabel->setText(QString("⭐ Артефактов: 0 / %1").arg(requiredArtifacts));
+            
+            logMessage(QString("🎮 ИГРА НАЧАЛАСЬ! Соберите %1 артефактов!").arg(requiredArtifacts));
+            logMessage("⭐ На карте одновременно может быть только одна звезда");
+            logMessage("⭐ Новая звезда появится после сбора предыдущей");
+            break;
+        
+        case GameEvent::ArtifactSpawned:
+            logMessage("⭐ Новый артефакт появился на планете \"" + planetName + "\"!");
+            graphView->update();
+            break;
+        
+        case GameEvent::ArtifactCollected: {
+            int collected = static_cast<int>(event.value);
+            logMessage("✨ Артефакт собран на планете \"" + planetName + "\"! " +
+                      QString("(%1 / %2)").arg(collected).arg(requiredArtifacts));
+            artifactLabel->setText(QString("⭐ Артефактов: %1 / %2")
+                                  .arg(collected)
+                                  .arg(requiredArtifacts));
+            graphView->update();
             break;
         }
-    }
-    
-    //если на карте уже есть артефакт - не спавним новый
-    if (hasArtifactOnMap) {
-        return;
-    }
-    
-    //собираем планеты, на которых может появиться артефакт
-    //(исключаем планету с торговцем)
-    DynamicArray<int> availablePlanets;
-    for (int i = 0; i < allVertices.GetSize(); i++) {
-        int planetId = allVertices.Get(i);
-        //исключаем планету, на которой находится торговец
-        if (trader.getIsPlaced() && planetId == trader.getCurrentPlanetId()) {
-            continue;
+        
+        case GameEvent::Victory: {
+            //останавливаем таймер игры
+            graphView->simulationClock().setEnabled(gameSystem, false);
+            
+            //диалоги - после выхода из правил: новая игра очищает карту
+            int completedRoutes = event.completedRoutes;
+            int totalDistance = event.totalDistance;
+            double gameTime = event.gameTime;
+            QTimer::singleShot(0, this, [this, gameTime, completedRoutes, totalDistance]() {
+                showVictory(gameTime, completedRoutes, totalDistance);
+            });
+            break;
+        }
+        
+        case GameEvent::PirateAttack:
+            logMessage(QString("🏴‍☠️ ТРЕВОГА! Пираты атакуют на пути %1 → %2!")
+                      .arg(planetName).arg(otherName));
+            break;
+        
+        case GameEvent::PiratesRepelled:
+            logMessage(QString("⚔️ Пираты повержены! Путь %1 → %2 свободен!")
+                      .arg(planetName).arg(otherName));
+            break;
+        
+        case GameEvent::DestroyedByPirates: {
+            resetGameLabels();
+            logMessage("💀 GAME OVER - Корабль уничтожен пиратами!");
+            
+            //показываем сообщение ПОСЛЕ очистки карты
+            QString message = QString("💀 Пираты уничтожили ваш корабль!\n\n"
+                                      "🏴‍☠️ Место гибели: между %1 и %2\n"
+                                      "🚀 Статистика:\n"
+                                      "   • Завершено маршрутов: %3\n"
+                                      "   • Пройдено расстояние: %4\n\n"
+                                      "Игра окончена!")
+                .arg(planetName).arg(otherName)
+                .arg(event.completedRoutes)
+                .arg(event.totalDistance);
+            QTimer::singleShot(0, this, [this, message]() {
+                QMessageBox::critical(this, "💀 GAME OVER", message);
+            });
+            break;
+        }
+        
+        case GameEvent::Arrived:
+            logMessage(QString("✓ Торговец прибыл на планету: %1").arg(planetName));
+            logMessage(QString("📊 Всего маршрутов: %1 | Пройдено: %2")
+                      .arg(event.completedRoutes)
+                      .arg(event.totalDistance));
+            break;
+        
+        case GameEvent::RouteInterrupted:
+            logMessage(QString("⚠️ Маршрут прерван: путь дальше поглощён черной дырой, торговец остановился на планете: %1")
+                      .arg(planetName));
+            break;
+        
+        //═══ черные дыры (журнал карты) ═══
+        case GameEvent::BlackHoleSpawned:
+            graphView->addLogMessage("⚠️ ВНИМАНИЕ! Черная дыра появилась в секторе!");
+            break;
+        
+        case GameEvent::BlackHoleLeft:
+            graphView->addLogMessage("✓ Черная дыра покинула сектор");
+            break;
+        
+        case GameEvent::PlanetSwallowed:
+            graphView->addLogMessage(QString("💥 Черная дыра поглотила планету \"%1\"!").arg(planetName));
+            break;
+        
+        case GameEvent::LaneSwallowed:
+            graphView->addLogMessage(QString("💥 Черная дыра разорвала путь %1 → %2!")
+                                    .arg(planetName).arg(otherName));
+            break;
+        
+        case GameEvent::DestroyedByBlackHole: {
+            resetGameLabels();
+            graphView->addLogMessage("💀 GAME OVER - Торговец погиб!");
+            
+            QString message = QString("Черная дыра поглотила планету \"%1\" вместе с торговцем %2!\n\n"
+                                      "🚀 Финальная статистика:\n"
+                                      "   • Завершено маршрутов: %3\n"
+                                      "   • Пройдено расстояние: %4\n\n"
+                                      "Карта очищена. Начните новую игру!")
+                .arg(planetName)
+                .arg(QString::fromStdString(trader.getName()))
+                .arg(event.completedRoutes)
+                .arg(event.totalDistance);
+            QTimer::singleShot(0, this, [this, message]() {
+                updateTraderDisplay();
+                QMessageBox::information(this, "💀 GAME OVER", message);
+            });
+            break;
         }
-        availablePlanets.Append(planetId);
-    }
-    
-    //если нет доступных планет (торговец на единственной планете)
-    if (availablePlanets.GetSize() == 0) {
-        return;
     }
-    
-    //выбираем случайную планету из доступных
-    int randomIndex = rand() % availablePlanets.GetSize();
-    int planetId = availablePlanets.Get(randomIndex);
-    
-    //устанавливаем артефакт
-    graph.SetArtifact(planetId, true);
-    
-    QString planetName = QString::fromStdString(graph.GetVertexName(planetId));
-    logMessage("⭐ Новый артефакт появился на планете \"" + planetName + "\"!");
-    
-    //обновляем визуализацию
-    graphView->update();
 }
 
-void MainWindow::collectArtifact(int planetId)
+void MainWindow::showVictory(double gameTime, int completedRoutes, int totalDistance)
 {
-    if (!graph.HasArtifact(planetId)) {
-        return; //нет артефакта на этой планете
-    }
-    
-    //убираем артефакт
-    graph.SetArtifact(planetId, false);
-    collectedArtifacts++;
-    
-    QString planetName = QString::fromStdString(graph.GetVertexName(planetId));
-    logMessage("✨ Артефакт собран на планете \"" + planetName + "\"! " +
-              QString("(%1 / %2)").arg(collectedArtifacts).arg(REQUIRED_ARTIFACTS));
-    
-    //обновляем UI
-    artifactLabel->setText(QString("⭐ Артефактов: %1 / %2")
-                          .arg(collectedArtifacts)
-                          .arg(REQUIRED_ARTIFACTS));
-    
-    graphView->update();
+    //форматируем время
+    int totalSeconds = static_cast<int>(gameTime);
+    int minutes = totalSeconds / 60;
+    int seconds = totalSeconds % 60;
+    QString timeStr = QString("%1:%2")
+        .arg(minutes, 2, 10, QChar('0'))
+        .arg(seconds, 2, 10, QChar('0'));
+    
+    QString victoryMessage = QString(
+        "🎉 ПОБЕДА! 🎉\n\n"
+        "Вы собрали все %1 артефактов!\n\n"
+        "⏱️ Время: %2\n"
+        "🚀 Пройдено маршрутов: %3\n"
+        "📏 Общая дистанция: %4 св. лет\n\n"
+        "Поздравляем, Капитан!")
+        .arg(game.getSettings().requiredArtifacts)
+        .arg(timeStr)
+        .arg(completedRoutes)
+        .arg(totalDistance);
+    
+    QMessageBox::information(this, "🏆 ПОБЕДА!", victoryMessage);
+    
+    logMessage("🏆 ПОБЕДА! Игра завершена за " + timeStr);
+    
+    //можно предложить начать заново
+    int reply = QMessageBox::question(this, "Новая игра?",
+        "Хотите начать новую игру?",
+        QMessageBox::Yes | QMessageBox::No);
     
-    //проверяем победу и спавним следующий артефакт
-    if (collectedArtifacts >= REQUIRED_ARTIFACTS) {
-        checkVictory();
-    } else {
-        //спавним следующий артефакт сразу после сбора
-        spawnArtifact();
-    }
-}
-
-void MainWindow::checkVictory()
-{
-    if (collectedArtifacts >= REQUIRED_ARTIFACTS) {
-        //останавливаем таймер игры
-        gameTimer->stop();
-        
-        //форматируем время
-        int minutes = gameTimeSeconds / 60;
-        int seconds = gameTimeSeconds % 60;
-        QString timeStr = QString("%1:%2")
-            .arg(minutes, 2, 10, QChar('0'))
-            .arg(seconds, 2, 10, QChar('0'));
-        
-        QString victoryMessage = QString(
-            "🎉 ПОБЕДА! 🎉\n\n"
-            "Вы собрали все 10 артефактов!\n\n"
-            "⏱️ Время: %1\n"
-            "🚀 Пройдено маршрутов: %2\n"
-            "📏 Общая дистанция: %3 св. лет\n\n"
-            "Поздравляем, Капитан!")
-            .arg(timeStr)
-            .arg(trader.getCompletedRoutes())
-            .arg(trader.getTotalDistance());
-        
-        QMessageBox::information(this, "🏆 ПОБЕДА!", victoryMessage);
-        
-        logMessage("🏆 ПОБЕДА! Игра завершена за " + timeStr);
-        
-        //можно предложить начать заново
-        int reply = QMessageBox::question(this, "Новая игра?",
-            "Хотите начать новую игру?",
-            QMessageBox::Yes | QMessageBox::No);
-        
-        if (reply == QMessageBox::Yes) {
-            onClearGraph();
-        }
+    if (reply == QMessageBox::Yes) {
+        onClearGraph();
     }
 }
 
 void MainWindow::onGameTimerTick()
 {
-    gameTimeSeconds++;
+    graphView->reportTimerTick(PerfMonitor::TimerGame);
     
+    //часы игры продвигает GameSimulation::step (система "blackHole" виджета), здесь - только надпись
     //форматируем время
+    int gameTimeSeconds = static_cast<int>(game.getGameTime());
     int minutes = gameTimeSeconds / 60;
     int seconds = gameTimeSeconds % 60;
     
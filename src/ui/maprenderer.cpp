@@ -0,0 +1,518 @@
+#include "maprenderer.h"
+#include <QPainter>
+#include <QPainterPath>
+#include <QStaticText>
+#include <QTextOption>
+#include <QHash>
+#include <QMap>
+#include <QRunnable>
+#include <QMetaObject>
+#include <QtMath>
+#include <QThread>
+#include <cmath>
+#include <algorithm>
+
+//задание пула потоков: растеризация одного тайла
+class MapTileJob : public QRunnable
+{
+public:
+    MapTileJob(MapRenderer* r, std::shared_ptr<const MapSnapshot> s,
+               const QRect& rect, int tileIndex, unsigned long long tileGeneration)
+        : renderer(r), snapshot(std::move(s)), tileRect(rect),
+          index(tileIndex), generation(tileGeneration) {}
+    
+    void run() override
+    {
+        //камера уже сдвинулась - тайл никому не нужен
+        if (renderer->generation.load() != generation) {
+            return;
+        }
+        
+        MapRenderer::FrameStats stats;
+        QImage image = MapRenderer::renderTile(*snapshot, tileRect, stats);
+        
+        MapRenderer* target = renderer;
+        unsigned long long tileGeneration = generation;
+        int tileIndex = index;
+        QMetaObject::invokeMethod(renderer, [target, tileGeneration, tileIndex, image, stats]() {
+            target->onTileReady(tileGeneration, tileIndex, image, stats);
+        }, Qt::QueuedConnection);
+    }
+
+private:
+    MapRenderer* renderer;
+    std::shared_ptr<const MapSnapshot> snapshot;
+    QRect tileRect;
+    int index;
+    unsigned long long generation;
+};
+
+MapRenderer::MapRenderer(QObject *parent)
+    : QObject(parent), generation(0), frameCounter(0)
+{
+    //GUI-поток остаётся свободным: тайлы рисуют остальные ядра
+    pool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() - 1));
+    //потоки не завершаются по простою - вместе с ними жили бы и кэши подписей
+    pool.setExpiryTimeout(-1);
+}
+
+MapRenderer::~MapRenderer()
+{
+    //задания ссылаются на this - дожидаемся их до разрушения
+    generation++;
+    pool.clear();
+    pool.waitForDone();
+}
+
+void MapRenderer::render(std::shared_ptr<const MapSnapshot> snapshot)
+{
+    unsigned long long frameGeneration = ++generation;
+    
+    //ещё не начатые тайлы прошлого кадра не нужны
+    pool.clear();
+    
+    buildingFrame = Frame();
+    buildingFrame.transform = snapshot->transform;
+    buildingFrame.started.start();
+    
+    const QSize size = snapshot->viewportSize;
+    for (int y = 0; y < size.height(); y += TILE_SIZE) {
+        for (int x = 0; x < size.width(); x += TILE_SIZE) {
+            buildingFrame.tileRects.append(QRect(x, y,
+                std::min(TILE_SIZE, size.width() - x), std::min(TILE_SIZE, size.height() - y)));
+        }
+    }
+    buildingFrame.tiles.resize(buildingFrame.tileRects.size());
+    buildingFrame.pending = buildingFrame.tileRects.size();
+    
+    if (buildingFrame.pending == 0) {
+        shownFrame = buildingFrame;
+        shownStats = FrameStats();
+        frameCounter++;
+        emit frameReady();
+        return;
+    }
+    
+    for (int i = 0; i < buildingFrame.tileRects.size(); i++) {
+        pool.start(new MapTileJob(this, snapshot, buildingFrame.tileRects[i], i, frameGeneration));
+    }
+}
+
+void MapRenderer::clear()
+{
+    generation++;
+    pool.clear();
+    buildingFrame = Frame();
+    shownFrame = Frame();
+}
+
+void MapRenderer::onTileReady(unsigned long long tileGeneration, int index, const QImage& image,
+                              const FrameStats& tileStats)
+{
+    //результат устаревшего кадра
+    if (tileGeneration != generation.load()) {
+        return;
+    }
+    
+    buildingFrame.tiles[index] = image;
+    buildingFrame.stats.lanesNs += tileStats.lanesNs;
+    buildingFrame.stats.nodesNs += tileStats.nodesNs;
+    buildingFrame.stats.tiles++;
+    if (--buildingFrame.pending == 0) {
+        buildingFrame.stats.wallNs = buildingFrame.started.nsecsElapsed();
+        shownStats = buildingFrame.stats;
+        frameCounter++;
+        shownFrame = std::move(buildingFrame);
+        buildingFrame = Frame();
+        emit frameReady();
+    }
+}
+
+void MapRenderer::composite(QPainter& painter, const QTransform& currentTransform) const
+{
+    if (shownFrame.tiles.isEmpty()) {
+        return;
+    }
+    
+    painter.save();
+    
+    //экран кадра -> мир -> текущий экран
+    bool invertible = false;
+    QTransform frameToWorld = shownFrame.transform.inverted(&invertible);
+    if (invertible) {
+        painter.setTransform(frameToWorld * currentTransform, true);
+    }
+    if (!painter.transform().isIdentity()) {
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    }
+    
+    for (int i = 0; i < shownFrame.tiles.size(); i++) {
+        painter.drawImage(shownFrame.tileRects[i].topLeft(), shownFrame.tiles[i]);
+    }
+    
+    painter.restore();
+}
+
+QImage MapRenderer::renderTile(const MapSnapshot& snapshot, const QRect& tileRect, FrameStats& stats)
+{
+    qreal ratio = snapshot.devicePixelRatio;
+    QImage image(tileRect.size() * ratio, QImage::Format_ARGB32_Premultiplied);
+    image.setDevicePixelRatio(ratio);
+    image.fill(Qt::transparent);
+    
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setFont(snapshot.font);
+    painter.translate(-tileRect.topLeft());
+    painter.setTransform(snapshot.transform, true);
+    
+    QElapsedTimer timer;
+    timer.start();
+    
+    //скопления считаются слоем планет
+    if (snapshot.clustered) {
+        drawClusters(painter, snapshot);
+        stats.nodesNs = timer.nsecsElapsed();
+        return image;
+    }
+    
+    //область тайла в мире с запасом на свечение, подписи и звезду-артефакт
+    QRectF area = snapshot.transform.inverted().mapRect(QRectF(tileRect)).adjusted(-70, -70, 70, 70);
+    
+    QVector<const MapSnapshot::Lane*> lanes;
+    for (const MapSnapshot::Lane& lane : snapshot.lanes) {
+        QRectF bounds = QRectF(lane.from, lane.to).normalized();
+        if (bounds.right() >= area.left() && bounds.left() <= area.right() &&
+            bounds.bottom() >= area.top() && bounds.top() <= area.bottom()) {
+            lanes.append(&lane);
+        }
+    }
+    
+    QVector<const MapSnapshot::Node*> nodes;
+    for (const MapSnapshot::Node& node : snapshot.nodes) {
+        if (area.contains(node.position)) {
+            nodes.append(&node);
+        }
+    }
+    
+    timer.restart();
+    drawLanes(painter, lanes, snapshot.font, snapshot.detailed);
+    stats.lanesNs = timer.nsecsElapsed();
+    
+    timer.restart();
+    drawNodes(painter, nodes, snapshot.font, snapshot.detailed);
+    
+    //═══ рисуем артефакты (звезды) на планетах ═══
+    for (const MapSnapshot::Node* node : nodes) {
+        if (node->hasArtifact) {
+            drawArtifact(painter, node->position);
+        }
+    }
+    stats.nodesNs = timer.nsecsElapsed();
+    
+    return image;
+}
+
+//═══ кэш подписей ═══
+//разметка текста (QStaticText) строится один раз на строку, а не в каждом кадре;
+//QStaticText лениво перестраивается при рисовании, поэтому разделять его
+//между потоками нельзя - у каждого потока пула свой кэш
+struct LabelCache {
+    QFont font;                              //базовый шрифт снимка
+    QHash<QString, QStaticText> names[2];    //[обычная, подсвеченная] имя -> разметка
+    QHash<qint64, QStaticText> costs[2];     //стоимость * 10 -> разметка (подпись с одним знаком)
+};
+
+static const int NODE_RADIUS = 30;
+static const int LABEL_CACHE_LIMIT = 4096;   //больше строк - кэш сбрасывается
+
+static LabelCache& labelCache(const QFont& font)
+{
+    thread_local LabelCache cache;
+    if (cache.font != font) {
+        cache = LabelCache();
+        cache.font = font;
+    }
+    return cache;
+}
+
+static QFont labelFont(const QFont& base, int pointSize, bool bold)
+{
+    QFont font = base;
+    font.setPointSize(pointSize);
+    font.setBold(bold);
+    return font;
+}
+
+//имя планеты с переносом по словам в ширину планеты
+//переименование меняет строку, а значит и ключ - старая разметка просто не используется
+static QStaticText nameLabel(const QString& name, const QFont& base, bool highlighted)
+{
+    QHash<QString, QStaticText>& names = labelCache(base).names[highlighted ? 1 : 0];
+    auto it = names.constFind(name);
+    if (it != names.constEnd()) {
+        return it.value();
+    }
+    if (names.size() >= LABEL_CACHE_LIMIT) {
+        names.clear();
+    }
+    
+    QStaticText text(name);
+    text.setTextFormat(Qt::PlainText);
+    text.setTextWidth(NODE_RADIUS * 2);
+    QTextOption option(Qt::AlignHCenter);
+    option.setWrapMode(QTextOption::WordWrap);
+    text.setTextOption(option);
+    text.prepare(QTransform(), labelFont(base, 9, highlighted));
+    names.insert(name, text);
+    return text;
+}
+
+//стоимость ребра; ключ - округлённая стоимость, поэтому новая стоимость даёт новую подпись
+static QStaticText costLabel(double cost, const QFont& base, bool highlighted)
+{
+    QHash<qint64, QStaticText>& costs = labelCache(base).costs[highlighted ? 1 : 0];
+    qint64 key = qRound64(cost * 10);
+    auto it = costs.constFind(key);
+    if (it != costs.constEnd()) {
+        return it.value();
+    }
+    if (costs.size() >= LABEL_CACHE_LIMIT) {
+        costs.clear();
+    }
+    
+    QStaticText text(QString::number(cost, 'f', 1));
+    text.setTextFormat(Qt::PlainText);
+    text.prepare(QTransform(), labelFont(base, 8, highlighted));
+    costs.insert(key, text);
+    return text;
+}
+
+void MapRenderer::drawLanes(QPainter& painter, const QVector<const MapSnapshot::Lane*>& lanes,
+                            const QFont& font, bool detailed)
+{
+    //рёбра одного стиля рисуются одним drawLines, их стрелки - одним drawPath
+    struct Batch {
+        QVector<QLineF> lines;
+        QPainterPath arrows;
+        
+        Batch() { arrows.setFillRule(Qt::WindingFill); }
+    };
+    //стрелки одинаково ориентированы - при WindingFill наложения не «выгрызают» друг друга
+    QMap<int, Batch> riskBatches;            //обычные рёбра по цвету (зелёная компонента)
+    Batch highlightedBatch;
+    
+    struct Label {
+        QPointF center;
+        QStaticText text;
+        bool highlighted;
+    };
+    QVector<Label> labels;
+    
+    for (const MapSnapshot::Lane* lane : lanes) {
+        //вычисляем направление
+        QLineF line(lane->from, lane->to);
+        double angle = line.angle() * M_PI / 180.0;
+        
+        //укорачиваем линию, чтобы не заходила на узлы
+        QPointF start = lane->from + QPointF(qCos(angle) * NODE_RADIUS, -qSin(angle) * NODE_RADIUS);
+        QPointF end = lane->to - QPointF(qCos(angle) * NODE_RADIUS, -qSin(angle) * NODE_RADIUS);
+        
+        //цвет в зависимости от риска
+        Batch& batch = lane->highlighted
+            ? highlightedBatch
+            : riskBatches[255 - static_cast<int>(lane->data.riskFactor * 255)];
+        batch.lines.append(QLineF(start, end));
+        
+        //стрелка
+        QPointF arrowP1 = end - QPointF(qCos(angle + M_PI / 6) * 12,
+                                        -qSin(angle + M_PI / 6) * 12);
+        QPointF arrowP2 = end - QPointF(qCos(angle - M_PI / 6) * 12,
+                                        -qSin(angle - M_PI / 6) * 12);
+        QPolygonF arrowHead;
+        arrowHead << end << arrowP1 << arrowP2 << end;
+        batch.arrows.addPolygon(arrowHead);
+        
+        if (detailed) {
+            labels.append({(start + end) / 2, costLabel(lane->data.getTotalCost(), font, lane->highlighted),
+                           lane->highlighted});
+        }
+    }
+    
+    auto drawBatch = [&painter](const Batch& batch, const QPen& pen) {
+        if (batch.lines.isEmpty()) {
+            return;
+        }
+        painter.setPen(pen);
+        painter.setBrush(pen.color());
+        painter.drawLines(batch.lines);
+        painter.drawPath(batch.arrows);
+    };
+    
+    for (auto it = riskBatches.constBegin(); it != riskBatches.constEnd(); ++it) {
+        drawBatch(it.value(), QPen(QColor(255, it.key(), 50, 180), 2, Qt::DashLine));
+    }
+    //подсвеченный путь поверх остальных рёбер
+    drawBatch(highlightedBatch, QPen(QColor(255, 215, 0), 4, Qt::SolidLine));
+    
+    if (labels.isEmpty()) {
+        return;
+    }
+    
+    //вес ребра (посередине): фоны всех подписей - одной заливкой
+    QPainterPath backgrounds;
+    backgrounds.setFillRule(Qt::WindingFill);
+    for (Label& label : labels) {
+        QSizeF size = label.text.size();
+        QRectF textRect(label.center - QPointF(size.width() / 2, size.height() / 2), size);
+        backgrounds.addRoundedRect(textRect.adjusted(-3, -2, 3, 2), 3, 3);
+        label.center = textRect.topLeft();
+    }
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(20, 20, 50, 200));
+    painter.drawPath(backgrounds);
+    
+    //текст: сначала обычные подписи, затем подсвеченные - шрифт и перо меняются дважды
+    for (int pass = 0; pass < 2; pass++) {
+        bool highlighted = pass == 1;
+        painter.setPen(highlighted ? Qt::yellow : Qt::white);
+        painter.setFont(labelFont(font, 8, highlighted));
+        for (const Label& label : labels) {
+            if (label.highlighted == highlighted) {
+                painter.drawStaticText(label.center, label.text);
+            }
+        }
+    }
+}
+
+void MapRenderer::drawNodes(QPainter& painter, const QVector<const MapSnapshot::Node*>& nodes,
+                            const QFont& font, bool detailed)
+{
+    const int radius = NODE_RADIUS;
+    
+    //тени всех планет - одной заливкой
+    QPainterPath shadows;
+    shadows.setFillRule(Qt::WindingFill);
+    for (const MapSnapshot::Node* node : nodes) {
+        shadows.addEllipse(node->position + QPointF(3, 3), radius + 2, radius + 2);
+    }
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(0, 0, 0, 80));
+    painter.drawPath(shadows);
+    
+    for (const MapSnapshot::Node* node : nodes) {
+        const bool isHighlighted = node->highlighted;
+        QPointF center = node->position;
+        
+        //свечение для подсвеченных узлов
+        if (isHighlighted) {
+            QRadialGradient glowGradient(center, radius + 15);
+            glowGradient.setColorAt(0, QColor(255, 215, 0, 150));
+            glowGradient.setColorAt(0.5, QColor(255, 140, 0, 80));
+            glowGradient.setColorAt(1, QColor(255, 69, 0, 0));
+            painter.setPen(Qt::NoPen);
+            painter.setBrush(glowGradient);
+            painter.drawEllipse(center, radius + 15, radius + 15);
+        }
+        
+        //градиент планеты
+        QRadialGradient gradient(center - QPointF(10, 10), radius * 1.5);
+        if (isHighlighted) {
+            gradient.setColorAt(0, QColor(255, 215, 0));
+            gradient.setColorAt(0.6, QColor(255, 140, 0));
+            gradient.setColorAt(1, QColor(200, 100, 0));
+        } else {
+            //═══ цвет зависит от количества связей (если включена градация) ═══
+            QColor baseColor = node->color;
+            QColor darkColor = baseColor.darker(150);
+            QColor darkerColor = baseColor.darker(200);
+            
+            gradient.setColorAt(0, baseColor);
+            gradient.setColorAt(0.6, darkColor);
+            gradient.setColorAt(1, darkerColor);
+        }
+        
+        painter.setBrush(gradient);
+        painter.setPen(QPen(isHighlighted ? QColor(255, 215, 0) : QColor(200, 220, 255), 2));
+        painter.drawEllipse(center, radius, radius);
+    }
+    
+    //на мелком масштабе имя всё равно не прочитать
+    if (!detailed) {
+        return;
+    }
+    
+    //текст: готовая разметка из кэша, по вертикали - по центру планеты
+    painter.setPen(Qt::white);
+    for (int pass = 0; pass < 2; pass++) {
+        bool highlighted = pass == 1;
+        painter.setFont(labelFont(font, 9, highlighted));
+        for (const MapSnapshot::Node* node : nodes) {
+            if (node->highlighted == highlighted) {
+                QStaticText text = nameLabel(node->name, font, highlighted);
+                painter.drawStaticText(QPointF(node->position.x() - radius,
+                                               node->position.y() - text.size().height() / 2), text);
+            }
+        }
+    }
+}
+
+void MapRenderer::drawArtifact(QPainter& painter, const QPointF& planetCenter)
+{
+    //рисуем блестящую звезду ⭐
+    painter.save();
+    painter.translate(planetCenter.x(), planetCenter.y() - 45); //над планетой
+    
+    //свечение вокруг звезды
+    QRadialGradient glow(0, 0, 20);
+    glow.setColorAt(0, QColor(255, 215, 0, 200));
+    glow.setColorAt(0.5, QColor(255, 140, 0, 100));
+    glow.setColorAt(1, QColor(255, 69, 0, 0));
+    painter.setBrush(glow);
+    painter.setPen(Qt::NoPen);
+    painter.drawEllipse(QPointF(0, 0), 20, 20);
+    
+    //рисуем 5-конечную звезду
+    QPolygonF star;
+    for (int i = 0; i < 5; i++) {
+        double angle1 = i * 2 * M_PI / 5 - M_PI / 2;
+        double angle2 = (i + 0.5) * 2 * M_PI / 5 - M_PI / 2;
+        star << QPointF(12 * cos(angle1), 12 * sin(angle1));
+        star << QPointF(5 * cos(angle2), 5 * sin(angle2));
+    }
+    
+    //желтая звезда с обводкой
+    painter.setBrush(QColor(255, 215, 0));
+    painter.setPen(QPen(QColor(255, 140, 0), 2));
+    painter.drawPolygon(star);
+    
+    painter.restore();
+}
+
+void MapRenderer::drawClusters(QPainter& painter, const MapSnapshot& snapshot)
+{
+    double zoom = snapshot.transform.m11();
+    
+    //связи между скоплениями - одна линия на пару ячеек
+    painter.setPen(QPen(QColor(255, 200, 50, 90), 1.5 / zoom));
+    painter.drawLines(snapshot.clusterLinks);
+    
+    //скопления: размер растёт с числом планет, подпись - их количество
+    QFont font = painter.font();
+    font.setPointSizeF(8 / zoom);
+    font.setBold(true);
+    painter.setFont(font);
+    
+    for (const MapSnapshot::Cluster& cluster : snapshot.clusters) {
+        painter.setPen(QPen(QColor(200, 220, 255), 1.5 / zoom));
+        painter.setBrush(cluster.highlighted ? QColor(255, 170, 0) : QColor(100, 150, 255, 200));
+        painter.drawEllipse(cluster.center, cluster.radius, cluster.radius);
+        
+        if (cluster.count > 1) {
+            painter.setPen(Qt::white);
+            painter.drawText(QRectF(cluster.center.x() - cluster.radius, cluster.center.y() - cluster.radius,
+                                    cluster.radius * 2, cluster.radius * 2),
+                             Qt::AlignCenter, QString::number(cluster.count));
+        }
+    }
+}
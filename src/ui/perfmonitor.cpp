@@ -0,0 +1,192 @@
+#include "perfmonitor.h"
+#include <QFile>
+#include <QTextStream>
+#include <algorithm>
+#include <cmath>
+
+static const qint64 RATE_WINDOW_MS = 1000;   //окно подсчёта частоты таймеров
+static const qint64 RATE_STALE_MS = 2000;    //таймер молчит дольше - частота 0
+
+PerfMonitor::PerfMonitor()
+    : nextFrame(0), frameCount(0)
+{
+    frames.resize(FRAME_HISTORY);
+}
+
+void PerfMonitor::beginFrame()
+{
+    current = FrameSample();
+    frameTimer.start();
+    tick(TimerPaint);
+}
+
+void PerfMonitor::addLayerTime(Layer layer, qint64 nsecs)
+{
+    current.layerNs[layer] += nsecs;
+}
+
+void PerfMonitor::endFrame()
+{
+    if (!frameTimer.isValid()) {
+        return;
+    }
+    
+    current.totalNs = frameTimer.nsecsElapsed();
+    for (int t = 0; t < TimerCount; t++) {
+        current.rates[t] = static_cast<float>(tickRate(static_cast<Timer>(t)));
+    }
+    
+    frames[nextFrame] = current;
+    nextFrame = (nextFrame + 1) % FRAME_HISTORY;
+    frameCount = std::min(frameCount + 1, FRAME_HISTORY);
+    frameTimer.invalidate();
+}
+
+void PerfMonitor::tick(Timer timer)
+{
+    TickCounter& counter = ticks[timer];
+    if (!counter.window.isValid()) {
+        counter.window.start();
+    }
+    counter.count++;
+    
+    //окно закончилось - фиксируем частоту и начинаем новое
+    qint64 elapsed = counter.window.elapsed();
+    if (elapsed >= RATE_WINDOW_MS) {
+        counter.rate = counter.count * 1000.0 / elapsed;
+        counter.count = 0;
+        counter.window.restart();
+    }
+}
+
+void PerfMonitor::clear()
+{
+    nextFrame = 0;
+    frameCount = 0;
+    current = FrameSample();
+    frameTimer.invalidate();
+    ticks = std::array<TickCounter, TimerCount>();
+}
+
+double PerfMonitor::tickRate(Timer timer) const
+{
+    const TickCounter& counter = ticks[timer];
+    if (!counter.window.isValid() || counter.window.elapsed() >= RATE_STALE_MS) {
+        return 0.0;
+    }
+    return counter.rate;
+}
+
+const PerfMonitor::FrameSample& PerfMonitor::frameAt(int age) const
+{
+    return frames[(nextFrame - 1 - age + FRAME_HISTORY) % FRAME_HISTORY];
+}
+
+double PerfMonitor::framePercentile(double percent) const
+{
+    if (frameCount == 0) {
+        return 0.0;
+    }
+    
+    QVector<qint64> totals;
+    totals.reserve(frameCount);
+    for (int i = 0; i < frameCount; i++) {
+        totals.append(frameAt(i).totalNs);
+    }
+    
+    //ближайший ранг: nth_element вместо полной сортировки
+    percent = std::max(0.0, std::min(100.0, percent));
+    int rank = static_cast<int>(std::ceil(percent / 100.0 * frameCount)) - 1;
+    rank = std::max(0, std::min(frameCount - 1, rank));
+    std::nth_element(totals.begin(), totals.begin() + rank, totals.end());
+    return totals[rank] / 1e6;
+}
+
+QString PerfMonitor::layerName(Layer layer)
+{
+    switch (layer) {
+        case LayerStars:     return "stars";
+        case LayerMeteors:   return "meteors";
+        case LayerSnapshot:  return "snapshot";
+        case LayerMap:       return "map";
+        case LayerEdges:     return "edges";
+        case LayerNodes:     return "nodes";
+        case LayerTrader:    return "trader";
+        case LayerBlackHole: return "black_hole";
+        case LayerOverlay:   return "overlay";
+        default:             return "unknown";
+    }
+}
+
+QString PerfMonitor::timerName(Timer timer)
+{
+    switch (timer) {
+        case TimerPaint:     return "paint";
+        case TimerFrame:     return "frame";
+        case TimerAnimation: return "animation";
+        case TimerMeteor:    return "meteors";
+        case TimerBlackHole: return "blackHole";
+        case TimerGame:      return "game";
+        default:             return "unknown";
+    }
+}
+
+QStringList PerfMonitor::report() const
+{
+    QStringList lines;
+    lines << QString("кадр: p50 %1 мс  p95 %2 мс  p99 %3 мс  (%4 кадров)")
+                 .arg(framePercentile(50), 0, 'f', 2)
+                 .arg(framePercentile(95), 0, 'f', 2)
+                 .arg(framePercentile(99), 0, 'f', 2)
+                 .arg(frameCount);
+    
+    //среднее по слоям за последние кадры (рёбра и планеты - время потоков пула)
+    const int window = std::min(frameCount, 60);
+    for (int layer = 0; layer < LayerCount; layer++) {
+        qint64 sum = 0;
+        for (int i = 0; i < window; i++) {
+            sum += frameAt(i).layerNs[layer];
+        }
+        double average = window > 0 ? sum / 1e6 / window : 0.0;
+        lines << QString("  %1: %2 мс").arg(layerName(static_cast<Layer>(layer)), -11)
+                                       .arg(average, 0, 'f', 3);
+    }
+    
+    for (int timer = 0; timer < TimerCount; timer++) {
+        lines << QString("  %1: %2 /с").arg(timerName(static_cast<Timer>(timer)), -11)
+                                       .arg(tickRate(static_cast<Timer>(timer)), 0, 'f', 1);
+    }
+    return lines;
+}
+
+bool PerfMonitor::writeCsv(const QString& path) const
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+        return false;
+    }
+    
+    QTextStream out(&file);
+    out << "frame,total_ms";
+    for (int layer = 0; layer < LayerCount; layer++) {
+        out << ',' << layerName(static_cast<Layer>(layer)) << "_ms";
+    }
+    for (int timer = 0; timer < TimerCount; timer++) {
+        out << ',' << timerName(static_cast<Timer>(timer)) << "_hz";
+    }
+    out << '\n';
+    
+    //от старых кадров к новым
+    for (int i = frameCount - 1, index = 0; i >= 0; i--, index++) {
+        const FrameSample& frame = frameAt(i);
+        out << index << ',' << QString::number(frame.totalNs / 1e6, 'f', 4);
+        for (int layer = 0; layer < LayerCount; layer++) {
+            out << ',' << QString::number(frame.layerNs[layer] / 1e6, 'f', 4);
+        }
+        for (int timer = 0; timer < TimerCount; timer++) {
+            out << ',' << QString::number(frame.rates[timer], 'f', 1);
+        }
+        out << '\n';
+    }
+    return out.status() == QTextStream::Ok;
+}
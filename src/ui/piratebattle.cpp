@@ -7,23 +7,11 @@
 PirateBattle::PirateBattle(double risk, QWidget *parent)
     : QDialog(parent), clicksCount(0), riskFactor(risk), victory(false)
 {
-    //определяем тип пирата и устанавливаем параметры
-    pirateType = determinePirateType(risk);
-    
-    switch (pirateType) {
-        case PirateType::ROOKIE:
-            requiredClicks = 5;
-            battleTime = 50;  //5 секунд
-            break;
-        case PirateType::VETERAN:
-            requiredClicks = 10;
-            battleTime = 50;  //5 секунд
-            break;
-        case PirateType::BOSS:
-            requiredClicks = 15;
-            battleTime = 40;  //4 секунды
-            break;
-    }
+    //определяем тип пирата и устанавливаем параметры (общие правила с безоконной симуляцией)
+    pirateType = PirateModel::determinePirateType(risk);
+    PirateModel::Profile battle = PirateModel::profile(pirateType);
+    requiredClicks = battle.requiredClicks;
+    battleTime = battle.battleTime;
     
     timeLeft = battleTime;
     
@@ -217,14 +205,3 @@ void PirateBattle::updateDisplay()
                         .arg(clicksCount)
                         .arg(requiredClicks));
 }
-
-PirateType PirateBattle::determinePirateType(double risk)
-{
-    if (risk < 0.25) {
-        return PirateType::ROOKIE;
-    } else if (risk <= 0.4) {
-        return PirateType::VETERAN;
-    } else {
-        return PirateType::BOSS;
-    }
-}
@@ -0,0 +1,88 @@
+#include "planetpickerdialog.h"
+#include <QVBoxLayout>
+#include <QLabel>
+#include <QDialogButtonBox>
+#include <QMessageBox>
+
+PlanetPickerDialog::PlanetPickerDialog(const StarGraph* g, const QString& title,
+                                       const QString& label, QWidget *parent)
+    : QDialog(parent), graph(g)
+{
+    setWindowTitle(title);
+    setMinimumSize(350, 400);
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->addWidget(new QLabel(label, this));
+
+    //строка поиска
+    searchEdit = new QLineEdit(this);
+    searchEdit->setPlaceholderText("Начните вводить название планеты...");
+    searchEdit->setClearButtonEnabled(true);
+    layout->addWidget(searchEdit);
+
+    //список найденных планет (подгружается постранично)
+    model = new PlanetSearchModel(graph, this);
+    listView = new QListView(this);
+    listView->setModel(model);
+    listView->setUniformItemSizes(true);
+    listView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    layout->addWidget(listView);
+
+    QDialogButtonBox* buttons = new QDialogButtonBox(
+        QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+    layout->addWidget(buttons);
+
+    connect(searchEdit, &QLineEdit::textChanged, model, &PlanetSearchModel::setQuery);
+    connect(searchEdit, &QLineEdit::returnPressed, this, &PlanetPickerDialog::onAccept);
+    connect(listView, &QListView::doubleClicked, this, &PlanetPickerDialog::onAccept);
+    connect(buttons, &QDialogButtonBox::accepted, this, &PlanetPickerDialog::onAccept);
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+
+    //после каждого запроса выделяем лучшее совпадение
+    connect(model, &QAbstractItemModel::modelReset, this, [this]() {
+        if (model->rowCount() > 0) {
+            listView->setCurrentIndex(model->index(0));
+        }
+    });
+    if (model->rowCount() > 0) {
+        listView->setCurrentIndex(model->index(0));
+    }
+
+    searchEdit->setFocus();
+}
+
+QString PlanetPickerDialog::getPlanetName() const
+{
+    return selectedName;
+}
+
+void PlanetPickerDialog::onAccept()
+{
+    //точное совпадение введенного имени имеет приоритет
+    QString typed = searchEdit->text().trimmed();
+    if (!typed.isEmpty() && graph->HasVertex(typed.toStdString())) {
+        selectedName = typed;
+        accept();
+        return;
+    }
+
+    QModelIndex current = listView->currentIndex();
+    if (!current.isValid()) {
+        QMessageBox::warning(this, "Ошибка", "Планета не найдена!");
+        return;
+    }
+
+    selectedName = model->data(current).toString();
+    accept();
+}
+
+QString PlanetPickerDialog::getPlanet(QWidget *parent, const StarGraph* graph,
+                                      const QString& title, const QString& label, bool* ok)
+{
+    PlanetPickerDialog dialog(graph, title, label, parent);
+    bool accepted = (dialog.exec() == QDialog::Accepted);
+    if (ok) {
+        *ok = accepted;
+    }
+    return accepted ? dialog.getPlanetName() : QString();
+}
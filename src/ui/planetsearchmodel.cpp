@@ -0,0 +1,103 @@
+#include "planetsearchmodel.h"
+
+PlanetSearchModel::PlanetSearchModel(const StarGraph* g, QObject *parent)
+    : QAbstractListModel(parent), graph(g), limit(PAGE_SIZE)
+{
+    runQuery(planetIds, names);
+}
+
+int PlanetSearchModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+    return planetIds.size();
+}
+
+QVariant PlanetSearchModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= planetIds.size()) {
+        return QVariant();
+    }
+
+    if (role == Qt::DisplayRole || role == Qt::EditRole) {
+        return names[index.row()];
+    }
+    if (role == Qt::UserRole) {
+        return planetIds[index.row()];
+    }
+    return QVariant();
+}
+
+bool PlanetSearchModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return false;
+    }
+    //индекс вернул полную страницу - возможно, есть ещё
+    return planetIds.size() >= limit;
+}
+
+void PlanetSearchModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid()) {
+        return;
+    }
+
+    limit += PAGE_SIZE;
+
+    QVector<int> newIds;
+    QVector<QString> newNames;
+    runQuery(newIds, newNames);
+
+    //если старые строки остались на месте - просто дописываем хвост
+    bool keepsPrefix = newIds.size() >= planetIds.size();
+    for (int i = 0; keepsPrefix && i < planetIds.size(); i++) {
+        keepsPrefix = (newIds[i] == planetIds[i]);
+    }
+
+    if (keepsPrefix) {
+        if (newIds.size() > planetIds.size()) {
+            beginInsertRows(QModelIndex(), planetIds.size(), newIds.size() - 1);
+            planetIds = newIds;
+            names = newNames;
+            endInsertRows();
+        }
+    } else {
+        beginResetModel();
+        planetIds = newIds;
+        names = newNames;
+        endResetModel();
+    }
+}
+
+int PlanetSearchModel::getPlanetId(int row) const
+{
+    if (row < 0 || row >= planetIds.size()) {
+        return -1;
+    }
+    return planetIds[row];
+}
+
+void PlanetSearchModel::setQuery(const QString& text)
+{
+    beginResetModel();
+    query = text;
+    limit = PAGE_SIZE;
+    runQuery(planetIds, names);
+    endResetModel();
+}
+
+void PlanetSearchModel::runQuery(QVector<int>& ids, QVector<QString>& planetNames) const
+{
+    ids.clear();
+    planetNames.clear();
+
+    DynamicArray<int> found = graph->SearchVertices(query.trimmed().toStdString(), limit);
+    ids.reserve(found.GetSize());
+    planetNames.reserve(found.GetSize());
+    for (int i = 0; i < found.GetSize(); i++) {
+        ids.append(found.Get(i));
+        planetNames.append(QString::fromStdString(graph->GetVertexName(found.Get(i))));
+    }
+}
@@ -0,0 +1,192 @@
+//микробенчмарки базовых структур: DynamicArray, PriorityQueue, StarGraph, Dijkstra
+//запуск: ./bench_core [--filter Dijkstra] [--json bench_core.json] [--baseline old.json --threshold 10]
+
+#define TEST_FRAMEWORK_COUNT_ALLOCATIONS
+#include "test_framework.h"
+#include "../include/core/DynamicArray.h"
+#include "../include/core/PriorityQueue.h"
+#include "../include/core/Xoshiro256.h"
+#include "../include/graph/StarGraph.h"
+#include "../include/graph/Dijkstra.h"
+#include <cstdio>
+
+//решётка side x side с переходами в обе стороны
+static StarGraph makeGrid(int side, std::vector<int>& ids) {
+    StarGraph graph;
+    Xoshiro256 random(42);
+    ids.resize(side * side);
+    for (int i = 0; i < side * side; i++) {
+        ids[i] = graph.AddVertex("P" + std::to_string(i));
+    }
+    for (int row = 0; row < side; row++) {
+        for (int column = 0; column < side; column++) {
+            int v = row * side + column;
+            if (column + 1 < side) {
+                double distance = random.NextRange(50.0, 150.0);
+                graph.AddEdge(ids[v], ids[v + 1], EdgeData(distance, random.NextRange(0.0, 0.5)));
+                graph.AddEdge(ids[v + 1], ids[v], EdgeData(distance, random.NextRange(0.0, 0.5)));
+            }
+            if (row + 1 < side) {
+                double distance = random.NextRange(50.0, 150.0);
+                graph.AddEdge(ids[v], ids[v + side], EdgeData(distance, random.NextRange(0.0, 0.5)));
+                graph.AddEdge(ids[v + side], ids[v], EdgeData(distance, random.NextRange(0.0, 0.5)));
+            }
+        }
+    }
+    return graph;
+}
+
+//===========================================
+// DynamicArray
+//===========================================
+
+BENCH(DynamicArray_Append1000) {
+    while (state.keepRunning()) {
+        DynamicArray<int> array;
+        for (int i = 0; i < 1000; i++) {
+            array.Append(i);
+        }
+        doNotOptimize(array.GetSize());
+    }
+}
+
+BENCH(DynamicArray_IndexedSum1000) {
+    DynamicArray<int> array;
+    for (int i = 0; i < 1000; i++) {
+        array.Append(i);
+    }
+    const DynamicArray<int>& view = array;
+    while (state.keepRunning()) {
+        long long sum = 0;
+        for (int i = 0; i < view.GetSize(); i++) {
+            sum += view[i];
+        }
+        doNotOptimize(sum);
+    }
+}
+
+BENCH(DynamicArray_Copy1000) {
+    DynamicArray<int> array;
+    for (int i = 0; i < 1000; i++) {
+        array.Append(i);
+    }
+    while (state.keepRunning()) {
+        DynamicArray<int> copy(array);
+        doNotOptimize(copy.GetSize());
+    }
+}
+
+//===========================================
+// PriorityQueue
+//===========================================
+
+BENCH(PriorityQueue_EnqueueDequeue1000) {
+    Xoshiro256 random(7);
+    std::vector<double> priorities(1000);
+    for (double& priority : priorities) {
+        priority = random.NextDouble();
+    }
+    while (state.keepRunning()) {
+        PriorityQueue<int, double> queue;
+        for (int i = 0; i < 1000; i++) {
+            queue.Enqueue(i, priorities[i]);
+        }
+        long long sum = 0;
+        while (!queue.IsEmpty()) {
+            sum += queue.Dequeue();
+        }
+        doNotOptimize(sum);
+    }
+}
+
+//===========================================
+// StarGraph
+//===========================================
+
+BENCH(StarGraph_BuildGrid32) {
+    std::vector<int> ids;
+    while (state.keepRunning()) {
+        StarGraph graph = makeGrid(32, ids);
+        doNotOptimize(graph.GetEdgeCount());
+    }
+}
+
+BENCH(StarGraph_GetVertexIndex) {
+    std::vector<int> ids;
+    StarGraph graph = makeGrid(32, ids);
+    std::vector<std::string> names;
+    for (int i = 0; i < 1024; i += 7) {
+        names.push_back("P" + std::to_string(i));
+    }
+    while (state.keepRunning()) {
+        int sum = 0;
+        for (const std::string& name : names) {
+            sum += graph.GetVertexIndex(name);
+        }
+        doNotOptimize(sum);
+    }
+}
+
+BENCH(StarGraph_RemoveVertexGrid32) {
+    std::vector<int> ids;
+    StarGraph source = makeGrid(32, ids);
+    Xoshiro256 random(3);
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        StarGraph graph = source;
+        int vertex = ids[random.NextBelow(ids.size())];
+        state.resumeTiming();
+        
+        graph.RemoveVertex(vertex);
+        doNotOptimize(graph.GetVertexCount());
+        
+        state.pauseTiming();
+        graph = StarGraph();   //разрушение копии вне замера
+        state.resumeTiming();
+    }
+}
+
+BENCH(StarGraph_SaveLoadGrid32) {
+    std::vector<int> ids;
+    StarGraph graph = makeGrid(32, ids);
+    const std::string path = "bench_core_tmp.txt";
+    while (state.keepRunning()) {
+        graph.SaveToFile(path);
+        StarGraph loaded;
+        loaded.LoadFromFile(path);
+        doNotOptimize(loaded.GetEdgeCount());
+    }
+    std::remove(path.c_str());
+}
+
+//===========================================
+// Dijkstra
+//===========================================
+
+BENCH(Dijkstra_ShortestPathGrid64) {
+    std::vector<int> ids;
+    StarGraph graph = makeGrid(64, ids);
+    Dijkstra dijkstra(graph);
+    Xoshiro256 random(11);
+    while (state.keepRunning()) {
+        int start = ids[random.NextBelow(ids.size())];
+        int end = ids[random.NextBelow(ids.size())];
+        DijkstraResult result = dijkstra.FindShortestPath(start, end);
+        doNotOptimize(result.totalCost);
+    }
+}
+
+BENCH(Dijkstra_AllShortestPathsGrid64) {
+    std::vector<int> ids;
+    StarGraph graph = makeGrid(64, ids);
+    Dijkstra dijkstra(graph);
+    Xoshiro256 random(13);
+    while (state.keepRunning()) {
+        std::unordered_map<int, double> distances = dijkstra.FindAllShortestPaths(ids[random.NextBelow(ids.size())]);
+        doNotOptimize(distances.size());
+    }
+}
+
+int main(int argc, char* argv[]) {
+    RUN_ALL_BENCHMARKS(argc, argv);
+}
@@ -0,0 +1,467 @@
+//бенчмарк операций графа и маршрутизации на синтетических картах (без Qt)
+//
+//генераторы карт:
+//  geometric - случайный геометрический граф (планеты в квадрате, переходы между близкими, степень ~6)
+//  grid      - решётка со связями к 4 соседям
+//  scalefree - безмасштабный граф Барабаши - Альберт (новая планета связывается с 3 популярными)
+//  demo      - топология demo_graph.txt, размноженная копиями, соединёнными в кольцо
+//
+//операции: AddVertex, AddEdge, FindShortestPath, FindAllShortestPaths, SaveToFile, LoadFromFile, RemoveVertex
+//для каждой - задержки отдельных вызовов (мкс): mean, p50, p90, p99, max
+//результат - JSON (stdout или --output), краткая таблица - в stderr
+//
+//запуск: ./bench_graph [--quick] [--sizes 1000,10000] [--generators grid,demo] [--seed 42]
+//                      [--queries N] [--removals N] [--demo ../demo_graph.txt] [--output result.json]
+
+#include "../include/graph/StarGraph.h"
+#include "../include/graph/Dijkstra.h"
+#include "../include/core/Xoshiro256.h"
+#include "../include/game/RandomService.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+//===========================================
+// синтетические карты
+//===========================================
+
+struct SyntheticLane {
+    int from, to;
+    double distance, risk;
+};
+
+//карта до загрузки в StarGraph: построение графа тоже измеряется
+struct SyntheticMap {
+    std::string generator;
+    std::vector<std::string> names;
+    std::vector<SyntheticLane> lanes;
+};
+
+static std::string planetName(int index) {
+    return "P" + std::to_string(index);
+}
+
+//переход в обе стороны (риск у направлений свой)
+static void addLanePair(SyntheticMap& map, Xoshiro256& random, int a, int b, double distance) {
+    map.lanes.push_back(SyntheticLane{a, b, distance, random.NextRange(0.0, 0.5)});
+    map.lanes.push_back(SyntheticLane{b, a, distance, random.NextRange(0.0, 0.5)});
+}
+
+static SyntheticMap generateGrid(int planets, Xoshiro256& random) {
+    SyntheticMap map;
+    map.generator = "grid";
+    int side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(planets))));
+    for (int i = 0; i < planets; i++) {
+        map.names.push_back(planetName(i));
+    }
+    for (int i = 0; i < planets; i++) {
+        int row = i / side, column = i % side;
+        if (column + 1 < side && i + 1 < planets) {
+            addLanePair(map, random, i, i + 1, random.NextRange(50.0, 150.0));
+        }
+        if (row + 1 < side && i + side < planets) {
+            addLanePair(map, random, i, i + side, random.NextRange(50.0, 150.0));
+        }
+    }
+    return map;
+}
+
+static SyntheticMap generateGeometric(int planets, Xoshiro256& random) {
+    SyntheticMap map;
+    map.generator = "geometric";
+    
+    //радиус связи для средней степени ~6 в единичном квадрате: n * pi * r^2 = 6
+    const double side = 10000.0;
+    double radius = side * std::sqrt(6.0 / (M_PI * planets));
+    std::vector<double> xs(planets), ys(planets);
+    for (int i = 0; i < planets; i++) {
+        map.names.push_back(planetName(i));
+        xs[i] = random.NextRange(0.0, side);
+        ys[i] = random.NextRange(0.0, side);
+    }
+    
+    //ячейки размером с радиус: соседи только в 3x3 ячейках
+    int cells = std::max(1, static_cast<int>(side / radius));
+    double cellSize = side / cells;
+    std::vector<std::vector<int>> grid(static_cast<size_t>(cells) * cells);
+    auto cellOf = [&](double value) { return std::min(cells - 1, static_cast<int>(value / cellSize)); };
+    for (int i = 0; i < planets; i++) {
+        grid[static_cast<size_t>(cellOf(ys[i])) * cells + cellOf(xs[i])].push_back(i);
+    }
+    
+    for (int i = 0; i < planets; i++) {
+        int cx = cellOf(xs[i]), cy = cellOf(ys[i]);
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                int nx = cx + dx, ny = cy + dy;
+                if (nx < 0 || ny < 0 || nx >= cells || ny >= cells) {
+                    continue;
+                }
+                for (int j : grid[static_cast<size_t>(ny) * cells + nx]) {
+                    if (j <= i) {
+                        continue;
+                    }
+                    double distance = std::hypot(xs[i] - xs[j], ys[i] - ys[j]);
+                    if (distance <= radius) {
+                        addLanePair(map, random, i, j, distance);
+                    }
+                }
+            }
+        }
+    }
+    return map;
+}
+
+static SyntheticMap generateScaleFree(int planets, Xoshiro256& random) {
+    SyntheticMap map;
+    map.generator = "scalefree";
+    const int links = 3;
+    
+    //концы уже созданных рёбер: выбор случайного элемента = выбор пропорционально степени
+    std::vector<int> endpoints;
+    for (int i = 0; i < planets; i++) {
+        map.names.push_back(planetName(i));
+        if (i == 0) {
+            continue;
+        }
+        
+        std::vector<int> chosen;
+        int wanted = std::min(links, i);
+        while (static_cast<int>(chosen.size()) < wanted) {
+            int target = endpoints.empty() || i <= links
+                ? static_cast<int>(random.NextBelow(i))
+                : endpoints[random.NextBelow(endpoints.size())];
+            if (std::find(chosen.begin(), chosen.end(), target) == chosen.end()) {
+                chosen.push_back(target);
+            }
+        }
+        for (int target : chosen) {
+            addLanePair(map, random, i, target, random.NextRange(50.0, 500.0));
+            endpoints.push_back(i);
+            endpoints.push_back(target);
+        }
+    }
+    return map;
+}
+
+//копии демо-карты; последняя планета копии k связана с первой планетой копии k + 1 (кольцо)
+static SyntheticMap generateDemo(int planets, const StarGraph& demo, Xoshiro256& random) {
+    SyntheticMap map;
+    map.generator = "demo";
+    
+    const DynamicArray<int>& ids = demo.GetVertexArray();
+    int size = ids.GetSize();
+    std::unordered_map<int, int> local;
+    for (int i = 0; i < size; i++) {
+        local[ids[i]] = i;
+    }
+    
+    int copies = std::max(1, planets / size);
+    for (int copy = 0; copy < copies; copy++) {
+        for (int i = 0; i < size; i++) {
+            map.names.push_back(demo.GetVertexName(ids[i]) + "_" + std::to_string(copy));
+        }
+        int base = copy * size;
+        for (int i = 0; i < size; i++) {
+            const DynamicArray<Edge>& edges = demo.GetEdges(ids[i]);
+            for (int j = 0; j < edges.GetSize(); j++) {
+                map.lanes.push_back(SyntheticLane{base + i, base + local[edges[j].to],
+                                                  edges[j].data.distance, edges[j].data.riskFactor});
+            }
+        }
+    }
+    for (int copy = 0; copy < copies && copies > 1; copy++) {
+        int next = (copy + 1) % copies;
+        addLanePair(map, random, copy * size + size - 1, next * size, random.NextRange(300.0, 600.0));
+    }
+    return map;
+}
+
+//===========================================
+// измерения
+//===========================================
+
+struct Measurement {
+    std::string generator;
+    int planets;
+    int lanes;
+    std::string operation;
+    std::vector<double> samples;   //мкс на вызов
+};
+
+static double elapsedMicros(Clock::time_point begin) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - begin).count();
+}
+
+//процентиль по ближайшему рангу
+static double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+//сколько повторов дорогой операции (стоимость ~ V + E) уложится в бюджет работы
+static int samplesFor(long long work, long long budget, int minimum, int maximum) {
+    long long count = budget / std::max(1LL, work);
+    return static_cast<int>(std::max<long long>(minimum, std::min<long long>(maximum, count)));
+}
+
+struct Options {
+    std::vector<int> sizes{1000, 10000, 100000, 1000000};
+    std::vector<std::string> generators{"geometric", "grid", "scalefree", "demo"};
+    uint64_t seed = 42;
+    int queries = 0;               //0 - по размеру карты
+    int removals = 0;
+    std::string demoPath = "../demo_graph.txt";
+    std::string outputPath;
+    std::string tempPath = "bench_graph_tmp.txt";
+};
+
+static void benchmarkMap(const SyntheticMap& map, const Options& options, Xoshiro256& random,
+                         std::vector<Measurement>& results) {
+    int planets = static_cast<int>(map.names.size());
+    int laneCount = static_cast<int>(map.lanes.size());
+    long long work = static_cast<long long>(planets) + laneCount;
+    auto measurement = [&](const std::string& operation) {
+        results.push_back(Measurement{map.generator, planets, laneCount, operation, std::vector<double>()});
+        return &results.back().samples;
+    };
+    
+    //═══ построение ═══
+    StarGraph graph;
+    std::vector<int> ids(planets);
+    std::vector<double>* samples = measurement("AddVertex");
+    samples->reserve(planets);
+    for (int i = 0; i < planets; i++) {
+        auto begin = Clock::now();
+        ids[i] = graph.AddVertex(map.names[i]);
+        samples->push_back(elapsedMicros(begin));
+    }
+    
+    samples = measurement("AddEdge");
+    samples->reserve(laneCount);
+    for (const SyntheticLane& lane : map.lanes) {
+        auto begin = Clock::now();
+        graph.AddEdge(ids[lane.from], ids[lane.to], EdgeData(lane.distance, lane.risk));
+        samples->push_back(elapsedMicros(begin));
+    }
+    
+    //═══ маршруты ═══
+    Dijkstra dijkstra(graph);
+    int queries = options.queries > 0 ? options.queries : samplesFor(work, 50000000LL, 5, 200);
+    samples = measurement("FindShortestPath");
+    for (int q = 0; q < queries; q++) {
+        int start = ids[random.NextBelow(planets)];
+        int end = ids[random.NextBelow(planets)];
+        auto begin = Clock::now();
+        DijkstraResult result = dijkstra.FindShortestPath(start, end);
+        samples->push_back(elapsedMicros(begin));
+        if (result.pathExists && result.totalCost < 0.0) {
+            throw std::logic_error("negative path cost");
+        }
+    }
+    
+    int sources = options.queries > 0 ? options.queries : samplesFor(work, 20000000LL, 3, 50);
+    samples = measurement("FindAllShortestPaths");
+    for (int q = 0; q < sources; q++) {
+        int start = ids[random.NextBelow(planets)];
+        auto begin = Clock::now();
+        std::unordered_map<int, double> distances = dijkstra.FindAllShortestPaths(start);
+        samples->push_back(elapsedMicros(begin));
+        if (distances.empty()) {
+            throw std::logic_error("empty distance map");
+        }
+    }
+    
+    //═══ файлы ═══
+    int repeats = samplesFor(work, 10000000LL, 2, 10);
+    samples = measurement("SaveToFile");
+    for (int r = 0; r < repeats; r++) {
+        auto begin = Clock::now();
+        graph.SaveToFile(options.tempPath);
+        samples->push_back(elapsedMicros(begin));
+    }
+    
+    samples = measurement("LoadFromFile");
+    for (int r = 0; r < repeats; r++) {
+        StarGraph loaded;
+        auto begin = Clock::now();
+        loaded.LoadFromFile(options.tempPath);
+        samples->push_back(elapsedMicros(begin));
+        if (loaded.GetVertexCount() != planets || loaded.GetEdgeCount() != laneCount) {
+            throw std::logic_error("loaded graph differs from saved one");
+        }
+    }
+    std::remove(options.tempPath.c_str());
+    
+    //═══ удаление (последним: меняет граф) ═══
+    int removals = options.removals > 0 ? options.removals : samplesFor(work, 20000000LL, 3, 200);
+    removals = std::min(removals, planets);
+    samples = measurement("RemoveVertex");
+    for (int r = 0; r < removals; r++) {
+        //случайная ещё не удалённая планета (перестановка хвоста)
+        size_t pick = r + random.NextBelow(planets - r);
+        std::swap(ids[r], ids[pick]);
+        auto begin = Clock::now();
+        graph.RemoveVertex(ids[r]);
+        samples->push_back(elapsedMicros(begin));
+    }
+}
+
+//===========================================
+// вывод
+//===========================================
+
+static void writeJson(std::ostream& out, const Options& options, const std::vector<Measurement>& results) {
+    out << std::fixed << std::setprecision(3);
+    out << "{\n";
+    out << "  \"benchmark\": \"bench_graph\",\n";
+    out << "  \"seed\": " << options.seed << ",\n";
+    out << "  \"unit\": \"us\",\n";
+    out << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const Measurement& m = results[i];
+        std::vector<double> sorted = m.samples;
+        std::sort(sorted.begin(), sorted.end());
+        double total = 0.0;
+        for (double value : sorted) {
+            total += value;
+        }
+        double mean = sorted.empty() ? 0.0 : total / sorted.size();
+        
+        out << "    {\"generator\": \"" << m.generator << "\", \"planets\": " << m.planets
+            << ", \"lanes\": " << m.lanes << ", \"operation\": \"" << m.operation << "\""
+            << ", \"samples\": " << sorted.size()
+            << ", \"mean\": " << mean
+            << ", \"p50\": " << percentile(sorted, 50.0)
+            << ", \"p90\": " << percentile(sorted, 90.0)
+            << ", \"p99\": " << percentile(sorted, 99.0)
+            << ", \"max\": " << (sorted.empty() ? 0.0 : sorted.back())
+            << ", \"total_ms\": " << total / 1000.0 << "}"
+            << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+static void printSummary(const Measurement& m) {
+    std::vector<double> sorted = m.samples;
+    std::sort(sorted.begin(), sorted.end());
+    std::cerr << std::left << std::setw(11) << m.generator << std::right << std::setw(9) << m.planets
+              << "  " << std::left << std::setw(21) << m.operation << std::right
+              << std::fixed << std::setprecision(2)
+              << std::setw(7) << sorted.size() << " x"
+              << "  p50 " << std::setw(11) << percentile(sorted, 50.0)
+              << "  p99 " << std::setw(11) << percentile(sorted, 99.0) << " мкс" << std::endl;
+}
+
+template <typename T, typename Parse>
+static std::vector<T> splitList(const std::string& text, Parse parse) {
+    std::vector<T> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            values.push_back(parse(item));
+        }
+    }
+    return values;
+}
+
+static Options parseOptions(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + arg);
+            }
+            return argv[++i];
+        };
+        
+        if (arg == "--quick") {
+            options.sizes = {1000, 10000};
+        } else if (arg == "--sizes") {
+            options.sizes = splitList<int>(value(), [](const std::string& s) { return std::stoi(s); });
+        } else if (arg == "--generators") {
+            options.generators = splitList<std::string>(value(), [](const std::string& s) { return s; });
+        } else if (arg == "--seed") {
+            options.seed = std::stoull(value());
+        } else if (arg == "--queries") {
+            options.queries = std::stoi(value());
+        } else if (arg == "--removals") {
+            options.removals = std::stoi(value());
+        } else if (arg == "--demo") {
+            options.demoPath = value();
+        } else if (arg == "--output") {
+            options.outputPath = value();
+        } else {
+            throw std::invalid_argument("Unknown option " + arg);
+        }
+    }
+    for (int size : options.sizes) {
+        if (size <= 0) {
+            throw std::invalid_argument("Map size must be positive");
+        }
+    }
+    return options;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        Options options = parseOptions(argc, argv);
+        std::vector<Measurement> results;
+        
+        for (const std::string& generator : options.generators) {
+            StarGraph demo;
+            if (generator == "demo") {
+                demo.LoadFromFile(options.demoPath);
+            } else if (generator != "geometric" && generator != "grid" && generator != "scalefree") {
+                throw std::invalid_argument("Unknown generator " + generator);
+            }
+            
+            for (int size : options.sizes) {
+                //свой поток на каждую карту: результат не зависит от набора остальных
+                Xoshiro256 random(RandomService::streamSeed(options.seed, generator + "/" + std::to_string(size)));
+                SyntheticMap map = generator == "grid" ? generateGrid(size, random)
+                    : generator == "geometric" ? generateGeometric(size, random)
+                    : generator == "scalefree" ? generateScaleFree(size, random)
+                    : generateDemo(size, demo, random);
+                
+                size_t first = results.size();
+                benchmarkMap(map, options, random, results);
+                for (size_t i = first; i < results.size(); i++) {
+                    printSummary(results[i]);
+                }
+            }
+        }
+        
+        if (options.outputPath.empty()) {
+            writeJson(std::cout, options, results);
+        } else {
+            std::ofstream file(options.outputPath);
+            if (!file) {
+                throw std::runtime_error("Cannot open " + options.outputPath);
+            }
+            writeJson(file, options, results);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "bench_graph: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
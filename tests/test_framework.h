@@ -5,6 +5,17 @@
 #include <string>
 #include <functional>
 #include <vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <new>
+#include <sstream>
+#include <stdexcept>
 
 //простой тестовый фреймворк
 class TestFramework {
@@ -106,6 +117,446 @@ public:
     TestFramework::instance().runAll(); \
     return TestFramework::instance().getFailedCount();
 
+//═══════════════════════════════════════════════════════════════
+//микробенчмарки
+//═══════════════════════════════════════════════════════════════
+//
+//BENCH(name) { подготовка; while (state.keepRunning()) { измеряемый код; doNotOptimize(результат); } }
+//тело вызывается многократно: сначала прогрев и подбор числа итераций (замер не короче
+//sampleTime), затем замеры; каждый замер даёт время одной итерации, по замерам считаются
+//mean, median, p99 и stddev
+//подготовка до цикла не измеряется; pauseTiming/resumeTiming исключают работу внутри цикла
+//
+//счетчик выделений памяти включается в одном .cpp перед подключением заголовка:
+//  #define TEST_FRAMEWORK_COUNT_ALLOCATIONS
+//(заменяет глобальный operator new, поэтому не годится для нескольких единиц трансляции)
+
+namespace benchdetail {
+    inline std::atomic<unsigned long long>& allocationCounter() {
+        static std::atomic<unsigned long long> counter(0);
+        return counter;
+    }
+    
+    inline bool& allocationCounting() {
+        static bool enabled = false;
+        return enabled;
+    }
+}
+
+//значение считается использованным: компилятор не выбросит вычисление
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+//запись в память считается видимой: компилятор не выбросит сохранения
+inline void clobberMemory() {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+//состояние одного замера: итерации, время и выделения памяти только внутри цикла
+class BenchState {
+private:
+    using Clock = std::chrono::steady_clock;
+    
+    long long remaining;
+    long long total;
+    bool started = false;
+    bool paused = false;
+    bool finished = false;
+    Clock::time_point begin;
+    double elapsedNs = 0.0;
+    unsigned long long allocationsAtStart = 0;
+    unsigned long long allocations = 0;
+    
+    void startTimer() {
+        allocationsAtStart = benchdetail::allocationCounter().load(std::memory_order_relaxed);
+        begin = Clock::now();
+    }
+    
+    void stopTimer() {
+        elapsedNs += std::chrono::duration<double, std::nano>(Clock::now() - begin).count();
+        allocations += benchdetail::allocationCounter().load(std::memory_order_relaxed) - allocationsAtStart;
+    }
+
+public:
+    explicit BenchState(long long iterations) : remaining(iterations), total(iterations) {}
+    
+    //true - выполнить ещё одну итерацию; первый вызов запускает, последний останавливает замер
+    bool keepRunning() {
+        if (!started) {
+            started = true;
+            startTimer();
+        }
+        if (remaining > 0) {
+            remaining--;
+            return true;
+        }
+        if (!paused) {
+            stopTimer();
+            paused = true;
+        }
+        finished = true;
+        return false;
+    }
+    
+    void pauseTiming() {
+        if (started && !paused) {
+            stopTimer();
+            paused = true;
+        }
+    }
+    
+    void resumeTiming() {
+        if (paused && !finished) {
+            paused = false;
+            startTimer();
+        }
+    }
+    
+    long long iterations() const { return total; }
+    bool hasStarted() const { return started; }
+    double getElapsedNs() const { return elapsedNs; }
+    unsigned long long getAllocations() const { return allocations; }
+};
+
+class BenchFramework {
+private:
+    struct BenchCase {
+        std::string name;
+        std::function<void(BenchState&)> benchFunc;
+    };
+    
+    struct BenchResult {
+        std::string name;
+        long long iterations;          //итераций в одном замере
+        int samples;
+        double meanNs, medianNs, p99Ns, stddevNs, minNs;
+        double allocationsPerIteration;   //< 0 - счетчик выключен
+    };
+    
+    struct Options {
+        std::string filter;
+        std::string jsonPath;
+        std::string baselinePath;
+        double threshold = 10.0;       //допустимый рост медианы относительно базы, %
+        double warmupTime = 0.05;      //секунды
+        double measureTime = 0.5;      //секунды на бенчмарк
+        int minSamples = 5;
+        int maxSamples = 50;
+    };
+    
+    std::vector<BenchCase> benches;
+    
+    //процентиль по ближайшему рангу
+    static double percentile(const std::vector<double>& sorted, double p) {
+        size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+        return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+    }
+    
+    static BenchResult measure(const BenchCase& bench, const Options& options) {
+        using Clock = std::chrono::steady_clock;
+        double sampleTimeNs = options.measureTime * 1e9 / options.maxSamples;
+        
+        //прогрев и подбор числа итераций: замер не короче sampleTime
+        long long iterations = 1;
+        auto warmupBegin = Clock::now();
+        while (true) {
+            BenchState state(iterations);
+            bench.benchFunc(state);
+            //без keepRunning замер пуст: число итераций росло бы бесконечно
+            if (state.getElapsedNs() == 0.0 && !state.hasStarted()) {
+                throw std::runtime_error("BENCH body never calls state.keepRunning()");
+            }
+            double elapsed = std::max(1.0, state.getElapsedNs());
+            double warmed = std::chrono::duration<double>(Clock::now() - warmupBegin).count();
+            if (elapsed >= sampleTimeNs) {
+                if (warmed >= options.warmupTime) {
+                    break;
+                }
+                continue;
+            }
+            double scale = std::min(10.0, std::max(2.0, 1.2 * sampleTimeNs / elapsed));
+            iterations = static_cast<long long>(std::ceil(iterations * scale));
+        }
+        
+        std::vector<double> perIteration;
+        unsigned long long allocations = 0;
+        auto measureBegin = Clock::now();
+        while (static_cast<int>(perIteration.size()) < options.maxSamples) {
+            BenchState state(iterations);
+            bench.benchFunc(state);
+            perIteration.push_back(state.getElapsedNs() / iterations);
+            allocations += state.getAllocations();
+            double spent = std::chrono::duration<double>(Clock::now() - measureBegin).count();
+            if (static_cast<int>(perIteration.size()) >= options.minSamples && spent >= options.measureTime) {
+                break;
+            }
+        }
+        
+        std::vector<double> sorted = perIteration;
+        std::sort(sorted.begin(), sorted.end());
+        double sum = 0.0;
+        for (double value : sorted) {
+            sum += value;
+        }
+        double mean = sum / sorted.size();
+        double squares = 0.0;
+        for (double value : sorted) {
+            squares += (value - mean) * (value - mean);
+        }
+        
+        BenchResult result;
+        result.name = bench.name;
+        result.iterations = iterations;
+        result.samples = static_cast<int>(sorted.size());
+        result.meanNs = mean;
+        result.medianNs = sorted.size() % 2 == 1 ? sorted[sorted.size() / 2]
+            : (sorted[sorted.size() / 2 - 1] + sorted[sorted.size() / 2]) / 2.0;
+        result.p99Ns = percentile(sorted, 99.0);
+        result.stddevNs = sorted.size() > 1 ? std::sqrt(squares / (sorted.size() - 1)) : 0.0;
+        result.minNs = sorted.front();
+        result.allocationsPerIteration = benchdetail::allocationCounting()
+            ? static_cast<double>(allocations) / (static_cast<double>(iterations) * sorted.size())
+            : -1.0;
+        return result;
+    }
+    
+    static std::string formatTime(double ns) {
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(ns < 10.0 ? 2 : 1);
+        if (ns >= 1e9) {
+            out << ns / 1e9 << " s";
+        } else if (ns >= 1e6) {
+            out << ns / 1e6 << " ms";
+        } else if (ns >= 1e3) {
+            out << ns / 1e3 << " us";
+        } else {
+            out << ns << " ns";
+        }
+        return out.str();
+    }
+    
+    static void writeJson(const std::string& path, const std::vector<BenchResult>& results) {
+        std::ofstream out(path);
+        if (!out) {
+            throw std::runtime_error("Cannot open " + path);
+        }
+        out << std::fixed << std::setprecision(3);
+        out << "{\n  \"unit\": \"ns\",\n  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            const BenchResult& r = results[i];
+            out << "    {\"name\": \"" << r.name << "\", \"iterations\": " << r.iterations
+                << ", \"samples\": " << r.samples
+                << ", \"mean_ns\": " << r.meanNs
+                << ", \"median_ns\": " << r.medianNs
+                << ", \"p99_ns\": " << r.p99Ns
+                << ", \"stddev_ns\": " << r.stddevNs
+                << ", \"min_ns\": " << r.minNs
+                << ", \"allocs_per_iter\": ";
+            if (r.allocationsPerIteration < 0.0) {
+                out << "null";
+            } else {
+                out << r.allocationsPerIteration;
+            }
+            out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+    
+    //медианы из JSON, записанного writeJson (по объекту на строку)
+    static std::map<std::string, double> readBaseline(const std::string& path) {
+        std::ifstream in(path);
+        if (!in) {
+            throw std::runtime_error("Cannot open baseline " + path);
+        }
+        std::map<std::string, double> medians;
+        std::string line;
+        const std::string nameKey = "\"name\": \"";
+        const std::string medianKey = "\"median_ns\": ";
+        while (std::getline(in, line)) {
+            size_t name = line.find(nameKey);
+            size_t median = line.find(medianKey);
+            if (name == std::string::npos || median == std::string::npos) {
+                continue;
+            }
+            name += nameKey.size();
+            size_t nameEnd = line.find('"', name);
+            medians[line.substr(name, nameEnd - name)] = std::atof(line.c_str() + median + medianKey.size());
+        }
+        return medians;
+    }
+    
+    static Options parseOptions(int argc, char* argv[]) {
+        Options options;
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("Missing value for " + arg);
+            }
+            std::string value = argv[++i];
+            if (arg == "--filter") {
+                options.filter = value;
+            } else if (arg == "--json") {
+                options.jsonPath = value;
+            } else if (arg == "--baseline") {
+                options.baselinePath = value;
+            } else if (arg == "--threshold") {
+                options.threshold = std::atof(value.c_str());
+            } else if (arg == "--time") {
+                options.measureTime = std::max(0.001, std::atof(value.c_str()));
+            } else {
+                throw std::invalid_argument("Unknown option " + arg);
+            }
+        }
+        return options;
+    }
+
+public:
+    static BenchFramework& instance() {
+        static BenchFramework instance;
+        return instance;
+    }
+    
+    void addBench(const std::string& name, std::function<void(BenchState&)> benchFunc) {
+        benches.push_back({name, benchFunc});
+    }
+    
+    //параметры: --filter подстрока, --json файл, --baseline файл, --threshold проценты, --time секунды
+    //код возврата 1, если у какого-то бенчмарка медиана выросла больше порога относительно базы
+    //(или бенчмарк упал), иначе 0
+    int runAll(int argc, char* argv[]) {
+        Options options;
+        std::map<std::string, double> baseline;
+        try {
+            options = parseOptions(argc, argv);
+            if (!options.baselinePath.empty()) {
+                baseline = readBaseline(options.baselinePath);
+            }
+        } catch (const std::exception& e) {
+            std::cout << "❌ " << e.what() << std::endl;
+            return 1;
+        }
+        
+        size_t nameWidth = 10;
+        for (const auto& bench : benches) {
+            nameWidth = std::max(nameWidth, bench.name.size() + 2);
+        }
+        
+        std::cout << "\n⏱  Запуск бенчмарков...\n" << std::endl;
+        std::cout << "Бенчмарк" << std::string(nameWidth - 8, ' ')
+                  << std::setw(12) << "median" << std::setw(12) << "mean" << std::setw(12) << "p99"
+                  << std::setw(12) << "stddev" << std::setw(10) << "allocs" << std::endl;
+        
+        std::vector<BenchResult> results;
+        int regressions = 0;
+        for (const auto& bench : benches) {
+            if (!options.filter.empty() && bench.name.find(options.filter) == std::string::npos) {
+                continue;
+            }
+            try {
+                BenchResult r = measure(bench, options);
+                results.push_back(r);
+                
+                std::ostringstream allocs;
+                if (r.allocationsPerIteration < 0.0) {
+                    allocs << "-";
+                } else {
+                    allocs << std::fixed << std::setprecision(1) << r.allocationsPerIteration;
+                }
+                std::cout << std::left << std::setw(nameWidth) << r.name << std::right
+                          << std::setw(12) << formatTime(r.medianNs) << std::setw(12) << formatTime(r.meanNs)
+                          << std::setw(12) << formatTime(r.p99Ns) << std::setw(12) << formatTime(r.stddevNs)
+                          << std::setw(10) << allocs.str();
+                
+                auto base = baseline.find(r.name);
+                if (base != baseline.end() && base->second > 0.0) {
+                    double change = (r.medianNs / base->second - 1.0) * 100.0;
+                    std::cout << "  " << std::showpos << std::fixed << std::setprecision(1) << change
+                              << std::noshowpos << "%";
+                    if (change > options.threshold) {
+                        std::cout << " ⚠️";
+                        regressions++;
+                    }
+                }
+                std::cout << std::endl;
+            } catch (const std::exception& e) {
+                std::cout << std::left << std::setw(nameWidth) << bench.name << " ❌ " << e.what() << std::endl;
+                regressions++;
+            }
+        }
+        
+        if (!options.jsonPath.empty()) {
+            writeJson(options.jsonPath, results);
+            std::cout << "\n📄 Результаты: " << options.jsonPath << std::endl;
+        }
+        if (!baseline.empty()) {
+            std::cout << "\n" << (regressions == 0 ? "🎉 Без регрессий" : "⚠️  Регрессии: " + std::to_string(regressions))
+                      << " (порог " << options.threshold << "%)" << std::endl;
+        }
+        return regressions > 0 ? 1 : 0;
+    }
+};
+
+#define BENCH(name) \
+    void bench_##name(BenchState& state); \
+    struct BenchRegistrar_##name { \
+        BenchRegistrar_##name() { \
+            BenchFramework::instance().addBench(#name, bench_##name); \
+        } \
+    }; \
+    static BenchRegistrar_##name benchRegistrar_##name; \
+    void bench_##name(BenchState& state)
+
+#define RUN_ALL_BENCHMARKS(argc, argv) \
+    return BenchFramework::instance().runAll(argc, argv);
+
+#ifdef TEST_FRAMEWORK_COUNT_ALLOCATIONS
+//замена глобального operator new: счетчик выделений для allocs_per_iter
+//(operator new[] по умолчанию вызывает эту версию)
+struct BenchAllocationCountingEnabler {
+    BenchAllocationCountingEnabler() { benchdetail::allocationCounting() = true; }
+};
+static BenchAllocationCountingEnabler benchAllocationCountingEnabler;
+
+//GCC после встраивания принимает пару operator new / free за несовпадающие
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpragmas"
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size) {
+    benchdetail::allocationCounter().fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size == 0 ? 1 : size)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
 #endif //TEST_FRAMEWORK_H
 
 
@@ -1,6 +1,29 @@
 #include "test_framework.h"
 #include "../include/graph/StarGraph.h"
+#include "../include/graph/ForceLayout.h"
+#include "../include/graph/Dijkstra.h"
+#include "../include/graph/HazardForecast.h"
+#include "../include/graph/TimeDependentRouter.h"
+#include "../include/graph/ParetoRouter.h"
+#include "../include/graph/KShortestPaths.h"
+#include "../include/graph/ConstrainedRouter.h"
+#include "../include/graph/TourPlanner.h"
+#include "../include/core/UniformGrid.h"
+#include "../include/core/Xoshiro256.h"
+#include "../include/game/SimulationClock.h"
+#include "../include/game/HazardField.h"
+#include "../include/game/PirateModel.h"
+#include "../include/game/RouteRiskSimulator.h"
+#include "../include/game/GameSimulation.h"
+#include "../include/game/RandomService.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <memory>
 #include <stdexcept>
+#include <vector>
 
 //===========================================
 // тесты добавления вершин
@@ -311,6 +334,1464 @@ TEST(Clear_NonEmptyGraph_Success) {
     ASSERT_FALSE(graph.HasVertex("Юпитер"));
 }
 
+//===========================================
+// тесты обхода вершин
+//===========================================
+
+TEST(Vertices_RangeVisitsAllLiveVertices) {
+    StarGraph graph;
+    int id1 = graph.AddVertex("Терра");
+    int id2 = graph.AddVertex("Марс");
+    int id3 = graph.AddVertex("Юпитер");
+    graph.RemoveVertex(id2);
+    
+    int count = 0;
+    int idSum = 0;
+    for (int vertex : graph.Vertices()) {
+        count++;
+        idSum += vertex;
+    }
+    ASSERT_EQUAL(count, 2);
+    ASSERT_EQUAL(idSum, id1 + id3);
+}
+
+TEST(Vertices_ArrayIsSortedAndCachedUntilChange) {
+    StarGraph graph;
+    for (int i = 0; i < 10; i++) {
+        graph.AddVertex("Планета " + std::to_string(i));
+    }
+    
+    const DynamicArray<int>& first = graph.GetVertexArray();
+    ASSERT_EQUAL(first.GetSize(), 10);
+    for (int i = 1; i < first.GetSize(); i++) {
+        ASSERT_TRUE(first.Get(i - 1) < first.Get(i));
+    }
+    
+    //без изменений повторный вызов возвращает тот же массив
+    unsigned long long version = graph.GetVersion();
+    ASSERT_TRUE(&graph.GetVertexArray() == &first);
+    ASSERT_EQUAL(graph.GetVersion(), version);
+    
+    //после удаления массив пересобирается, версия растет
+    graph.RemoveVertex("Планета 0");
+    ASSERT_EQUAL(graph.GetVertexArray().GetSize(), 9);
+    ASSERT_TRUE(graph.GetVersion() > version);
+    
+    //артефакт меняет версию, но не набор вершин и рёбер
+    unsigned long long topology = graph.GetTopologyVersion();
+    graph.SetArtifact(first.Get(0), true);
+    ASSERT_EQUAL(graph.GetTopologyVersion(), topology);
+    graph.AddEdge(first.Get(0), first.Get(1), EdgeData(1.0, 0.0));
+    ASSERT_TRUE(graph.GetTopologyVersion() > topology);
+}
+
+TEST(Degrees_FollowEdgeAndVertexRemoval) {
+    StarGraph graph;
+    int a = graph.AddVertex("A");
+    int b = graph.AddVertex("B");
+    int c = graph.AddVertex("C");
+    
+    graph.AddEdge(a, b, EdgeData(1.0, 0.0));
+    graph.AddEdge(a, b, EdgeData(2.0, 0.0));  //параллельное ребро
+    graph.AddEdge(c, b, EdgeData(1.0, 0.0));
+    graph.AddEdge(b, c, EdgeData(1.0, 0.0));
+    ASSERT_EQUAL(graph.GetInDegree(b), 3);
+    ASSERT_EQUAL(graph.GetOutDegree(a), 2);
+    ASSERT_EQUAL(graph.GetEdgeCount(), 4);
+    
+    graph.RemoveEdge(a, b);  //удаляет оба параллельных ребра
+    ASSERT_EQUAL(graph.GetInDegree(b), 1);
+    ASSERT_EQUAL(graph.GetEdgeCount(), 2);
+    
+    graph.RemoveVertex(c);
+    ASSERT_EQUAL(graph.GetInDegree(b), 0);
+    ASSERT_EQUAL(graph.GetDegree(b), 0);
+    ASSERT_EQUAL(graph.GetEdgeCount(), 0);
+    ASSERT_THROWS(graph.GetInDegree(c));
+    
+    graph.Clear();
+    ASSERT_EQUAL(graph.GetEdgeCount(), 0);
+}
+
+//===========================================
+// тесты поиска планет по имени
+//===========================================
+
+TEST(Search_ByPrefix_IgnoresCase) {
+    StarGraph graph;
+    int mars = graph.AddVertex("Марс");
+    int marsBase = graph.AddVertex("Марсианская База");
+    graph.AddVertex("Юпитер");
+    
+    DynamicArray<int> found = graph.FindVerticesByPrefix("мар", 10);
+    ASSERT_EQUAL(found.GetSize(), 2);
+    ASSERT_EQUAL(found.Get(0), mars);
+    ASSERT_EQUAL(found.Get(1), marsBase);
+    
+    ASSERT_EQUAL(graph.FindVerticesByPrefix("МАР", 1).GetSize(), 1);
+    ASSERT_EQUAL(graph.FindVerticesByPrefix("Сатурн", 10).GetSize(), 0);
+}
+
+TEST(Search_Fuzzy_FindsTypos) {
+    StarGraph graph;
+    graph.AddVertex("Терра");
+    int jupiter = graph.AddVertex("Юпитер");
+    
+    DynamicArray<int> found = graph.FindVerticesFuzzy("юпитр", 5);
+    ASSERT_TRUE(found.GetSize() >= 1);
+    ASSERT_EQUAL(found.Get(0), jupiter);
+}
+
+TEST(Search_IndexFollowsRemoveAndClear) {
+    StarGraph graph;
+    int mars = graph.AddVertex("Марс");
+    graph.AddVertex("Марсианская База");
+    
+    graph.RemoveVertex("Марсианская База");
+    DynamicArray<int> found = graph.SearchVertices("Марс", 10);
+    ASSERT_EQUAL(found.GetSize(), 1);
+    ASSERT_EQUAL(found.Get(0), mars);
+    
+    graph.Clear();
+    ASSERT_EQUAL(graph.SearchVertices("Марс", 10).GetSize(), 0);
+}
+
+//===========================================
+// тесты пространственной сетки
+//===========================================
+
+TEST(UniformGrid_RadiusQueryAndNearest) {
+    UniformGrid<int> grid(100.0);
+    grid.Insert(1, 10.0, 10.0);
+    grid.Insert(2, 250.0, 10.0);
+    grid.Insert(3, -40.0, -40.0);
+    
+    DynamicArray<int> near = grid.QueryRadius(0.0, 0.0, 60.0);
+    ASSERT_EQUAL(near.GetSize(), 2);
+    
+    int nearest = -1;
+    ASSERT_TRUE(grid.FindNearest(240.0, 0.0, 30.0, nearest));
+    ASSERT_EQUAL(nearest, 2);
+    ASSERT_FALSE(grid.FindNearest(500.0, 500.0, 30.0, nearest));
+}
+
+TEST(UniformGrid_MoveAndRemoveKeepIndexConsistent) {
+    UniformGrid<int> grid(100.0);
+    grid.Insert(1, 10.0, 10.0);
+    
+    //перемещение в другую ячейку
+    grid.Move(1, 510.0, 510.0);
+    ASSERT_EQUAL(grid.QueryRadius(10.0, 10.0, 5.0).GetSize(), 0);
+    ASSERT_EQUAL(grid.QueryRadius(510.0, 510.0, 5.0).GetSize(), 1);
+    
+    //прямоугольник, покрывающий несколько ячеек, возвращается один раз
+    grid.InsertBox(2, 0.0, 0.0, 450.0, 30.0);
+    ASSERT_EQUAL(grid.QueryRadius(300.0, 20.0, 400.0).GetSize(), 1);
+    
+    grid.Remove(1);
+    grid.Remove(2);
+    ASSERT_EQUAL(grid.GetSize(), 0);
+    ASSERT_EQUAL(grid.QueryRadius(510.0, 510.0, 1000.0).GetSize(), 0);
+}
+
+TEST(UniformGrid_NegativeCoordinatesKeepDistinctCells) {
+    UniformGrid<int> grid(100.0);
+    //ячейки (-1, -1), (-1, 0), (0, -1) и (0, 0) не должны сливаться
+    grid.Insert(1, -50.0, -50.0);
+    grid.Insert(2, -50.0, 50.0);
+    grid.Insert(3, 50.0, -50.0);
+    grid.Insert(4, 50.0, 50.0);
+    grid.Insert(5, -12345.0, -67890.0);
+    
+    ASSERT_EQUAL(grid.QueryRadius(-50.0, -50.0, 10.0).GetSize(), 1);
+    ASSERT_EQUAL(grid.QueryRadius(-50.0, -50.0, 10.0)[0], 1);
+    ASSERT_EQUAL(grid.QueryRadius(-50.0, 50.0, 10.0)[0], 2);
+    ASSERT_EQUAL(grid.QueryRadius(50.0, -50.0, 10.0)[0], 3);
+    ASSERT_EQUAL(grid.QueryRadius(0.0, 0.0, 100.0).GetSize(), 4);
+    
+    int nearest = -1;
+    ASSERT_TRUE(grid.FindNearest(-12340.0, -67880.0, 20.0, nearest));
+    ASSERT_EQUAL(nearest, 5);
+    
+    //перемещение через начало координат
+    grid.Move(5, 30.0, 30.0);
+    ASSERT_EQUAL(grid.QueryRadius(-12345.0, -67890.0, 50.0).GetSize(), 0);
+    ASSERT_EQUAL(grid.QueryRadius(30.0, 30.0, 5.0)[0], 5);
+}
+
+//===========================================
+// тесты силовой раскладки
+//===========================================
+
+TEST(ForceLayout_SeparatesNodesAndKeepsEdgesShort) {
+    StarGraph graph;
+    for (int i = 0; i < 40; i++) {
+        graph.AddVertex("P" + std::to_string(i));
+    }
+    //цепочка 0-1-...-39
+    for (int i = 0; i + 1 < 40; i++) {
+        graph.AddEdge(i, i + 1, EdgeData(1.0, 0.0));
+    }
+    
+    ForceLayout::Settings settings;
+    settings.iterations = 150;
+    settings.idealLength = 100.0;
+    ForceLayout layout(graph, {}, settings);  //без начальных координат
+    
+    std::atomic<bool> cancelled(false);
+    ASSERT_TRUE(layout.Run(cancelled));
+    ASSERT_TRUE(layout.IsFinished());
+    
+    std::unordered_map<int, LayoutPoint> positions = layout.GetPositions();
+    ASSERT_EQUAL(static_cast<int>(positions.size()), 40);
+    
+    //соседи по цепочке ближе, чем концы цепочки, и ни одна пара не слиплась
+    double minDistance = 1e18;
+    for (int i = 0; i < 40; i++) {
+        for (int j = i + 1; j < 40; j++) {
+            double dx = positions[i].x - positions[j].x;
+            double dy = positions[i].y - positions[j].y;
+            minDistance = std::min(minDistance, std::sqrt(dx * dx + dy * dy));
+        }
+    }
+    ASSERT_TRUE(minDistance > 10.0);
+    
+    double edgeX = positions[0].x - positions[1].x, edgeY = positions[0].y - positions[1].y;
+    double endX = positions[0].x - positions[39].x, endY = positions[0].y - positions[39].y;
+    ASSERT_TRUE(edgeX * edgeX + edgeY * edgeY < endX * endX + endY * endY);
+}
+
+TEST(ForceLayout_CancelStopsRun) {
+    StarGraph graph;
+    graph.AddVertex("A");
+    graph.AddVertex("B");
+    
+    ForceLayout layout(graph, {{0, LayoutPoint(0, 0)}, {1, LayoutPoint(0, 0)}});
+    std::atomic<bool> cancelled(true);
+    ASSERT_FALSE(layout.Run(cancelled));
+    ASSERT_EQUAL(layout.GetIteration(), 0);
+}
+
+//===========================================
+// тесты часов симуляции
+//===========================================
+
+TEST(SimulationClock_SystemsFireAtTheirPeriods) {
+    SimulationClock clock(0.01);
+    int everyStep = 0, fast = 0, slow = 0, disabled = 0;
+    clock.addSystem("step", 0.0, [&](double) { everyStep++; });
+    clock.addSystem("fast", 0.05, [&](double) { fast++; });
+    int slowId = clock.addSystem("slow", 1.0, [&](double) { slow++; });
+    int disabledId = clock.addSystem("off", 0.1, [&](double) { disabled++; }, false);
+    
+    clock.runFor(2.0);
+    ASSERT_EQUAL(clock.getStepCount(), 200);
+    ASSERT_EQUAL(everyStep, 200);
+    ASSERT_EQUAL(fast, 40);
+    ASSERT_EQUAL(slow, 2);
+    ASSERT_EQUAL(disabled, 0);
+    
+    //перезапуск начинает период заново, удалённая система больше не вызывается
+    clock.runFor(0.5);
+    clock.restartSystem(disabledId);
+    clock.removeSystem(slowId);
+    clock.runFor(0.55);
+    ASSERT_EQUAL(disabled, 5);
+    ASSERT_EQUAL(slow, 2);
+    ASSERT_THROWS(clock.setEnabled(slowId, true));
+}
+
+TEST(SimulationClock_AdvanceKeepsRemainderAndCapsSteps) {
+    SimulationClock clock(0.01, 4);
+    int steps = 0;
+    clock.addSystem("count", 0.0, [&](double) { steps++; });
+    
+    ASSERT_EQUAL(clock.advance(0.025), 2);
+    ASSERT_EQUAL(clock.advance(0.006), 1);   //0.005 + 0.006
+    ASSERT_EQUAL(clock.advance(10.0), 4);    //долгая пауза не копится
+    ASSERT_EQUAL(clock.advance(0.0), 0);
+    ASSERT_EQUAL(steps, 7);
+    
+    ASSERT_THROWS(SimulationClock(0.0));
+    ASSERT_THROWS(clock.setTimeScale(-1.0));
+}
+
+//===========================================
+// тесты поля опасностей
+//===========================================
+
+TEST(HazardField_PoolReusesSlotsAndExpires) {
+    HazardField field(2);
+    int a = field.spawn(0, 0, 10, 0, 50, 1.0);
+    int b = field.spawn(0, 0, 0, 5, 50, 10.0);
+    int c = field.spawn(0, 0, 0, 0, 50);   //пул вырос
+    ASSERT_EQUAL(field.getActiveCount(), 3);
+    ASSERT_TRUE(field.getCapacity() >= 3);
+    
+    std::vector<int> expired;
+    field.update(0.5, &expired);
+    ASSERT_TRUE(std::fabs(field.getX(a) - 5.0) < 1e-9);
+    ASSERT_TRUE(std::fabs(field.getPreviousX(a)) < 1e-9);
+    ASSERT_TRUE(expired.empty());
+    
+    field.update(0.5, &expired);
+    ASSERT_EQUAL(static_cast<int>(expired.size()), 1);
+    ASSERT_EQUAL(expired[0], a);
+    ASSERT_FALSE(field.isActive(a));
+    ASSERT_EQUAL(field.getActiveCount(), 2);
+    
+    //освобождённый слот выдаётся снова
+    ASSERT_EQUAL(field.spawn(1, 1, 0, 0, 20), a);
+    field.release(b);
+    ASSERT_THROWS(field.release(b));
+    ASSERT_TRUE(field.isActive(c));
+}
+
+TEST(HazardField_CollidesPointsAndSweptSegments) {
+    HazardField field;
+    int slot = field.spawn(0, 0, 100, 0, 10);
+    
+    double xs[] = {5, 0, 30, -15};
+    double ys[] = {5, 20, 0, 0};
+    std::vector<int> hits;
+    field.collidePoints(slot, xs, ys, 4, 6.0, hits);   //радиус 10 + 6
+    ASSERT_EQUAL(static_cast<int>(hits.size()), 2);
+    ASSERT_EQUAL(hits[0], 0);
+    ASSERT_EQUAL(hits[1], 3);
+    
+    //за шаг дыра пролетела от x=0 до x=100: задеты рёбра, пересечённые путём
+    field.update(1.0);
+    double ax[] = {50, 50, 200, -30};
+    double ay[] = {-100, 15, -5, -5};
+    double bx[] = {50, 60, 200, -30};
+    double by[] = {100, 40, 5, 5};
+    hits.clear();
+    field.collideSegments(slot, ax, ay, bx, by, 4, hits);
+    ASSERT_EQUAL(static_cast<int>(hits.size()), 1);
+    ASSERT_EQUAL(hits[0], 0);
+    
+    //шаг (100) длиннее радиуса: точка посередине пути задета, хотя далека от обоих концов
+    double px[] = {50, 50, 150};
+    double py[] = {12, 30, 0};
+    hits.clear();
+    field.collidePoints(slot, px, py, 3, 6.0, hits);
+    ASSERT_EQUAL(static_cast<int>(hits.size()), 1);
+    ASSERT_EQUAL(hits[0], 0);
+}
+
+//===========================================
+// тесты прогноза черных дыр
+//===========================================
+
+TEST(HazardForecast_ClosedFormWindows) {
+    HazardTrack track(0, 0, 10, 0, 10, 100);
+    double begin = 0, end = 0;
+    
+    //|(10t, 0) - (100, 0)| <= 20  ->  t in [8, 12]
+    ASSERT_TRUE(HazardForecast::PointWindow(track, 100, 0, 20, begin, end));
+    ASSERT_TRUE(std::fabs(begin - 8.0) < 1e-9 && std::fabs(end - 12.0) < 1e-9);
+    ASSERT_FALSE(HazardForecast::PointWindow(track, 100, 50, 20, begin, end));
+    ASSERT_FALSE(HazardForecast::PointWindow(track, 2000, 0, 20, begin, end));   //после конца жизни
+    
+    //поперечное ребро x = 50: капсула шириной 2 * 10
+    ASSERT_TRUE(HazardForecast::SegmentWindow(track, 50, -100, 50, 100, 10, begin, end));
+    ASSERT_TRUE(std::fabs(begin - 4.0) < 1e-9 && std::fabs(end - 6.0) < 1e-9);
+    //ребро вдоль траектории: от касания ближнего конца до ухода с дальнего
+    ASSERT_TRUE(HazardForecast::SegmentWindow(track, 200, 0, 300, 0, 10, begin, end));
+    ASSERT_TRUE(std::fabs(begin - 19.0) < 1e-9 && std::fabs(end - 31.0) < 1e-9);
+    
+    //окно обрезается по текущему моменту
+    HazardTrack inside(100, 0, 10, 0, 10, 100);
+    ASSERT_TRUE(HazardForecast::PointWindow(inside, 100, 0, 20, begin, end));
+    ASSERT_TRUE(begin == 0.0 && std::fabs(end - 2.0) < 1e-9);
+}
+
+//черная дыра летит сверху вниз через B и гаснет у y = 0
+static void buildForecastScene(StarGraph& graph, HazardForecast& forecast, int ids[4]) {
+    ids[0] = graph.AddVertex("A");
+    ids[1] = graph.AddVertex("B");
+    ids[2] = graph.AddVertex("C");
+    ids[3] = graph.AddVertex("D");
+    graph.AddEdge(ids[0], ids[1], EdgeData(100.0, 0.0));
+    graph.AddEdge(ids[1], ids[3], EdgeData(100.0, 0.0));
+    graph.AddEdge(ids[0], ids[2], EdgeData(150.0, 0.0));
+    graph.AddEdge(ids[2], ids[3], EdgeData(150.0, 0.0));
+    
+    forecast.SetPlanetPosition(ids[0], 0, 0);
+    forecast.SetPlanetPosition(ids[1], 300, -200);
+    forecast.SetPlanetPosition(ids[2], 300, 300);
+    forecast.SetPlanetPosition(ids[3], 600, 0);
+    forecast.AddHazard(HazardTrack(300, -600, 0, 10, 50, 60));
+    forecast.Compute(graph);
+}
+
+TEST(HazardForecast_DijkstraAvoidsDoomedLanes) {
+    StarGraph graph;
+    HazardForecast forecast;
+    int ids[4];
+    buildForecastScene(graph, forecast, ids);
+    
+    //B поглощается при |y - (-200)| <= 50 + 30, ребро A->B - от касания конца B
+    ASSERT_EQUAL(forecast.GetThreatenedPlanetCount(), 1);
+    ASSERT_TRUE(std::fabs(forecast.GetPlanetDoomTime(ids[1]) - 32.0) < 1e-9);
+    ASSERT_TRUE(std::fabs(forecast.GetLaneDoomTime(ids[0], ids[1]) - 35.0) < 1e-9);
+    ASSERT_TRUE(std::isinf(forecast.GetPlanetDoomTime(ids[2])));
+    ASSERT_TRUE(forecast.GetLaneWindows(ids[0], ids[2]).empty());
+    
+    Dijkstra dijkstra(graph);
+    
+    //быстрый торговец успевает пройти через B
+    DijkstraResult fast = dijkstra.FindShortestPath(ids[0], ids[3], forecast,
+        HazardPolicy(HazardPolicy::Avoid, 10.0));
+    ASSERT_TRUE(fast.pathExists);
+    ASSERT_EQUAL(fast.path.Get(1), ids[1]);
+    ASSERT_TRUE(std::fabs(fast.arrivalTime - 20.0) < 1e-9);
+    
+    //медленный прибудет к B после поглощения - обход через C
+    DijkstraResult slow = dijkstra.FindShortestPath(ids[0], ids[3], forecast,
+        HazardPolicy(HazardPolicy::Avoid, 2.0));
+    ASSERT_TRUE(slow.pathExists);
+    ASSERT_EQUAL(slow.path.Get(1), ids[2]);
+    ASSERT_TRUE(std::fabs(slow.totalCost - 300.0) < 1e-9);
+    ASSERT_TRUE(std::fabs(slow.arrivalTime - 150.0) < 1e-9);
+    
+    //малый штраф не перевешивает обход, стоимость в результате - без штрафа
+    DijkstraResult penalized = dijkstra.FindShortestPath(ids[0], ids[3], forecast,
+        HazardPolicy(HazardPolicy::Penalize, 2.0, 50.0));
+    ASSERT_EQUAL(penalized.path.Get(1), ids[1]);
+    ASSERT_TRUE(std::fabs(penalized.totalCost - 200.0) < 1e-9);
+    
+    ASSERT_THROWS(HazardPolicy(HazardPolicy::Avoid, 0.0));
+}
+
+//===========================================
+// тесты маршрутов во времени
+//===========================================
+
+TEST(TimeProfile_PiecewiseTravelTimeAndClosures) {
+    TimeProfile constant;
+    ASSERT_TRUE(constant.TravelTime(3.0, 7.0) == 7.0);
+    ASSERT_TRUE(constant.EarliestArrival(3.0, 7.0) == 10.0);
+    
+    TimeProfile profile;
+    profile.AddPoint(10, 20);
+    profile.AddPoint(0, 10);
+    ASSERT_TRUE(std::fabs(profile.TravelTime(5, 99) - 15.0) < 1e-9);
+    ASSERT_TRUE(profile.TravelTime(-5, 99) == 10.0);
+    ASSERT_TRUE(profile.TravelTime(50, 99) == 20.0);
+    
+    //пересекающиеся закрытия сливаются, границы открыты
+    profile.AddClosure(2, 6);
+    profile.AddClosure(5, 8);
+    ASSERT_TRUE(profile.IsOpen(2));
+    ASSERT_FALSE(profile.IsOpen(3));
+    ASSERT_TRUE(profile.IsOpen(8));
+    
+    double departure = 0;
+    ASSERT_TRUE(std::fabs(profile.EarliestArrival(3, 99, &departure) - 26.0) < 1e-9);
+    ASSERT_TRUE(departure == 8.0);
+    
+    //быстрый перелёт позже выгоднее раннего отправления - ожидание
+    TimeProfile rush;
+    rush.AddPoint(0, 100);
+    rush.AddPoint(10, 5);
+    ASSERT_TRUE(std::fabs(rush.EarliestArrival(0, 1, &departure) - 15.0) < 1e-9);
+    ASSERT_TRUE(departure == 10.0);
+    
+    TimeProfile closed;
+    closed.AddClosure(0, TimeProfile::NEVER);
+    ASSERT_TRUE(std::isinf(closed.EarliestArrival(1, 1)));
+    ASSERT_THROWS(closed.AddClosure(5, 5));
+}
+
+TEST(TimeDependentRouter_WaitsOrDetours) {
+    StarGraph graph;
+    int a = graph.AddVertex("A");
+    int b = graph.AddVertex("B");
+    int c = graph.AddVertex("C");
+    int d = graph.AddVertex("D");
+    graph.AddEdge(a, b, EdgeData(10.0, 0.0));
+    graph.AddEdge(b, d, EdgeData(10.0, 0.0));
+    graph.AddEdge(a, c, EdgeData(30.0, 0.0));
+    graph.AddEdge(c, d, EdgeData(30.0, 0.0));
+    
+    //без расписаний - обычные кратчайшие расстояния, сдвинутые на момент отправления
+    TimeDependentRouter router(graph);
+    auto arrivals = router.FindAllEarliestArrivals(a, 5.0);
+    ASSERT_TRUE(arrivals[d] == 25.0);
+    ASSERT_TRUE(arrivals[c] == 35.0);
+    
+    //B -> D закрыто надолго - обход через C
+    auto longClosure = std::make_shared<TimeProfile>();
+    longClosure->AddClosure(0, 100);
+    graph.SetEdgeProfile(b, d, longClosure);
+    TimeDependentResult detour = router.FindEarliestArrival(a, d, 0.0);
+    ASSERT_TRUE(detour.pathExists);
+    ASSERT_EQUAL(detour.path.Get(1), c);
+    ASSERT_TRUE(detour.arrivalTime == 60.0);
+    
+    //короткое закрытие выгоднее переждать на B
+    auto shortClosure = std::make_shared<TimeProfile>();
+    shortClosure->AddClosure(0, 25);
+    graph.SetEdgeProfile(b, d, shortClosure);
+    TimeDependentResult wait = router.FindEarliestArrival("A", "D", 0.0);
+    ASSERT_EQUAL(wait.path.Get(1), b);
+    ASSERT_TRUE(wait.departures.Get(0) == 0.0);
+    ASSERT_TRUE(wait.departures.Get(1) == 25.0);
+    ASSERT_TRUE(wait.arrivalTime == 35.0);
+    
+    ASSERT_THROWS(graph.SetEdgeProfile(d, a, nullptr));
+    ASSERT_THROWS(TimeDependentRouter(graph, 0.0));
+}
+
+//===========================================
+// тесты фронта Парето
+//===========================================
+
+TEST(ParetoRouter_ReturnsNonDominatedRoutes) {
+    StarGraph graph;
+    int a = graph.AddVertex("A");
+    int b = graph.AddVertex("B");
+    int c = graph.AddVertex("C");
+    int d = graph.AddVertex("D");
+    int e = graph.AddVertex("E");
+    int f = graph.AddVertex("F");
+    graph.AddEdge(a, b, EdgeData(10.0, 0.5));   //короткий и опасный
+    graph.AddEdge(b, d, EdgeData(10.0, 0.5));
+    graph.AddEdge(a, c, EdgeData(15.0, 0.1));   //компромисс
+    graph.AddEdge(c, d, EdgeData(15.0, 0.1));
+    graph.AddEdge(a, e, EdgeData(40.0, 0.0));   //длинный и безопасный
+    graph.AddEdge(e, d, EdgeData(40.0, 0.0));
+    graph.AddEdge(a, f, EdgeData(50.0, 0.2));   //хуже компромисса по обоим критериям
+    graph.AddEdge(f, d, EdgeData(50.0, 0.2));
+    graph.AddEdge(a, d, EdgeData(25.0, 0.9));   //хуже короткого
+    graph.AddEdge(d, a, EdgeData(1.0, 0.0));    //цикл не порождает новых маршрутов
+    
+    ParetoRouter router(graph);
+    std::vector<ParetoRoute> front = router.FindParetoFront(a, d);
+    ASSERT_EQUAL(static_cast<int>(front.size()), 3);
+    ASSERT_EQUAL(front[0].path.Get(1), b);
+    ASSERT_EQUAL(front[1].path.Get(1), c);
+    ASSERT_EQUAL(front[2].path.Get(1), e);
+    ASSERT_TRUE(front[0].distance == 20.0 && front[2].distance == 80.0);
+    ASSERT_TRUE(std::fabs(front[0].encounterProbability - 0.75) < 1e-9);
+    ASSERT_TRUE(std::fabs(front[1].encounterProbability - 0.19) < 1e-9);
+    ASSERT_TRUE(front[2].riskWeight == 0.0);
+    ASSERT_EQUAL(front[2].pathNames.Get(2), std::string("D"));
+    
+    //прореживание сохраняет крайние маршруты
+    ParetoRouter::Settings settings;
+    settings.maxRoutes = 2;
+    std::vector<ParetoRoute> thinned = ParetoRouter(graph, settings).FindParetoFront("A", "D");
+    ASSERT_EQUAL(static_cast<int>(thinned.size()), 2);
+    ASSERT_EQUAL(thinned[0].path.Get(1), b);
+    ASSERT_EQUAL(thinned[1].path.Get(1), e);
+    
+    ASSERT_TRUE(router.FindParetoFront("A", "Нет").empty());
+}
+
+//===========================================
+// тесты маршрута выживания
+//===========================================
+
+TEST(Dijkstra_SafestPathMaximizesSurvival) {
+    StarGraph graph;
+    int a = graph.AddVertex("A");
+    int b = graph.AddVertex("B");
+    int c = graph.AddVertex("C");
+    int d = graph.AddVertex("D");
+    int e = graph.AddVertex("E");
+    graph.AddEdge(a, b, EdgeData(10.0, 0.5));    //дёшево по стоимости, выживание 0.25
+    graph.AddEdge(b, d, EdgeData(10.0, 0.5));
+    graph.AddEdge(a, c, EdgeData(100.0, 0.1));   //выживание 0.81
+    graph.AddEdge(c, d, EdgeData(100.0, 0.1));
+    graph.AddEdge(a, e, EdgeData(300.0, 0.0));   //без пиратов
+    graph.AddEdge(e, d, EdgeData(300.0, 0.0));
+    
+    ASSERT_TRUE(std::fabs(EdgeData(10.0, 0.5).survivalCost - std::log(2.0)) < 1e-12);
+    ASSERT_TRUE(std::isfinite(EdgeData(10.0, 1.0).survivalCost));
+    
+    Dijkstra dijkstra(graph);
+    DijkstraResult cheapest = dijkstra.FindShortestPath(a, d);
+    ASSERT_EQUAL(cheapest.path.Get(1), b);
+    ASSERT_TRUE(std::fabs(cheapest.survivalProbability - 0.25) < 1e-9);
+    
+    DijkstraResult safest = dijkstra.FindSafestPath(a, d);
+    ASSERT_EQUAL(safest.path.Get(1), e);
+    ASSERT_TRUE(std::fabs(safest.survivalProbability - 1.0) < 1e-12);
+    ASSERT_TRUE(safest.totalDistance == 600.0 && safest.totalCost == 600.0);
+    
+    //бюджет расстояния: самый безопасный из укладывающихся
+    DijkstraResult budgeted = dijkstra.FindSafestPath(a, d, 250.0);
+    ASSERT_TRUE(budgeted.pathExists);
+    ASSERT_EQUAL(budgeted.path.Get(1), c);
+    ASSERT_TRUE(std::fabs(budgeted.survivalProbability - 0.81) < 1e-9);
+    ASSERT_TRUE(std::fabs(budgeted.totalCost - 220.0) < 1e-9);
+    
+    ASSERT_FALSE(dijkstra.FindSafestPath(a, d, 10.0).pathExists);
+    ASSERT_EQUAL(dijkstra.FindSafestPath(a, d, 1000.0).path.Get(1), e);
+}
+
+TEST(Dijkstra_SafestPathWithinBudgetKeepsItsLanes) {
+    GameSimulation game;
+    StarGraph& graph = game.getGraph();
+    int a = graph.AddVertex("A");
+    int b = graph.AddVertex("B");
+    graph.AddEdge(a, b, EdgeData(1.0, 0.5));      //укладывается в бюджет
+    graph.AddEdge(a, b, EdgeData(100.0, 0.0));    //параллельный безопасный, но слишком длинный
+    
+    //итоги и переходы - по ребру, которое уложилось в бюджет, а не по самому безопасному
+    DijkstraResult budgeted = Dijkstra(graph).FindSafestPath(a, b, 10.0);
+    ASSERT_TRUE(budgeted.pathExists);
+    ASSERT_EQUAL(budgeted.lanes.GetSize(), 1);
+    ASSERT_EQUAL(budgeted.lanes[0], 0);
+    ASSERT_TRUE(budgeted.totalDistance == 1.0);
+    ASSERT_TRUE(std::fabs(budgeted.survivalProbability - 0.5) < 1e-9);
+    
+    //полёт по переходам результата встречает пиратов примерно в половине рейсов
+    int attacks = 0;
+    auto resolver = [&attacks](int, int, double) { attacks++; return true; };
+    for (int i = 0; i < 200; i++) {
+        ASSERT_TRUE(game.travelRoute(budgeted.path, budgeted.lanes, budgeted.totalCost, resolver));
+    }
+    ASSERT_TRUE(attacks > 50 && attacks < 150);
+}
+
+//===========================================
+// тесты K кратчайших маршрутов
+//===========================================
+
+//перебор всех простых путей для сверки
+static void collectSimplePaths(const StarGraph& graph, int current, int end, std::vector<int>& path,
+                               double cost, std::vector<double>& costs) {
+    if (current == end) {
+        costs.push_back(cost);
+        return;
+    }
+    const DynamicArray<Edge>& edges = graph.GetEdges(current);
+    for (int i = 0; i < edges.GetSize(); i++) {
+        if (std::find(path.begin(), path.end(), edges[i].to) != path.end()) {
+            continue;
+        }
+        path.push_back(edges[i].to);
+        collectSimplePaths(graph, edges[i].to, end, path, cost + edges[i].data.getTotalCost(), costs);
+        path.pop_back();
+    }
+}
+
+TEST(KShortestPaths_MatchesBruteForceAndIsLoopless) {
+    //решётка 3x3 с рёбрами в обе стороны и парой диагоналей
+    StarGraph graph;
+    int ids[9];
+    for (int i = 0; i < 9; i++) {
+        ids[i] = graph.AddVertex("P" + std::to_string(i));
+    }
+    for (int row = 0; row < 3; row++) {
+        for (int col = 0; col < 3; col++) {
+            int v = row * 3 + col;
+            if (col < 2) {
+                graph.AddEdge(ids[v], ids[v + 1], EdgeData(10.0 + v, 0.0));
+                graph.AddEdge(ids[v + 1], ids[v], EdgeData(12.0 + v, 0.0));
+            }
+            if (row < 2) {
+                graph.AddEdge(ids[v], ids[v + 3], EdgeData(11.0 + 2 * v, 0.0));
+                graph.AddEdge(ids[v + 3], ids[v], EdgeData(9.0 + v, 0.0));
+            }
+        }
+    }
+    graph.AddEdge(ids[0], ids[4], EdgeData(19.0, 0.0));
+    graph.AddEdge(ids[4], ids[8], EdgeData(25.0, 0.0));
+    
+    std::vector<int> prefix{ids[0]};
+    std::vector<double> expected;
+    collectSimplePaths(graph, ids[0], ids[8], prefix, 0.0, expected);
+    std::sort(expected.begin(), expected.end());
+    
+    KShortestPaths::Settings settings;
+    settings.k = 10;
+    KShortestPaths yen(graph, settings);
+    std::vector<DijkstraResult> routes = yen.FindPaths(ids[0], ids[8]);
+    
+    ASSERT_EQUAL(static_cast<int>(routes.size()), 10);
+    for (int i = 0; i < 10; i++) {
+        ASSERT_TRUE(std::fabs(routes[i].totalCost - expected[i]) < 1e-9);
+        ASSERT_EQUAL(routes[i].path.Get(0), ids[0]);
+        ASSERT_EQUAL(routes[i].path.Get(routes[i].path.GetSize() - 1), ids[8]);
+        
+        std::vector<int> vertices;
+        for (int j = 0; j < routes[i].path.GetSize(); j++) {
+            vertices.push_back(routes[i].path.Get(j));
+        }
+        std::sort(vertices.begin(), vertices.end());
+        ASSERT_TRUE(std::adjacent_find(vertices.begin(), vertices.end()) == vertices.end());
+        for (int j = 0; j < i; j++) {
+            ASSERT_TRUE(KShortestPaths::SharedLaneFraction(routes[i].path, routes[j].path) < 1.0);
+        }
+    }
+    
+    //большинство ответвлений берутся из обратного дерева без поиска
+    ASSERT_TRUE(yen.GetLastSearchCount() < 40);
+    ASSERT_TRUE(yen.FindPaths(ids[8], ids[8]).size() == 1);
+    ASSERT_TRUE(yen.FindPaths("P0", "Нет такой").empty());
+}
+
+TEST(KShortestPaths_DiversityFilterSkipsNearDuplicates) {
+    //a - b - c - d - e и два почти одинаковых объезда, плюс отдельный путь через f
+    StarGraph graph;
+    int a = graph.AddVertex("A");
+    int b = graph.AddVertex("B");
+    int c = graph.AddVertex("C");
+    int d = graph.AddVertex("D");
+    int e = graph.AddVertex("E");
+    int f = graph.AddVertex("F");
+    graph.AddEdge(a, b, EdgeData(10.0, 0.0));
+    graph.AddEdge(b, c, EdgeData(10.0, 0.0));
+    graph.AddEdge(c, d, EdgeData(10.0, 0.0));
+    graph.AddEdge(d, e, EdgeData(10.0, 0.0));
+    graph.AddEdge(c, e, EdgeData(21.0, 0.0));
+    graph.AddEdge(a, f, EdgeData(30.0, 0.0));
+    graph.AddEdge(f, e, EdgeData(30.0, 0.0));
+    
+    KShortestPaths::Settings plain;
+    plain.k = 2;
+    std::vector<DijkstraResult> nearest = KShortestPaths(graph, plain).FindPaths(a, e);
+    ASSERT_EQUAL(static_cast<int>(nearest.size()), 2);
+    ASSERT_TRUE(nearest[0].totalCost == 40.0 && nearest[1].totalCost == 41.0);
+    
+    KShortestPaths::Settings diverse;
+    diverse.k = 2;
+    diverse.maxSharedFraction = 0.5;
+    std::vector<DijkstraResult> routes = KShortestPaths(graph, diverse).FindPaths(a, e);
+    ASSERT_EQUAL(static_cast<int>(routes.size()), 2);
+    ASSERT_EQUAL(routes[1].path.Get(1), f);
+    ASSERT_TRUE(routes[1].totalCost == 60.0);
+    
+    plain.k = 0;
+    ASSERT_THROWS(KShortestPaths(graph, plain).GetLastSearchCount());
+}
+
+//===========================================
+// тесты маршрутов с ограничением ресурса
+//===========================================
+
+//все простые пути: (стоимость, сумма -log(1 - risk), число переходов)
+struct BruteRoute {
+    double cost;
+    double survivalCost;
+    int jumps;
+};
+
+static void collectRoutes(const StarGraph& graph, int current, int end, std::vector<int>& path,
+                          BruteRoute route, std::vector<BruteRoute>& routes) {
+    if (current == end) {
+        routes.push_back(route);
+        return;
+    }
+    const DynamicArray<Edge>& edges = graph.GetEdges(current);
+    for (int i = 0; i < edges.GetSize(); i++) {
+        if (std::find(path.begin(), path.end(), edges[i].to) != path.end()) {
+            continue;
+        }
+        path.push_back(edges[i].to);
+        collectRoutes(graph, edges[i].to, end, path,
+                      BruteRoute{route.cost + edges[i].data.getTotalCost(),
+                                 route.survivalCost + edges[i].data.survivalCost, route.jumps + 1}, routes);
+        path.pop_back();
+    }
+}
+
+static StarGraph riskyGrid(int* ids) {
+    StarGraph graph;
+    for (int i = 0; i < 9; i++) {
+        ids[i] = graph.AddVertex("R" + std::to_string(i));
+    }
+    for (int row = 0; row < 3; row++) {
+        for (int col = 0; col < 3; col++) {
+            int v = row * 3 + col;
+            if (col < 2) {
+                graph.AddEdge(ids[v], ids[v + 1], EdgeData(10.0 + v, 0.05 * (v % 4)));
+                graph.AddEdge(ids[v + 1], ids[v], EdgeData(12.0, 0.1));
+            }
+            if (row < 2) {
+                graph.AddEdge(ids[v], ids[v + 3], EdgeData(11.0 + v, 0.3 - 0.03 * v));
+            }
+        }
+    }
+    //короткая опасная диагональ и параллельный ей безопасный, но дорогой переход
+    graph.AddEdge(ids[0], ids[8], EdgeData(30.0, 0.5));
+    graph.AddEdge(ids[0], ids[8], EdgeData(80.0, 0.0));
+    return graph;
+}
+
+TEST(ConstrainedRouter_RiskBudgetMatchesBruteForce) {
+    int ids[9];
+    StarGraph graph = riskyGrid(ids);
+    
+    std::vector<int> prefix{ids[0]};
+    std::vector<BruteRoute> routes;
+    collectRoutes(graph, ids[0], ids[8], prefix, BruteRoute{0.0, 0.0, 0}, routes);
+    
+    ConstrainedRouter router(graph);
+    for (double budget : {0.0, 0.1, 0.25, 0.4, 0.6, 1.0}) {
+        double best = std::numeric_limits<double>::infinity();
+        for (const BruteRoute& route : routes) {
+            if (-std::expm1(-route.survivalCost) <= budget + 1e-12) {
+                best = std::min(best, route.cost);
+            }
+        }
+        
+        ConstrainedResult result = router.FindCheapestWithinRisk(ids[0], ids[8], budget);
+        ASSERT_TRUE(result.route.pathExists);
+        ASSERT_TRUE(std::fabs(result.route.totalCost - best) < 1e-9);
+        ASSERT_TRUE(result.consumed <= budget + 1e-12);
+        ASSERT_TRUE(std::fabs(result.consumed - (1.0 - result.route.survivalProbability)) < 1e-12);
+    }
+    
+    //без риска остаётся только безопасный параллельный переход
+    ConstrainedResult safe = router.FindCheapestWithinRisk(ids[0], ids[8], 0.0);
+    ASSERT_EQUAL(safe.route.path.GetSize(), 2);
+    ASSERT_TRUE(safe.route.totalCost == 80.0 && safe.consumed == 0.0);
+    
+    ASSERT_THROWS(router.FindCheapestWithinRisk(ids[0], ids[8], 1.5));
+}
+
+TEST(ConstrainedRouter_JumpLimitMatchesBruteForce) {
+    int ids[9];
+    StarGraph graph = riskyGrid(ids);
+    graph.RemoveEdge(ids[0], ids[8]);
+    
+    std::vector<int> prefix{ids[0]};
+    std::vector<BruteRoute> routes;
+    collectRoutes(graph, ids[0], ids[8], prefix, BruteRoute{0.0, 0.0, 0}, routes);
+    
+    ConstrainedRouter router(graph);
+    ASSERT_FALSE(router.FindShortestWithinJumps(ids[0], ids[8], 3).route.pathExists);
+    for (int jumps = 4; jumps <= 8; jumps++) {
+        double best = std::numeric_limits<double>::infinity();
+        for (const BruteRoute& route : routes) {
+            if (route.jumps <= jumps) {
+                best = std::min(best, route.cost);
+            }
+        }
+        
+        ConstrainedResult result = router.FindShortestWithinJumps(ids[0], ids[8], jumps);
+        ASSERT_TRUE(result.route.pathExists);
+        ASSERT_TRUE(std::fabs(result.route.totalCost - best) < 1e-9);
+        ASSERT_TRUE(result.consumed <= jumps);
+        ASSERT_EQUAL(static_cast<int>(result.consumed), result.route.path.GetSize() - 1);
+    }
+    ASSERT_TRUE(router.GetLastLabelCount() > 0);
+}
+
+//===========================================
+// тесты планировщика обхода
+//===========================================
+
+TEST(TourPlanner_MatchesBruteForceOrder) {
+    //кольцо из 12 планет с хордами; туда и обратно стоимость разная
+    StarGraph graph;
+    int ids[12];
+    for (int i = 0; i < 12; i++) {
+        ids[i] = graph.AddVertex("T" + std::to_string(i));
+    }
+    for (int i = 0; i < 12; i++) {
+        graph.AddEdge(ids[i], ids[(i + 1) % 12], EdgeData(10.0 + (i * 7) % 5, 0.0));
+        graph.AddEdge(ids[(i + 1) % 12], ids[i], EdgeData(14.0 + (i * 3) % 4, 0.0));
+    }
+    graph.AddEdge(ids[0], ids[6], EdgeData(25.0, 0.0));
+    graph.AddEdge(ids[6], ids[0], EdgeData(40.0, 0.0));
+    graph.AddEdge(ids[3], ids[9], EdgeData(22.0, 0.0));
+    
+    std::vector<int> targets{ids[2], ids[5], ids[7], ids[9], ids[10], ids[4], ids[2]};
+    Dijkstra dijkstra(graph);
+    
+    for (bool cycle : {false, true}) {
+        //полный перебор порядков по попарным кратчайшим путям
+        std::vector<int> order{ids[2], ids[4], ids[5], ids[7], ids[9], ids[10]};
+        double best = std::numeric_limits<double>::infinity();
+        do {
+            double cost = dijkstra.FindShortestPath(ids[0], order[0]).totalCost;
+            for (size_t i = 0; i + 1 < order.size(); i++) {
+                cost += dijkstra.FindShortestPath(order[i], order[i + 1]).totalCost;
+            }
+            if (cycle) {
+                cost += dijkstra.FindShortestPath(order.back(), ids[0]).totalCost;
+            }
+            best = std::min(best, cost);
+        } while (std::next_permutation(order.begin(), order.end()));
+        
+        TourPlanner::Settings settings;
+        settings.returnToStart = cycle;
+        TourPlan plan = TourPlanner(graph, settings).PlanTour(ids[0], targets);
+        
+        ASSERT_TRUE(plan.feasible);
+        ASSERT_FALSE(plan.timedOut);
+        ASSERT_EQUAL(static_cast<int>(plan.order.size()), 6);
+        ASSERT_TRUE(std::fabs(plan.totalCost - best) < 1e-9);
+        
+        //маршрут связный, начинается на старте и проходит цели в порядке order
+        ASSERT_EQUAL(plan.path.Get(0), ids[0]);
+        ASSERT_EQUAL(plan.path.Get(plan.path.GetSize() - 1), cycle ? ids[0] : plan.order.back());
+        double pathCost = 0.0;
+        size_t nextTarget = 0;
+        for (int i = 0; i + 1 < plan.path.GetSize(); i++) {
+            pathCost += dijkstra.FindShortestPath(plan.path.Get(i), plan.path.Get(i + 1)).totalCost;
+            if (nextTarget < plan.order.size() && plan.path.Get(i + 1) == plan.order[nextTarget]) {
+                nextTarget++;
+            }
+        }
+        ASSERT_EQUAL(static_cast<int>(nextTarget), 6);
+        ASSERT_TRUE(std::fabs(pathCost - best) < 1e-9);
+    }
+}
+
+TEST(TourPlanner_SkipsUnreachableAndHandlesLargeSets) {
+    StarGraph graph;
+    int start = graph.AddVertex("Старт");
+    int island = graph.AddVertex("Остров");
+    int near = graph.AddVertex("Рядом");
+    graph.AddEdge(start, near, EdgeData(5.0, 0.0));
+    graph.AddEdge(island, start, EdgeData(5.0, 0.0));
+    
+    TourPlan small = TourPlanner(graph).PlanTour(start, {island, near, start});
+    ASSERT_TRUE(small.feasible);
+    ASSERT_EQUAL(static_cast<int>(small.order.size()), 1);
+    ASSERT_EQUAL(static_cast<int>(small.unreachable.size()), 1);
+    ASSERT_EQUAL(small.unreachable[0], island);
+    ASSERT_TRUE(small.totalCost == 5.0);
+    
+    //решётка 40 x 40, 300 целей: матрица и локальный поиск укладываются в лимит
+    StarGraph grid;
+    std::vector<int> cells;
+    for (int i = 0; i < 1600; i++) {
+        cells.push_back(grid.AddVertex("G" + std::to_string(i)));
+    }
+    for (int row = 0; row < 40; row++) {
+        for (int col = 0; col < 40; col++) {
+            int v = row * 40 + col;
+            if (col < 39) {
+                grid.AddEdge(cells[v], cells[v + 1], EdgeData(10.0, 0.0));
+                grid.AddEdge(cells[v + 1], cells[v], EdgeData(10.0, 0.0));
+            }
+            if (row < 39) {
+                grid.AddEdge(cells[v], cells[v + 40], EdgeData(10.0, 0.0));
+                grid.AddEdge(cells[v + 40], cells[v], EdgeData(10.0, 0.0));
+            }
+        }
+    }
+    std::vector<int> targets;
+    for (int i = 0; i < 300; i++) {
+        targets.push_back(cells[(i * 797 + 13) % 1600]);
+    }
+    
+    TourPlanner::Settings settings;
+    settings.timeBudgetMs = 900.0;
+    auto begin = std::chrono::steady_clock::now();
+    TourPlan plan = TourPlanner(grid, settings).PlanTour(cells[(300 * 797 + 13) % 1600], targets);
+    double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+    
+    ASSERT_TRUE(plan.feasible);
+    ASSERT_EQUAL(static_cast<int>(plan.order.size()), 300);
+    ASSERT_TRUE(elapsed < 1000.0);
+    //каждая цель стоит хотя бы шаг решётки; обход не хуже змейки по всей решётке
+    ASSERT_TRUE(plan.totalCost >= 300 * 10.0);
+    ASSERT_TRUE(plan.totalCost <= 40 * 40 * 10.0);
+}
+
+//===========================================
+// тесты симуляции риска маршрута
+//===========================================
+
+TEST(PirateModel_TypesAndVictoryOdds) {
+    ASSERT_TRUE(PirateModel::determinePirateType(0.1) == PirateType::ROOKIE);
+    ASSERT_TRUE(PirateModel::determinePirateType(0.25) == PirateType::VETERAN);
+    ASSERT_TRUE(PirateModel::determinePirateType(0.4) == PirateType::VETERAN);
+    ASSERT_TRUE(PirateModel::determinePirateType(0.41) == PirateType::BOSS);
+    ASSERT_EQUAL(PirateModel::profile(PirateType::BOSS).requiredClicks, 15);
+    
+    //новички побеждаются почти всегда, босс - редко; меткость помогает
+    double rookie = PirateModel::victoryProbability(PirateType::ROOKIE, 3.0);
+    double veteran = PirateModel::victoryProbability(PirateType::VETERAN, 3.0);
+    double boss = PirateModel::victoryProbability(PirateType::BOSS, 3.0);
+    ASSERT_TRUE(rookie > veteran && veteran > boss);
+    ASSERT_TRUE(rookie > 0.99 && boss > 0.1 && boss < 0.5);
+    ASSERT_TRUE(PirateModel::victoryProbability(PirateType::BOSS, 6.0) > boss);
+    ASSERT_TRUE(PirateModel::victoryProbability(PirateType::ROOKIE, 0.0) == 0.0);
+}
+
+TEST(RouteRiskSimulator_MatchesExactAndIgnoresThreadCount) {
+    std::vector<double> risks{0.1, 0.3, 0.5, 0.2, 0.45};
+    
+    RouteRiskSimulator::Settings settings;
+    settings.voyages = 200000;
+    settings.threadCount = 1;
+    RouteRiskReport single = RouteRiskSimulator(settings).simulate(risks);
+    settings.threadCount = 3;
+    RouteRiskSimulator simulator(settings);
+    RouteRiskReport parallel = simulator.simulate(risks);
+    
+    //счётчиковые случайные числа: итог не зависит от разбиения рейсов по потокам
+    ASSERT_EQUAL(single.survived, parallel.survived);
+    ASSERT_TRUE(single.encounterHistogram == parallel.encounterHistogram);
+    ASSERT_TRUE(single.expectedLoss == parallel.expectedLoss);
+    
+    double exact = simulator.exactSurvival(risks);
+    ASSERT_TRUE(std::fabs(parallel.survivalProbability - exact) < 5.0 * parallel.survivalStdError);
+    
+    double destroyed = 0.0;
+    for (double probability : parallel.destroyedAtLane) {
+        destroyed += probability;
+    }
+    ASSERT_TRUE(std::fabs(destroyed + parallel.survivalProbability - 1.0) < 1e-9);
+    ASSERT_TRUE(parallel.lossMedian <= parallel.lossP90 && parallel.lossP90 <= parallel.lossP99);
+    ASSERT_TRUE(parallel.lossP99 >= settings.cargoValue);
+    
+    //другой посев - другая выборка
+    settings.seed = 7;
+    ASSERT_TRUE(RouteRiskSimulator(settings).simulate(risks).survived != parallel.survived);
+    
+    //маршрут без риска по графу
+    StarGraph graph;
+    int a = graph.AddVertex("A");
+    int b = graph.AddVertex("B");
+    graph.AddEdge(a, b, EdgeData(10.0, 0.0));
+    DynamicArray<int> path;
+    path.Append(a);
+    path.Append(b);
+    RouteRiskReport calm = simulator.simulate(graph, path);
+    ASSERT_TRUE(calm.survivalProbability == 1.0 && calm.expectedLoss == 0.0);
+    ASSERT_EQUAL(calm.encounterHistogram[0], settings.voyages);
+    
+    //параллельный опасный переход: выбирается по метрике маршрута, как в описании пути и полёте
+    graph.AddEdge(a, b, EdgeData(1.0, 0.9));
+    ASSERT_TRUE(simulator.simulate(graph, path, RouteMetric::Survival).survivalProbability == 1.0);
+    ASSERT_TRUE(RouteRiskSimulator::laneRisks(graph, path, RouteMetric::Cost)[0] == 0.9);
+}
+
+//===========================================
+// тесты безоконной игры
+//===========================================
+
+//партия автопилотом на решётке 6x6: торговец летит кратчайшим путём к артефакту,
+//между рейсами мир живёт 10 секунд (черные дыры появляются раз в spawnPeriod)
+static std::vector<GameEvent> playHeadlessGame(uint64_t seed, double risk, double spawnPeriod,
+                                               GameSimulation::State& finalState, int& collected) {
+    GameSimulation::Settings settings;
+    settings.seed = seed;
+    settings.blackHoleSpawnPeriod = spawnPeriod;
+    GameSimulation game(settings);
+    StarGraph& graph = game.getGraph();
+    
+    const int side = 6;
+    std::vector<int> ids;
+    for (int row = 0; row < side; row++) {
+        for (int column = 0; column < side; column++) {
+            ids.push_back(graph.AddVertex("P" + std::to_string(row * side + column)));
+            game.setPlanetPosition(ids.back(), column * 150.0, row * 150.0);
+        }
+    }
+    for (int row = 0; row < side; row++) {
+        for (int column = 0; column < side; column++) {
+            int planet = ids[row * side + column];
+            if (column + 1 < side) {
+                graph.AddEdge(planet, ids[row * side + column + 1], EdgeData(150.0, risk));
+                graph.AddEdge(ids[row * side + column + 1], planet, EdgeData(150.0, risk));
+            }
+            if (row + 1 < side) {
+                graph.AddEdge(planet, ids[(row + 1) * side + column], EdgeData(150.0, risk));
+                graph.AddEdge(ids[(row + 1) * side + column], planet, EdgeData(150.0, risk));
+            }
+        }
+    }
+    
+    game.placeTraderIfNeeded();
+    game.checkGameStart();
+    std::vector<GameEvent> events = game.takeEvents();
+    
+    for (int turn = 0; turn < 200 && game.getState() == GameSimulation::State::Running; turn++) {
+        int artifact = -1;
+        for (int planet : graph.Vertices()) {
+            if (graph.HasArtifact(planet)) {
+                artifact = planet;
+            }
+        }
+        if (artifact != -1) {
+            DijkstraResult route = Dijkstra(graph).FindShortestPath(game.getTrader().getCurrentPlanetId(), artifact);
+            if (route.pathExists) {
+                game.travelRoute(route.path, route.totalCost);
+            }
+        }
+        for (int tick = 0; tick < 10 && game.getState() == GameSimulation::State::Running; tick++) {
+            game.step(1.0);
+        }
+        
+        std::vector<GameEvent> turnEvents = game.takeEvents();
+        events.insert(events.end(), turnEvents.begin(), turnEvents.end());
+    }
+    
+    finalState = game.getState();
+    collected = game.getCollectedArtifacts();
+    return events;
+}
+
+TEST(GameSimulation_HeadlessGamesAreReproducible) {
+    //без пиратов и черных дыр партия всегда выигрывается
+    GameSimulation::State state;
+    int collected = 0;
+    std::vector<GameEvent> calm = playHeadlessGame(1, 0.0, 1e9, state, collected);
+    ASSERT_TRUE(state == GameSimulation::State::Won);
+    ASSERT_EQUAL(collected, 10);
+    ASSERT_TRUE(calm.front().type == GameEvent::TraderLanded);
+    ASSERT_TRUE(calm.back().type == GameEvent::Victory);
+    ASSERT_TRUE(calm.back().value > 0.0);
+    
+    //пакет партий с пиратами и черными дырами: каждая заканчивается, исход зависит только от seed
+    int won = 0, lost = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (uint64_t seed = 1; seed <= 200; seed++) {
+        std::vector<GameEvent> events = playHeadlessGame(seed, 0.3, 20.0, state, collected);
+        ASSERT_TRUE(state == GameSimulation::State::Won || state == GameSimulation::State::Lost);
+        if (state == GameSimulation::State::Won) {
+            won++;
+        } else {
+            lost++;
+            GameEvent::Type last = events.back().type;
+            ASSERT_TRUE(last == GameEvent::DestroyedByPirates || last == GameEvent::DestroyedByBlackHole);
+        }
+        
+        if (seed <= 5) {
+            GameSimulation::State replayState;
+            int replayCollected = 0;
+            std::vector<GameEvent> replay = playHeadlessGame(seed, 0.3, 20.0, replayState, replayCollected);
+            ASSERT_TRUE(replayState == state);
+            ASSERT_EQUAL(replay.size(), events.size());
+            for (size_t i = 0; i < events.size(); i++) {
+                ASSERT_TRUE(replay[i].type == events[i].type && replay[i].planet == events[i].planet);
+            }
+        }
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    ASSERT_TRUE(won > 0 && lost > 0);
+    ASSERT_TRUE(elapsed < 2.0);
+}
+
+TEST(GameSimulation_BlackHolesSwallowPlanetsLanesAndTrader) {
+    GameSimulation::Settings settings;
+    settings.blackHoleSpawnPeriod = 1e9;
+    settings.maxBlackHoles = 2;
+    GameSimulation game(settings);
+    StarGraph& graph = game.getGraph();
+    
+    int a = graph.AddVertex("A");
+    int b = graph.AddVertex("B");
+    int c = graph.AddVertex("C");
+    int d = graph.AddVertex("D");
+    int e = graph.AddVertex("E");
+    game.setPlanetPosition(a, 0.0, 0.0);
+    game.setPlanetPosition(b, 400.0, 0.0);
+    game.setPlanetPosition(c, 200.0, 300.0);
+    game.setPlanetPosition(d, 0.0, 600.0);
+    game.setPlanetPosition(e, 400.0, 600.0);
+    graph.AddEdge(a, b, EdgeData(400.0, 0.0));
+    graph.AddEdge(a, d, EdgeData(600.0, 0.0));
+    graph.AddEdge(d, e, EdgeData(400.0, 0.0));
+    ASSERT_TRUE(game.placeTraderIfNeeded());
+    ASSERT_EQUAL(game.getTrader().getCurrentPlanetId(), a);
+    ASSERT_TRUE(game.checkGameStart());
+    
+    //дыра идёт вправо по y = 300: рвёт переход A -> D и поглощает C
+    ASSERT_TRUE(game.spawnBlackHole(-100.0, 300.0, 20.0, 0.0) >= 0);
+    for (int i = 0; i < 20; i++) {
+        game.step(1.0);
+    }
+    ASSERT_FALSE(graph.HasVertex(c));
+    ASSERT_EQUAL(graph.GetVertexCount(), 4);
+    ASSERT_EQUAL(graph.GetEdges(a).GetSize(), 1);
+    ASSERT_EQUAL(graph.GetEdges(d).GetSize(), 1);
+    
+    bool planetEvent = false, laneEvent = false;
+    for (const GameEvent& event : game.takeEvents()) {
+        planetEvent |= event.type == GameEvent::PlanetSwallowed && event.planetName == "C";
+        laneEvent |= event.type == GameEvent::LaneSwallowed && event.planet == a && event.otherPlanet == d;
+    }
+    ASSERT_TRUE(planetEvent && laneEvent);
+    
+    //предел поля
+    ASSERT_TRUE(game.spawnBlackHole(5000.0, 5000.0, 0.0, 0.0) >= 0);
+    ASSERT_EQUAL(game.spawnBlackHole(6000.0, 6000.0, 0.0, 0.0), -1);
+    
+    //дыра на планете торговца: партия проиграна, карта очищена
+    game.getHazards().clear();
+    game.spawnBlackHole(0.0, 0.0, 1.0, 0.0);
+    game.step(0.1);
+    ASSERT_TRUE(game.getState() == GameSimulation::State::Lost);
+    ASSERT_EQUAL(graph.GetVertexCount(), 0);
+    ASSERT_FALSE(game.getTrader().getIsPlaced());
+    ASSERT_EQUAL(game.getHazards().getActiveCount(), 0);
+    std::vector<GameEvent> events = game.takeEvents();
+    ASSERT_TRUE(events.back().type == GameEvent::DestroyedByBlackHole && events.back().planetName == "A");
+    
+    //новая карта - новая партия
+    for (int i = 0; i < 5; i++) {
+        graph.AddVertex("N" + std::to_string(i));
+    }
+    ASSERT_TRUE(game.checkGameStart());
+    ASSERT_EQUAL(game.getCollectedArtifacts(), 0);
+}
+
+TEST(GameSimulation_IndexFollowsMovesAndRemovals) {
+    GameSimulation::Settings settings;
+    settings.blackHoleSpawnPeriod = 1e9;
+    GameSimulation game(settings);
+    StarGraph& graph = game.getGraph();
+    
+    int a = graph.AddVertex("A");
+    int b = graph.AddVertex("B");
+    int c = graph.AddVertex("C");
+    int d = graph.AddVertex("D");
+    int e = graph.AddVertex("E");
+    game.setPlanetPosition(a, 0.0, 0.0);
+    game.setPlanetPosition(b, 800.0, 0.0);
+    game.setPlanetPosition(c, 800.0, 800.0);
+    game.setPlanetPosition(d, 0.0, 800.0);
+    game.setPlanetPosition(e, -800.0, -800.0);
+    graph.AddEdge(a, b, EdgeData(800.0, 0.0));
+    graph.AddEdge(b, c, EdgeData(800.0, 0.0));
+    ASSERT_TRUE(game.placeTraderIfNeeded());
+    ASSERT_TRUE(game.checkGameStart());
+    
+    //неподвижная дыра в центре: индекс построен, никого не задевает
+    ASSERT_TRUE(game.spawnBlackHole(400.0, 400.0, 0.0, 0.0) >= 0);
+    game.step(0.1);
+    ASSERT_EQUAL(graph.GetVertexCount(), 5);
+    
+    //перемещённая в дыру планета найдена в индексе
+    game.setPlanetPosition(d, 420.0, 400.0);
+    game.step(0.1);
+    ASSERT_FALSE(graph.HasVertex(d));
+    ASSERT_FALSE(game.hasPlanetPosition(d));
+    
+    //артефакт не перестраивает индекс, а сдвиг конца переносит отрезок B -> C через дыру
+    graph.SetArtifact(e, true);
+    game.setPlanetPosition(c, 0.0, 800.0);
+    game.step(0.1);
+    ASSERT_TRUE(graph.HasVertex(c));
+    ASSERT_EQUAL(graph.GetEdges(b).GetSize(), 0);
+    ASSERT_EQUAL(graph.GetEdges(a).GetSize(), 1);
+    
+    //планета, уведённая из дыры до шага, остаётся на карте
+    game.setPlanetPosition(e, 400.0, 400.0);
+    game.setPlanetPosition(e, -800.0, -800.0);
+    game.step(0.1);
+    ASSERT_TRUE(graph.HasVertex(e));
+    ASSERT_EQUAL(graph.GetVertexCount(), 4);
+    ASSERT_TRUE(game.getState() == GameSimulation::State::Running);
+}
+
+//===========================================
+// тесты генератора случайных чисел
+//===========================================
+
+TEST(GameSimulation_TravelUsesLaneOfRouteMetric) {
+    GameSimulation game;
+    StarGraph& graph = game.getGraph();
+    int a = graph.AddVertex("A");
+    int b = graph.AddVertex("B");
+    graph.AddEdge(a, b, EdgeData(10.0, 0.9));     //короткий и опасный
+    graph.AddEdge(a, b, EdgeData(100.0, 0.0));    //параллельный безопасный
+    
+    DynamicArray<int> path;
+    path.Append(a);
+    path.Append(b);
+    Dijkstra dijkstra(graph);
+    ASSERT_TRUE(std::abs(dijkstra.DescribePath(path, RouteMetric::Survival).survivalProbability - 1.0) < 1e-12);
+    ASSERT_TRUE(std::abs(dijkstra.DescribePath(path, RouteMetric::Cost).survivalProbability - 0.1) < 1e-12);
+    
+    //показанная вероятность совпадает с тем, что применяет игра
+    int attacks = 0;
+    auto resolver = [&attacks](int, int, double) { attacks++; return true; };
+    for (int i = 0; i < 200; i++) {
+        ASSERT_TRUE(game.travelRoute(path, 100.0, RouteMetric::Survival, resolver));
+    }
+    ASSERT_EQUAL(attacks, 0);
+    for (int i = 0; i < 200; i++) {
+        ASSERT_TRUE(game.travelRoute(path, 19.0, RouteMetric::Cost, resolver));
+    }
+    ASSERT_TRUE(attacks > 150);
+}
+
+TEST(GameSimulation_TravelFliesParetoRouteLanes) {
+    GameSimulation game;
+    StarGraph& graph = game.getGraph();
+    int a = graph.AddVertex("A");
+    int b = graph.AddVertex("B");
+    graph.AddEdge(a, b, EdgeData(100.0, 0.0));    //длинный безопасный
+    graph.AddEdge(a, b, EdgeData(10.0, 0.9));     //параллельный короткий и опасный
+    
+    //одинаковые планеты, разные переходы - два варианта фронта
+    std::vector<ParetoRoute> front = ParetoRouter(graph).FindParetoFront(a, b);
+    ASSERT_EQUAL(static_cast<int>(front.size()), 2);
+    ASSERT_EQUAL(front[0].lanes.GetSize(), 1);
+    ASSERT_EQUAL(front[0].lanes[0], 1);
+    ASSERT_EQUAL(front[1].lanes[0], 0);
+    ASSERT_TRUE(front[0].distance == 10.0 && front[1].distance == 100.0);
+    
+    //выбранный короткий вариант летит коротким переходом, безопасный - безопасным
+    int attacks = 0;
+    auto resolver = [&attacks](int, int, double) { attacks++; return true; };
+    for (int i = 0; i < 200; i++) {
+        ASSERT_TRUE(game.travelRoute(front[1].path, front[1].lanes, front[1].distance, resolver));
+    }
+    ASSERT_EQUAL(attacks, 0);
+    for (int i = 0; i < 200; i++) {
+        ASSERT_TRUE(game.travelRoute(front[0].path, front[0].lanes, front[0].distance, resolver));
+    }
+    ASSERT_TRUE(attacks > 150);
+    
+    ASSERT_THROWS(game.travelRoute(front[0].path, DynamicArray<int>(), 10.0));
+}
+
+TEST(GameSimulation_TravelStopsWhereRouteWasSwallowed) {
+    GameSimulation game;
+    StarGraph& graph = game.getGraph();
+    int a = graph.AddVertex("A");
+    int b = graph.AddVertex("B");
+    int c = graph.AddVertex("C");
+    int d = graph.AddVertex("D");
+    int e = graph.AddVertex("E");
+    graph.AddEdge(a, b, EdgeData(10.0, 1.0));    //пираты нападают на каждом переходе
+    graph.AddEdge(b, c, EdgeData(10.0, 1.0));
+    graph.AddEdge(c, d, EdgeData(10.0, 1.0));
+    graph.AddEdge(c, e, EdgeData(10.0, 1.0));
+    ASSERT_TRUE(game.placeTraderIfNeeded());
+    game.takeEvents();
+    
+    //во время первой битвы черная дыра рвёт переход C -> D дальше по маршруту
+    int battles = 0;
+    auto swallowAhead = [&](int, int, double) {
+        if (battles++ == 0) {
+            game.swallowLane(c, d);
+        }
+        return true;
+    };
+    DynamicArray<int> path;
+    for (int planet : {a, b, c, d}) {
+        path.Append(planet);
+    }
+    ASSERT_TRUE(game.travelRoute(path, 30.0, RouteMetric::Cost, swallowAhead));
+    ASSERT_EQUAL(battles, 2);
+    ASSERT_EQUAL(game.getTrader().getCurrentPlanetId(), c);
+    ASSERT_EQUAL(game.getTrader().getCompletedRoutes(), 0);
+    std::vector<GameEvent> events = game.takeEvents();
+    ASSERT_TRUE(events.back().type == GameEvent::RouteInterrupted);
+    ASSERT_TRUE(events.back().planet == c && events.back().otherPlanet == d);
+    
+    //цель перехода поглощена во время битвы: торговец остаётся на планете вылета
+    DynamicArray<int> jump;
+    jump.Append(c);
+    jump.Append(e);
+    auto swallowTarget = [&](int, int to, double) { game.swallowPlanet(to); return true; };
+    ASSERT_TRUE(game.travelRoute(jump, 10.0, RouteMetric::Cost, swallowTarget));
+    ASSERT_FALSE(graph.HasVertex(e));
+    ASSERT_EQUAL(game.getTrader().getCurrentPlanetId(), c);
+    ASSERT_TRUE(game.takeEvents().back().type == GameEvent::RouteInterrupted);
+}
+
+TEST(Xoshiro256_ReproducibleBoundedAndJumps) {
+    Xoshiro256 a(2024), b(2024), other(2025);
+    bool differs = false;
+    for (int i = 0; i < 1000; i++) {
+        uint64_t value = a();
+        ASSERT_TRUE(value == b());
+        differs |= value != other();
+    }
+    ASSERT_TRUE(differs);
+    
+    //границы и равномерность NextBelow / NextInt / NextDouble
+    Xoshiro256 random(7);
+    std::vector<int> counts(10, 0);
+    const int samples = 100000;
+    for (int i = 0; i < samples; i++) {
+        counts[random.NextBelow(10)]++;
+        int value = random.NextInt(-3, 3);
+        ASSERT_TRUE(value >= -3 && value <= 3);
+        double unit = random.NextDouble();
+        ASSERT_TRUE(unit >= 0.0 && unit < 1.0);
+    }
+    for (int count : counts) {
+        ASSERT_TRUE(std::abs(count - samples / 10) < 600);   //> 6 сигм
+    }
+    ASSERT_EQUAL(random.NextInt(5, 5), 5);
+    
+    //после Jump поток уходит далеко вперёд: первые значения не совпадают с исходными
+    Xoshiro256 original(99), jumped(99);
+    jumped.Jump();
+    ASSERT_TRUE(original != jumped);
+    std::vector<uint64_t> head;
+    for (int i = 0; i < 1000; i++) {
+        head.push_back(original());
+    }
+    for (int i = 0; i < 1000; i++) {
+        ASSERT_TRUE(std::find(head.begin(), head.end(), jumped()) == head.end());
+    }
+}
+
+TEST(RandomService_NamedAndParallelStreams) {
+    //поток зависит только от (seed, имя), а не от порядка создания
+    RandomService first(5), second(5);
+    Xoshiro256& pirates = first.stream("pirates");
+    first.stream("artifacts")();
+    second.stream("meteors");
+    uint64_t expected = second.stream("pirates")();
+    ASSERT_TRUE(pirates() == expected);
+    ASSERT_TRUE(first.stream("pirates") == second.stream("pirates"));
+    ASSERT_TRUE(RandomService::streamSeed(5, "pirates") != RandomService::streamSeed(5, "artifacts"));
+    ASSERT_TRUE(RandomService::streamSeed(5, "pirates") != RandomService::streamSeed(6, "pirates"));
+    
+    //reseed перезапускает потоки, выданные ссылки остаются действительными
+    first.reseed(5);
+    ASSERT_TRUE(&pirates == &first.stream("pirates"));
+    ASSERT_TRUE(pirates() == expected);
+    
+    //параллельные подпотоки: первый - начало именованного, остальные сдвинуты на 2^128
+    std::vector<Xoshiro256> workers = first.parallelStreams("monteCarlo", 4);
+    ASSERT_EQUAL(workers.size(), 4u);
+    ASSERT_TRUE(workers[0] == Xoshiro256(RandomService::streamSeed(5, "monteCarlo")));
+    for (size_t i = 0; i < workers.size(); i++) {
+        for (size_t j = i + 1; j < workers.size(); j++) {
+            ASSERT_TRUE(workers[i] != workers[j]);
+        }
+    }
+    Xoshiro256 expectedSecond = workers[0];
+    expectedSecond.Jump();
+    ASSERT_TRUE(workers[1] == expectedSecond);
+    ASSERT_THROWS(first.parallelStreams("monteCarlo", -1));
+    
+    //игра: разные seed - разные карты артефактов, одинаковый - одна и та же
+    auto firstArtifact = [](uint64_t seed) {
+        GameSimulation::Settings settings;
+        settings.seed = seed;
+        GameSimulation game(settings);
+        for (int i = 0; i < 20; i++) {
+            game.getGraph().AddVertex("P" + std::to_string(i));
+        }
+        game.placeTraderIfNeeded();
+        game.checkGameStart();
+        for (const GameEvent& event : game.takeEvents()) {
+            if (event.type == GameEvent::ArtifactSpawned) {
+                return event.planet;
+            }
+        }
+        return -1;
+    };
+    ASSERT_EQUAL(firstArtifact(11), firstArtifact(11));
+    bool varies = false;
+    for (uint64_t seed = 12; seed < 20 && !varies; seed++) {
+        varies = firstArtifact(seed) != firstArtifact(11);
+    }
+    ASSERT_TRUE(varies);
+}
+
 //===========================================
 // комплексные тесты
 //===========================================